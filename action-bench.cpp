@@ -0,0 +1,183 @@
+/**
+ * ===============================================================================================
+ * @file    action-bench.cpp
+ * @author  Pascal-Emmanuel Lachance
+ * @p       <a href="https://www.github.com/Raesangur">Raesangur</a>
+ * @p       <a href="https://www.raesangur.com/">https://www.raesangur.com/</a>
+ *
+ * @brief   Compares coroutine actions with threads for waiting work.
+ *
+ * ------------------------------------------------------------------------------------------------
+ * @copyright Copyright (c) 2023 Pascal-Emmanuel Lachance | Raesangur
+ *
+ * @par License: <a href="https://opensource.org/license/mit/"> MIT </a>
+ *               This project is released under the MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ * BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NON INFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ * ------------------------------------------------------------------------------------------------
+ * @details
+ * Usage: action_bench [actions] [rounds]
+ *
+ * Measures three things:
+ *  - the cost of switching between actions, with every action yielding `rounds` times in turn;
+ *  - the cost of switching between two threads handing a token back and forth, for comparison;
+ *  - `actions` actions sleeping at once, in wall time and in bytes of coroutine frames.
+ * ===============================================================================================
+ */
+/** ===============================================================================================
+ *  INCLUDES
+ */
+#include "action.h"
+#include "memory-accounting.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <semaphore>
+#include <thread>
+
+
+/** ===============================================================================================
+ *  CONSTANTS
+ */
+
+constexpr int DEFAULT_ACTIONS = 10'000;
+constexpr int DEFAULT_ROUNDS  = 100;
+
+constexpr auto SLEEP_DURATION = std::chrono::milliseconds{10};
+
+
+/** ===============================================================================================
+ *  LOCAL FUNCTIONS
+ */
+
+static double elapsed_ns(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start)
+      .count();
+}
+
+static void wait_for_actions()
+{
+    while (event_loop::get()->active() > 0)
+    {
+        std::this_thread::sleep_for(std::chrono::microseconds{100});
+    }
+}
+
+static action yielder(int rounds)
+{
+    for (int i = 0; i < rounds; i++)
+    {
+        co_await yield_now{};
+    }
+}
+
+static action sleeper()
+{
+    co_await sleep_for{SLEEP_DURATION};
+}
+
+
+static void bench_action_switch(int actions, int rounds)
+{
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < actions; i++)
+    {
+        event_loop::get()->spawn(yielder(rounds));
+    }
+    wait_for_actions();
+
+    double switches = static_cast<double>(actions) * rounds;
+    std::printf("action switch:  %8.1f ns (%d actions x %d yields)\n",
+                elapsed_ns(start) / switches,
+                actions,
+                rounds);
+}
+
+static void bench_thread_switch(int rounds)
+{
+    std::binary_semaphore ping{0};
+    std::binary_semaphore pong{0};
+
+    auto        start = std::chrono::steady_clock::now();
+    std::thread other{[&]
+                      {
+                          for (int i = 0; i < rounds; i++)
+                          {
+                              ping.acquire();
+                              pong.release();
+                          }
+                      }};
+    for (int i = 0; i < rounds; i++)
+    {
+        ping.release();
+        pong.acquire();
+    }
+    other.join();
+
+    // Every round trip switches twice.
+    std::printf("thread switch:  %8.1f ns (%d round trips)\n",
+                elapsed_ns(start) / (2.0 * rounds),
+                rounds);
+}
+
+static void bench_sleepers(int actions)
+{
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < actions; i++)
+    {
+        event_loop::get()->spawn(sleeper());
+    }
+    // The sleepers are all suspended at this point, so their frames are all still allocated.
+    std::int64_t frameBytes = memory_accounting::usage(memory_category::action_frames).bytes;
+    wait_for_actions();
+
+    std::printf("%d sleepers:  %8.1f ms for a %lld ms sleep, %lld frame bytes (%lld each)\n",
+                actions,
+                elapsed_ns(start) / 1e6,
+                static_cast<long long>(SLEEP_DURATION.count()),
+                static_cast<long long>(frameBytes),
+                static_cast<long long>(frameBytes / actions));
+}
+
+
+/** ===============================================================================================
+ *  FUNCTION DEFINITIONS
+ */
+
+int main(int argc, char* argv[])
+{
+    int actions = argc > 1 ? std::atoi(argv[1]) : DEFAULT_ACTIONS;
+    int rounds  = argc > 2 ? std::atoi(argv[2]) : DEFAULT_ROUNDS;
+    if (actions <= 0 || rounds <= 0)
+    {
+        std::fprintf(stderr, "usage: %s [actions] [rounds]\n", argv[0]);
+        return 1;
+    }
+
+    bench_action_switch(actions, rounds);
+    bench_thread_switch(actions * rounds);
+    bench_sleepers(actions);
+
+    event_loop::get()->stop();
+    return 0;
+}
+
+
+/**
+ * ------------------------------------------------------------------------------------------------
+ */
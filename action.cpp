@@ -0,0 +1,434 @@
+/**
+ * ===============================================================================================
+ * @file    action.cpp
+ * @author  Pascal-Emmanuel Lachance
+ * @p       <a href="https://www.github.com/Raesangur">Raesangur</a>
+ * @p       <a href="https://www.raesangur.com/">https://www.raesangur.com/</a>
+ *
+ * @brief   Coroutine actions run by a single-threaded event loop.
+ *
+ * ------------------------------------------------------------------------------------------------
+ * @copyright Copyright (c) 2023 Pascal-Emmanuel Lachance | Raesangur
+ *
+ * @par License: <a href="https://opensource.org/license/mit/"> MIT </a>
+ *               This project is released under the MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ * BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NON INFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ * ===============================================================================================
+ */
+
+/** ===============================================================================================
+ *  INCLUDES
+ */
+#include "action.h"
+
+#include "memory-accounting.h"
+#include "trace.h"
+
+#include <algorithm>
+#include <array>
+#include <climits>
+#include <exception>
+#include <sys/eventfd.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+
+/** ===============================================================================================
+ *  SINGLETON INSTANCE
+ */
+event_loop* event_loop::m_instance = nullptr;
+
+
+/** ===============================================================================================
+ *  CONSTANTS
+ */
+
+constexpr unsigned MIN_WORKERS = 2;
+
+// While actions keep yielding, descriptors are only polled once every so many rounds.
+constexpr int BUSY_ROUNDS_PER_POLL = 64;
+
+
+/** ===============================================================================================
+ *  ACTION MEMBER FUNCTIONS DEFINITIONS
+ */
+
+std::coroutine_handle<> action::final_awaiter::await_suspend(
+  std::coroutine_handle<promise_type> handle) noexcept
+{
+    promise_type& promise = handle.promise();
+    if (promise.continuation)
+    {
+        return promise.continuation;
+    }
+
+    if (promise.detached)
+    {
+        // Suspended at its final point, so the frame can go away from here.
+        bool counted = !promise.service;
+        handle.destroy();
+        if (counted)
+        {
+            event_loop::get()->action_done();
+        }
+    }
+    return std::noop_coroutine();
+}
+
+void action::promise_type::unhandled_exception()
+{
+    std::terminate();
+}
+
+void* action::promise_type::operator new(std::size_t size)
+{
+    void* p = ::operator new(size);
+    memory_accounting::allocate(memory_category::action_frames, size);
+    return p;
+}
+
+void action::promise_type::operator delete(void* p, std::size_t size)
+{
+    memory_accounting::release(memory_category::action_frames, size);
+    ::operator delete(p, size);
+}
+
+
+action& action::operator=(action&& other) noexcept
+{
+    if (this != &other)
+    {
+        if (m_handle)
+        {
+            m_handle.destroy();
+        }
+        m_handle = std::exchange(other.m_handle, {});
+    }
+    return *this;
+}
+
+action::~action()
+{
+    if (m_handle)
+    {
+        m_handle.destroy();
+    }
+}
+
+
+/** ===============================================================================================
+ *  EVENT_LOOP MEMBER FUNCTIONS DEFINITIONS
+ */
+
+event_loop::event_loop()
+{
+    m_epollFd = ::epoll_create1(EPOLL_CLOEXEC);
+    m_wakeFd  = ::eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+
+    // The wake-up descriptor is the only one registered without a waiter.
+    epoll_event event{};
+    event.events   = EPOLLIN;
+    event.data.ptr = nullptr;
+    ::epoll_ctl(m_epollFd, EPOLL_CTL_ADD, m_wakeFd, &event);
+}
+
+event_loop::~event_loop()
+{
+    stop();
+    ::close(m_wakeFd);
+    ::close(m_epollFd);
+}
+
+[[nodiscard]] event_loop* event_loop::get()
+{
+    if (m_instance == nullptr)
+    {
+        m_instance = new event_loop;
+    }
+    return m_instance;
+}
+
+
+void event_loop::spawn(action a)
+{
+    std::coroutine_handle<action::promise_type> handle = std::exchange(a.m_handle, {});
+    if (!handle)
+    {
+        return;
+    }
+
+    handle.promise().detached = true;
+    if (!handle.promise().service)
+    {
+        m_active.fetch_add(1, std::memory_order_acq_rel);
+    }
+    {
+        std::lock_guard lock{m_postedMutex};
+        if (!m_thread.joinable() && !m_stopping.load(std::memory_order_acquire))
+        {
+            m_thread = std::thread{&event_loop::run, this};
+        }
+        m_posted.push_back(handle);
+        m_hasPosted.store(true, std::memory_order_release);
+    }
+    wake();
+}
+
+void event_loop::spawn_service(action a)
+{
+    if (a.m_handle)
+    {
+        a.m_handle.promise().service = true;
+    }
+    spawn(std::move(a));
+}
+
+void event_loop::post(std::coroutine_handle<> handle)
+{
+    {
+        std::lock_guard lock{m_postedMutex};
+        m_posted.push_back(handle);
+        m_hasPosted.store(true, std::memory_order_release);
+    }
+    wake();
+}
+
+void event_loop::submit(std::function<void()> job)
+{
+    {
+        std::lock_guard lock{m_jobsMutex};
+        if (m_workers.empty())
+        {
+            unsigned count = std::max(std::thread::hardware_concurrency(), MIN_WORKERS);
+            for (unsigned i = 0; i < count; i++)
+            {
+                m_workers.emplace_back(&event_loop::work, this);
+            }
+        }
+        m_jobs.push_back(std::move(job));
+    }
+    m_jobsReady.notify_one();
+}
+
+void event_loop::stop()
+{
+    if (m_stopping.exchange(true, std::memory_order_acq_rel))
+    {
+        return;
+    }
+
+    wake();
+    {
+        // A spawn() that missed the flag has started the thread by the time this is acquired.
+        std::lock_guard lock{m_postedMutex};
+    }
+    if (m_thread.joinable())
+    {
+        m_thread.join();
+    }
+
+    {
+        // Taken so that no worker can miss the notification between its check and its wait.
+        std::lock_guard lock{m_jobsMutex};
+    }
+    m_jobsReady.notify_all();
+    for (std::thread& worker : m_workers)
+    {
+        worker.join();
+    }
+}
+
+
+void event_loop::schedule(std::coroutine_handle<> handle)
+{
+    m_ready.push_back(handle);
+}
+
+void event_loop::add_timer(clock::time_point deadline, std::coroutine_handle<> handle)
+{
+    m_timers.push(timer{deadline, m_timerSequence++, handle});
+}
+
+void event_loop::watch(std::uint32_t events, fd_waiter* waiter)
+{
+    epoll_event event{};
+    event.events   = events | EPOLLONESHOT;
+    event.data.ptr = waiter;
+    if (::epoll_ctl(m_epollFd, EPOLL_CTL_ADD, waiter->fd, &event) != 0)
+    {
+        // Regular files and closed descriptors cannot be polled: report an error, never hang.
+        waiter->events = EPOLLERR;
+        schedule(waiter->handle);
+    }
+}
+
+
+void event_loop::action_done()
+{
+    m_active.fetch_sub(1, std::memory_order_acq_rel);
+}
+
+void event_loop::run()
+{
+    trace::set_thread_name("event loop");
+    std::array<epoll_event, MAX_EVENTS> events{};
+
+    int busyRounds = 0;
+    while (!m_stopping.load(std::memory_order_acquire))
+    {
+        take_posted();
+
+        // Only what is ready now: an action yielding in a loop must not starve the others.
+        for (std::size_t count = m_ready.size(); count > 0; count--)
+        {
+            std::coroutine_handle<> handle = m_ready.front();
+            m_ready.pop_front();
+            handle.resume();
+        }
+
+        for (clock::time_point now = clock::now();
+             !m_timers.empty() && m_timers.top().deadline <= now;
+             m_timers.pop())
+        {
+            schedule(m_timers.top().handle);
+        }
+
+        if (!m_ready.empty() && ++busyRounds < BUSY_ROUNDS_PER_POLL)
+        {
+            continue;
+        }
+        busyRounds = 0;
+
+        int count = ::epoll_wait(m_epollFd, events.data(), MAX_EVENTS, next_timeout());
+        for (int i = 0; i < count; i++)
+        {
+            auto* waiter = static_cast<fd_waiter*>(events[static_cast<std::size_t>(i)].data.ptr);
+            if (waiter == nullptr)
+            {
+                std::uint64_t value = 0;
+                [[maybe_unused]] ssize_t bytes = ::read(m_wakeFd, &value, sizeof(value));
+                continue;
+            }
+
+            ::epoll_ctl(m_epollFd, EPOLL_CTL_DEL, waiter->fd, nullptr);
+            waiter->events = events[static_cast<std::size_t>(i)].events;
+            schedule(waiter->handle);
+        }
+    }
+}
+
+void event_loop::work()
+{
+    trace::set_thread_name("thread pool");
+    while (true)
+    {
+        std::function<void()> job{};
+        {
+            std::unique_lock lock{m_jobsMutex};
+            m_jobsReady.wait(lock,
+                             [this]
+                             {
+                                 return !m_jobs.empty() ||
+                                        m_stopping.load(std::memory_order_acquire);
+                             });
+            if (m_jobs.empty())
+            {
+                return;
+            }
+            job = std::move(m_jobs.front());
+            m_jobs.pop_front();
+        }
+        job();
+    }
+}
+
+void event_loop::wake()
+{
+    std::uint64_t one = 1;
+    [[maybe_unused]] ssize_t written = ::write(m_wakeFd, &one, sizeof(one));
+}
+
+void event_loop::take_posted()
+{
+    if (!m_hasPosted.load(std::memory_order_acquire))
+    {
+        return;
+    }
+
+    std::lock_guard lock{m_postedMutex};
+    m_ready.insert(m_ready.end(), m_posted.begin(), m_posted.end());
+    m_posted.clear();
+    m_hasPosted.store(false, std::memory_order_relaxed);
+}
+
+[[nodiscard]] int event_loop::next_timeout() const
+{
+    if (!m_ready.empty() || m_hasPosted.load(std::memory_order_acquire))
+    {
+        return 0;
+    }
+    if (m_timers.empty())
+    {
+        return -1;
+    }
+
+    // Rounded up: waking up early would only go around the loop once more.
+    auto wait =
+      std::chrono::ceil<std::chrono::milliseconds>(m_timers.top().deadline - clock::now());
+    return static_cast<int>(std::clamp<std::chrono::milliseconds::rep>(wait.count(), 0, INT_MAX));
+}
+
+
+/** ===============================================================================================
+ *  AWAITABLES MEMBER FUNCTIONS DEFINITIONS
+ */
+
+void child_exit::await_suspend(std::coroutine_handle<> handle)
+{
+    m_waiter.handle = handle;
+    m_waiter.fd     = open_pidfd(m_pid);
+    if (m_waiter.fd >= 0)
+    {
+        event_loop::get()->watch(EPOLLIN, &m_waiter);
+        return;
+    }
+
+    // Without process descriptors the wait blocks a pool thread instead of the loop.
+    event_loop::get()->submit(
+      [this]
+      {
+          m_reaped = ::waitpid(m_pid, &m_status, 0) == m_pid;
+          event_loop::get()->post(m_waiter.handle);
+      });
+}
+
+[[nodiscard]] int child_exit::await_resume()
+{
+    if (m_waiter.fd >= 0)
+    {
+        // A process descriptor only becomes readable once the child has exited.
+        m_reaped = ::waitpid(m_pid, &m_status, 0) == m_pid;
+        ::close(m_waiter.fd);
+        m_waiter.fd = -1;
+    }
+    return m_reaped ? exit_code_of(m_status) : -1;
+}
+
+
+/**
+ * ------------------------------------------------------------------------------------------------
+ */
@@ -0,0 +1,412 @@
+/**
+ * ===============================================================================================
+ * @file    action.h
+ * @author  Pascal-Emmanuel Lachance
+ * @p       <a href="https://www.github.com/Raesangur">Raesangur</a>
+ * @p       <a href="https://www.raesangur.com/">https://www.raesangur.com/</a>
+ *
+ * @brief   Coroutine actions run by a single-threaded event loop.
+ *
+ * ------------------------------------------------------------------------------------------------
+ * @copyright Copyright (c) 2023 Pascal-Emmanuel Lachance | Raesangur
+ *
+ * @par License: <a href="https://opensource.org/license/mit/"> MIT </a>
+ *               This project is released under the MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ * BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NON INFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ * ------------------------------------------------------------------------------------------------
+ * @details
+ * An action is a C++20 coroutine that runs on the event loop thread and suspends instead of
+ * blocking. It can wait for:
+ *  - a timer,                         `co_await sleep_for{100ms};`
+ *  - a file descriptor,               `co_await readable(fd);`
+ *  - the exit of a child process,     `int code = co_await child_exit{pid};`
+ *  - a task_runner task,              `int code = co_await task_finished{*t};`
+ *  - work done on the thread pool,    `auto result = co_await offload{[] { return compute(); }};`
+ *  - another action,                  `co_await other_action(...);`
+ *  - the other ready actions,         `co_await yield_now{};`
+ *
+ * Actions start suspended; event_loop::spawn() hands one to the loop, which owns it from then on
+ * and frees its frame when it returns. The loop thread waits on a single epoll set for descriptors
+ * and its wake-up eventfd, with a timeout taken from a heap of timers. Resuming an action is a
+ * plain function call, and a suspended action costs only its frame, charged to the action_frames
+ * memory category, so thousands of them are cheap where thousands of threads would not be.
+ *
+ * Actions must not block, and only touch interface state through what is already thread safe, such
+ * as task_runner. Exceptions are not used: an action that throws terminates the program.
+ * ===============================================================================================
+ */
+#ifndef ACTION_H
+#define ACTION_H
+
+
+/** ===============================================================================================
+ *  INCLUDES
+ */
+#include "task-runner.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <queue>
+#include <sys/epoll.h>
+#include <sys/types.h>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+
+/** ===============================================================================================
+ *  CLASS DEFINITION
+ */
+
+class action
+{
+public:
+    struct promise_type;
+
+    struct final_awaiter
+    {
+        [[nodiscard]] bool await_ready() const noexcept
+        {
+            return false;
+        }
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<promise_type> handle) noexcept;
+        void                    await_resume() const noexcept {}
+    };
+
+    struct promise_type
+    {
+        std::coroutine_handle<> continuation{};    //!< The action awaiting this one, if any.
+        bool                    detached = false;  //!< Owned by the event loop.
+        bool                    service  = false;  //!< Not counted by event_loop::active().
+
+        action get_return_object()
+        {
+            return action{std::coroutine_handle<promise_type>::from_promise(*this)};
+        }
+        std::suspend_always initial_suspend() noexcept
+        {
+            return {};
+        }
+        final_awaiter final_suspend() noexcept
+        {
+            return {};
+        }
+        void return_void() {}
+        void unhandled_exception();
+
+        // Frames are charged to memory_category::action_frames.
+        static void* operator new(std::size_t size);
+        static void  operator delete(void* p, std::size_t size);
+    };
+
+    action() = default;
+    explicit action(std::coroutine_handle<promise_type> handle) : m_handle{handle} {}
+    action(action&& other) noexcept : m_handle{std::exchange(other.m_handle, {})} {}
+    action& operator=(action&& other) noexcept;
+    ~action();
+
+    // Awaiting an action runs it to completion before the awaiting one continues.
+    [[nodiscard]] bool await_ready() const noexcept
+    {
+        return !m_handle || m_handle.done();
+    }
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept
+    {
+        m_handle.promise().continuation = awaiting;
+        return m_handle;
+    }
+    void await_resume() const noexcept {}
+
+protected:
+    friend class event_loop;
+
+    std::coroutine_handle<promise_type> m_handle{};
+};
+
+
+// Where an action waiting for a file descriptor is parked while it is in the epoll set.
+struct fd_waiter
+{
+    std::coroutine_handle<> handle{};
+    int                     fd     = -1;
+    std::uint32_t           events = 0;    //!< What epoll reported, once resumed.
+};
+
+
+class event_loop
+{
+protected:
+    event_loop();
+
+public:
+    using clock = std::chrono::steady_clock;
+
+    event_loop(const event_loop&)     = delete;
+    void operator=(const event_loop&) = delete;
+    ~event_loop();
+
+    [[nodiscard]] static event_loop* get();
+
+    // Hands an action over to the loop thread, which starts it. Safe from any thread.
+    void spawn(action a);
+    // Same, for an action that lasts as long as the program, such as a watcher: it is left out of
+    // active(), so that it does not keep the interface animating.
+    void spawn_service(action a);
+    // Resumes a suspended action on the loop thread. Safe from any thread.
+    void post(std::coroutine_handle<> handle);
+    // Runs `job` on the thread pool. Safe from any thread.
+    void submit(std::function<void()> job);
+
+    // Spawned actions that have not returned yet.
+    [[nodiscard]] std::size_t active() const
+    {
+        return m_active.load(std::memory_order_acquire);
+    }
+
+    // Stops the loop and the pool; actions still suspended are abandoned.
+    void stop();
+
+    // For awaitables, from the loop thread only.
+    void schedule(std::coroutine_handle<> handle);
+    void add_timer(clock::time_point deadline, std::coroutine_handle<> handle);
+    void watch(std::uint32_t events, fd_waiter* waiter);
+
+protected:
+    friend struct action::final_awaiter;
+
+    void action_done();
+
+    void run();
+    void work();
+    void wake();
+    void take_posted();
+    [[nodiscard]] int next_timeout() const;
+
+protected:
+    static event_loop* m_instance;
+
+    static constexpr int MAX_EVENTS = 64;
+
+    struct timer
+    {
+        clock::time_point       deadline{};
+        std::uint64_t           sequence = 0;    //!< Keeps timers with equal deadlines in order.
+        std::coroutine_handle<> handle{};
+
+        bool operator>(const timer& other) const
+        {
+            return deadline != other.deadline ? deadline > other.deadline
+                                              : sequence > other.sequence;
+        }
+    };
+
+    int m_epollFd = -1;
+    int m_wakeFd  = -1;
+
+    // Loop thread only.
+    std::deque<std::coroutine_handle<>>                                 m_ready{};
+    std::priority_queue<timer, std::vector<timer>, std::greater<timer>> m_timers{};
+    std::uint64_t                                                       m_timerSequence = 0;
+
+    std::mutex                           m_postedMutex{};
+    std::vector<std::coroutine_handle<>> m_posted{};
+    std::atomic<bool>                    m_hasPosted{false};
+    std::atomic<std::size_t>             m_active{0};
+
+    std::mutex                        m_jobsMutex{};
+    std::condition_variable           m_jobsReady{};
+    std::deque<std::function<void()>> m_jobs{};
+    std::vector<std::thread>          m_workers{};
+
+    std::atomic<bool> m_stopping{false};
+    std::thread       m_thread{};
+};
+
+
+/** ===============================================================================================
+ *  AWAITABLES
+ */
+
+// Suspends the action for at least `duration`.
+struct sleep_for
+{
+    event_loop::clock::duration duration{};
+
+    [[nodiscard]] bool await_ready() const noexcept
+    {
+        return duration <= event_loop::clock::duration::zero();
+    }
+    void await_suspend(std::coroutine_handle<> handle) const
+    {
+        event_loop::get()->add_timer(event_loop::clock::now() + duration, handle);
+    }
+    void await_resume() const noexcept {}
+};
+
+// Lets every other ready action run before continuing.
+struct yield_now
+{
+    [[nodiscard]] bool await_ready() const noexcept
+    {
+        return false;
+    }
+    void await_suspend(std::coroutine_handle<> handle) const
+    {
+        event_loop::get()->schedule(handle);
+    }
+    void await_resume() const noexcept {}
+};
+
+// Waits until a descriptor is ready; returns the epoll events, errors and hang-ups included.
+// A descriptor can only be awaited by one action at a time.
+class fd_ready
+{
+public:
+    fd_ready(int fd, std::uint32_t events) : m_waiter{{}, fd, 0}, m_events{events} {}
+
+    [[nodiscard]] bool await_ready() const noexcept
+    {
+        return false;
+    }
+    void await_suspend(std::coroutine_handle<> handle)
+    {
+        m_waiter.handle = handle;
+        event_loop::get()->watch(m_events, &m_waiter);
+    }
+    [[nodiscard]] std::uint32_t await_resume() const noexcept
+    {
+        return m_waiter.events;
+    }
+
+protected:
+    fd_waiter     m_waiter;
+    std::uint32_t m_events;
+};
+
+[[nodiscard]] inline fd_ready readable(int fd)
+{
+    return fd_ready{fd, EPOLLIN};
+}
+
+[[nodiscard]] inline fd_ready writable(int fd)
+{
+    return fd_ready{fd, EPOLLOUT};
+}
+
+// Waits for a child of this process to exit and reaps it; returns its exit code as exit_code_of.
+class child_exit
+{
+public:
+    explicit child_exit(pid_t pid) : m_pid{pid} {}
+
+    [[nodiscard]] bool await_ready() const noexcept
+    {
+        return false;
+    }
+    void              await_suspend(std::coroutine_handle<> handle);
+    [[nodiscard]] int await_resume();
+
+protected:
+    pid_t     m_pid;
+    fd_waiter m_waiter{};
+    int       m_status = 0;
+    bool      m_reaped = false;
+};
+
+// Waits for a task started with task_runner; returns its exit code.
+class task_finished
+{
+public:
+    explicit task_finished(task& t) : m_task{t} {}
+
+    [[nodiscard]] bool await_ready() const noexcept
+    {
+        return m_task.state() != task_state::running;
+    }
+    void await_suspend(std::coroutine_handle<> handle)
+    {
+        m_task.on_finish([handle] { event_loop::get()->post(handle); });
+    }
+    [[nodiscard]] int await_resume() const noexcept
+    {
+        return m_task.exit_code();
+    }
+
+protected:
+    task& m_task;
+};
+
+// Runs a blocking job on the thread pool; the action resumes on the loop thread with its result.
+template<typename F>
+class offload
+{
+public:
+    using result_type = std::invoke_result_t<F&>;
+
+    explicit offload(F job) : m_job{std::move(job)} {}
+
+    [[nodiscard]] bool await_ready() const noexcept
+    {
+        return false;
+    }
+    void await_suspend(std::coroutine_handle<> handle)
+    {
+        event_loop::get()->submit(
+          [this, handle]
+          {
+              if constexpr (std::is_void_v<result_type>)
+              {
+                  m_job();
+              }
+              else
+              {
+                  m_result.emplace(m_job());
+              }
+              event_loop::get()->post(handle);
+          });
+    }
+    result_type await_resume()
+    {
+        if constexpr (!std::is_void_v<result_type>)
+        {
+            return std::move(*m_result);
+        }
+    }
+
+protected:
+    struct nothing
+    {
+    };
+
+    F m_job;
+    std::optional<std::conditional_t<std::is_void_v<result_type>, nothing, result_type>> m_result{};
+};
+
+
+#endif  // ACTION_H
+/**
+ * ------------------------------------------------------------------------------------------------
+ */
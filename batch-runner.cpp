@@ -0,0 +1,375 @@
+/**
+ * ===============================================================================================
+ * @file    batch-runner.cpp
+ * @author  Pascal-Emmanuel Lachance
+ * @p       <a href="https://www.github.com/Raesangur">Raesangur</a>
+ * @p       <a href="https://www.raesangur.com/">https://www.raesangur.com/</a>
+ *
+ * @brief   Runs a selection of the menu tree without a terminal.
+ *
+ * ------------------------------------------------------------------------------------------------
+ * @copyright Copyright (c) 2023 Pascal-Emmanuel Lachance | Raesangur
+ *
+ * @par License: <a href="https://opensource.org/license/mit/"> MIT </a>
+ *               This project is released under the MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ * BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NON INFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ * ===============================================================================================
+ */
+/** ===============================================================================================
+ *  INCLUDES
+ */
+#include "batch-runner.h"
+
+#include "file-text.h"
+#include "install-plan.h"
+#include "json-string.h"
+#include "task-runner.h"
+
+#include <cstdio>
+#include <utility>
+
+
+/** ===============================================================================================
+ *  LOCAL FUNCTIONS
+ */
+
+static std::string json_ms(double ms)
+{
+    char text[32];
+    std::snprintf(text, sizeof(text), "%.2f", ms);
+    return text;
+}
+
+
+/** ===============================================================================================
+ *  MEMBER FUNCTIONS DEFINITIONS
+ */
+
+batch_runner::batch_runner(menu_manager* mm, clock::time_point started, std::FILE* out) :
+    m_mm{mm}, m_started{started}, m_out{out}
+{
+}
+
+
+bool batch_runner::apply(std::string_view spec)
+{
+    spec = trim(spec);
+    if (spec.empty() || spec.front() == '#')
+    {
+        return true;
+    }
+
+    bool select = spec.front() != '-';
+    if (spec.front() == '+' || spec.front() == '-')
+    {
+        spec = trim(spec.substr(1));
+    }
+
+    menu_entry* entry = resolve(spec);
+    if (entry == nullptr || !entry->can_select())
+    {
+        error(std::string{entry == nullptr ? "no entry at '" : "cannot select '"} +
+              std::string{spec} + "'");
+        return false;
+    }
+
+    if (select)
+    {
+        entry->select();
+    }
+    else
+    {
+        entry->deselect();
+    }
+    return true;
+}
+
+bool batch_runner::apply_profile(const std::string& filename)
+{
+    std::string text{};
+    bool        ok = read_whole_file(filename, text);
+    if (!ok)
+    {
+        error("cannot read profile '" + filename + "'");
+        return false;
+    }
+
+    std::string_view rest = text;
+    while (!rest.empty())
+    {
+        std::size_t end = rest.find('\n');
+        ok &= apply(rest.substr(0, end));
+        rest.remove_prefix(end == std::string_view::npos ? rest.size() : end + 1);
+    }
+    return ok;
+}
+
+
+int batch_runner::run()
+{
+    if (m_errors > 0)
+    {
+        return 1;
+    }
+
+    // The run only sees the selection as it is now.
+    selection_set selection = menu_option_entry::selection();
+    emit("{\"event\":\"ready\",\"entries\":" + std::to_string(menu_entry::id_count()) +
+         ",\"selected\":" + std::to_string(selection.count()) +
+         ",\"startup_ms\":" + json_ms(ms_since(m_started)) + "}");
+
+    // Lazy menus on the way are built here, on the main thread; the install batches are planned by
+    // the run itself, from the snapshot it is handed.
+    if (m_mm->top() != nullptr)
+    {
+        collect(m_mm->top(), selection);
+    }
+
+    clock::time_point begin = clock::now();
+    event_loop::get()->spawn(execute(std::move(selection)));
+    while (true)
+    {
+        {
+            std::unique_lock lock{m_mutex};
+            if (m_finishedCv.wait_for(lock,
+                                      std::chrono::milliseconds{BATCH_POLL_MS},
+                                      [this] { return m_finished; }))
+            {
+                break;
+            }
+        }
+        drain_output();
+    }
+    drain_output();
+
+    emit(std::string{"{\"event\":\"done\",\"ok\":"} + (m_failed == 0 ? "true" : "false") +
+         ",\"ran\":" + std::to_string(m_ran) + ",\"failed\":" + std::to_string(m_failed) +
+         ",\"skipped\":" + std::to_string(m_steps.size() - m_ran) +
+         ",\"ms\":" + json_ms(ms_since(begin)) + "}");
+    return m_failed == 0 ? 0 : 1;
+}
+
+
+[[nodiscard]] menu_entry* batch_runner::resolve(std::string_view path) const
+{
+    menu_entry* root  = m_mm->top();
+    menu_entry* entry = root;
+
+    std::string_view rest = path;
+    bool             first = true;
+    while (entry != nullptr && !rest.empty())
+    {
+        std::size_t      slash = rest.find('/');
+        std::string_view name  = trim(rest.substr(0, slash));
+        rest.remove_prefix(slash == std::string_view::npos ? rest.size() : slash + 1);
+
+        if (std::exchange(first, false) && name == root->get_name())
+        {
+            continue;
+        }
+
+        auto* menu = dynamic_cast<menu_top_entry*>(entry);
+        entry      = nullptr;
+        if (menu == nullptr)
+        {
+            break;
+        }
+
+        // Lazy lists are only read when a path goes through them.
+        menu->materialize();
+        for (menu_entry* child : *menu)
+        {
+            if (child->get_name() == name)
+            {
+                entry = child;
+                break;
+            }
+        }
+    }
+
+    // A lone name, as listed in a selection snapshot, may be anywhere in the tree.
+    if (entry == nullptr && path.find('/') == std::string_view::npos)
+    {
+        entry = m_mm->find(path);
+    }
+    return entry == root ? nullptr : entry;
+}
+
+void batch_runner::collect(const menu_entry* entry, const selection_set& selection)
+{
+    auto* option = dynamic_cast<const menu_option_entry*>(entry);
+    if (option != nullptr && selection.test(option->id()))
+    {
+        if (option->get_action() != nullptr)
+        {
+            m_steps.push_back(step{option->get_name(), "action", {}, option});
+        }
+        else if (!option->command().empty())
+        {
+            m_steps.push_back(step{option->get_name(), "command", option->command(), nullptr});
+        }
+    }
+
+    // Unread lazy lists have nothing selected in them.
+    auto* menu = dynamic_cast<const menu_top_entry*>(entry);
+    if (menu != nullptr && menu->is_materialized())
+    {
+        for (const menu_entry* child : *menu)
+        {
+            collect(child, selection);
+        }
+    }
+}
+
+
+action batch_runner::execute(selection_set selection)
+{
+    install_plan plan =
+      co_await offload{[&selection] { return install_planner::get()->plan(selection); }};
+    for (install_batch& batch : plan.batches)
+    {
+        m_steps.push_back(step{"Install packages (" + batch.installer + ")",
+                               "install",
+                               std::move(batch.command),
+                               nullptr});
+    }
+    emit("{\"event\":\"plan\",\"nodes\":" + std::to_string(m_steps.size()) +
+         ",\"packages\":" + std::to_string(plan.packages) +
+         ",\"batches\":" + std::to_string(plan.batches.size()) +
+         ",\"duplicates\":" + std::to_string(plan.duplicates) + "}");
+
+    for (std::size_t i = 0; i < m_steps.size(); i++)
+    {
+        const step& current = m_steps[i];
+        {
+            std::lock_guard lock{m_mutex};
+            m_node = i + 1;
+        }
+        emit("{\"event\":\"start\",\"node\":" + std::to_string(i + 1) +
+             ",\"name\":" + json_string(current.name) + ",\"kind\":" + json_string(current.kind) +
+             ",\"at_ms\":" + json_ms(ms_since(m_started)) + "}");
+
+        std::size_t       firstTask = task_runner::get()->size();
+        clock::time_point begin     = clock::now();
+        if (current.option != nullptr)
+        {
+            co_await current.option->get_action()(*current.option);
+        }
+        else
+        {
+            co_await task_finished{*task_runner::get()->start(current.name, current.command)};
+        }
+        double ms = ms_since(begin);
+
+        // An action may run several tasks; the step fails with the first of them that did.
+        int code = 0;
+        for (std::size_t id = firstTask; id < task_runner::get()->size() && code == 0; id++)
+        {
+            task* t = task_runner::get()->get(id);
+            code    = t->state() == task_state::running ? 0 : t->exit_code();
+        }
+
+        drain_output();
+        emit("{\"event\":\"end\",\"node\":" + std::to_string(i + 1) +
+             ",\"name\":" + json_string(current.name) + ",\"code\":" + std::to_string(code) +
+             ",\"ms\":" + json_ms(ms) + "}");
+
+        m_ran++;
+        if (code != 0)
+        {
+            m_failed++;
+            break;
+        }
+    }
+
+    {
+        std::lock_guard lock{m_mutex};
+        m_finished = true;
+    }
+    m_finishedCv.notify_one();
+}
+
+void batch_runner::drain_output()
+{
+    std::lock_guard lock{m_mutex};
+
+    std::size_t count = task_runner::get()->size();
+    m_written.resize(count, 0);
+    m_taskNode.resize(count, m_node);
+
+    std::string events{};
+    for (std::size_t id = 0; id < count; id++)
+    {
+        task* t       = task_runner::get()->get(id);
+        bool  running = t->state() == task_state::running;
+
+        std::string prefix = "{\"event\":\"output\",\"node\":" + std::to_string(m_taskNode[id]) +
+                             ",\"task\":" + json_string(t->name());
+        t->with_output(
+            [&](const output_ring& ring)
+            {
+                std::uint64_t end = ring.line_end();
+                if (running && end > 0)
+                {
+                    end--;
+                }
+                if (m_written[id] < ring.line_begin())
+                {
+                    events += prefix + ",\"dropped\":" +
+                              std::to_string(ring.line_begin() - m_written[id]) + "}\n";
+                    m_written[id] = ring.line_begin();
+                }
+                for (; m_written[id] < end; m_written[id]++)
+                {
+                    events += prefix + ",\"line\":" +
+                              json_string(ring.line(m_written[id], BATCH_LINE_BYTES)) + "}\n";
+                }
+            });
+    }
+
+    if (!events.empty())
+    {
+        std::fputs(events.c_str(), m_out);
+        std::fflush(m_out);
+    }
+}
+
+
+void batch_runner::emit(const std::string& line)
+{
+    std::lock_guard lock{m_mutex};
+    std::fputs(line.c_str(), m_out);
+    std::fputc('\n', m_out);
+    std::fflush(m_out);
+}
+
+void batch_runner::error(const std::string& message)
+{
+    m_errors++;
+    emit("{\"event\":\"error\",\"message\":" + json_string(message) + "}");
+}
+
+
+[[nodiscard]] double batch_runner::ms_since(clock::time_point since) const
+{
+    return std::chrono::duration<double, std::milli>(clock::now() - since).count();
+}
+
+
+/**
+ * ------------------------------------------------------------------------------------------------
+ */
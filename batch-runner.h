@@ -0,0 +1,152 @@
+/**
+ * ===============================================================================================
+ * @file    batch-runner.h
+ * @author  Pascal-Emmanuel Lachance
+ * @p       <a href="https://www.github.com/Raesangur">Raesangur</a>
+ * @p       <a href="https://www.raesangur.com/">https://www.raesangur.com/</a>
+ *
+ * @brief   Runs a selection of the menu tree without a terminal.
+ *
+ * ------------------------------------------------------------------------------------------------
+ * @copyright Copyright (c) 2023 Pascal-Emmanuel Lachance | Raesangur
+ *
+ * @par License: <a href="https://opensource.org/license/mit/"> MIT </a>
+ *               This project is released under the MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ * BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NON INFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ * ------------------------------------------------------------------------------------------------
+ * @details
+ * `ncurses_test --batch` builds the tree as usual, then applies the selections given on the command
+ * line instead of reading keys. Each `--select <spec>` and each line of a `--profile <file>` is one
+ * spec: a path of entry names separated by '/', such as `Install packages/C++ development/gcc`,
+ * selected as is or with a leading '+', and deselected with a leading '-'. The root's name may be
+ * left out of a path, and a single name is also looked up anywhere in the tree, so the snapshot
+ * written by selection_journal is a valid profile. Blank lines and '#' comments are skipped.
+ *
+ * The selected options that have an action or a command are then run one after the other, in tree
+ * order, followed by the install plan's batches, exactly as 'x' and 'i' would run them, and the run
+ * stops at the first one that fails. Neither ncurses nor the selection journal is touched.
+ *
+ * Progress is written to stdout as JSON lines, one object per event:
+ *     {"event":"ready","entries":12,"selected":3,"startup_ms":1.92}
+ *     {"event":"plan","nodes":2,"packages":4,"batches":1,"duplicates":0}
+ *     {"event":"start","node":1,"name":"Install zsh","kind":"command","at_ms":2.31}
+ *     {"event":"output","node":1,"task":"Install zsh","line":"..."}
+ *     {"event":"end","node":1,"name":"Install zsh","code":0,"ms":812.44}
+ *     {"event":"done","ok":true,"ran":2,"failed":0,"skipped":0,"ms":1520.07}
+ * Times are in milliseconds: `startup_ms` and `at_ms` count from the start of the process, so the
+ * cold start cost in front of every node shows directly, and `ms` is the node's own duration.
+ * Specs that match nothing are reported as `{"event":"error",...}` before anything runs.
+ * ===============================================================================================
+ */
+#ifndef BATCH_RUNNER_H
+#define BATCH_RUNNER_H
+
+
+/** ===============================================================================================
+ *  INCLUDES
+ */
+#include "action.h"
+#include "menu-manager.h"
+#include "menu.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+
+/** ===============================================================================================
+ *  CONSTANTS
+ */
+
+constexpr int         BATCH_POLL_MS    = 50;
+constexpr std::size_t BATCH_LINE_BYTES = 4096;
+
+
+/** ===============================================================================================
+ *  CLASS DEFINITION
+ */
+
+class batch_runner
+{
+public:
+    using clock = std::chrono::steady_clock;
+
+    batch_runner(menu_manager* mm, clock::time_point started, std::FILE* out = stdout);
+
+    batch_runner(const batch_runner&)   = delete;
+    void operator=(const batch_runner&) = delete;
+
+    // Applies one spec; reports it and returns false when it matches no selectable entry.
+    bool apply(std::string_view spec);
+    // Applies every spec of a profile file.
+    bool apply_profile(const std::string& filename);
+
+    // Runs the selection and returns the process exit status.
+    int run();
+
+protected:
+    struct step
+    {
+        std::string              name{};
+        std::string_view         kind{};    //!< "action", "command" or "install".
+        std::string              command{};
+        const menu_option_entry* option = nullptr;    //!< Set when the option's action is run.
+    };
+
+    [[nodiscard]] menu_entry* resolve(std::string_view path) const;
+    void                      collect(const menu_entry* entry, const selection_set& selection);
+
+    // Plans the install batches from `selection` and runs every step.
+    action execute(selection_set selection);
+    // Writes the lines captured since the previous call; a running task's last line is held back,
+    // as it may still be incomplete.
+    void drain_output();
+
+    void emit(const std::string& line);
+    void error(const std::string& message);
+
+    [[nodiscard]] double ms_since(clock::time_point since) const;
+
+protected:
+    menu_manager*     m_mm = nullptr;
+    clock::time_point m_started{};
+    std::FILE*        m_out = nullptr;
+
+    std::vector<step> m_steps{};
+    std::size_t       m_node   = 0;    //!< Number of the running step, from 1.
+    std::size_t       m_ran    = 0;
+    std::size_t       m_failed = 0;
+    std::size_t       m_errors = 0;    //!< Specs that matched nothing.
+
+    std::mutex                 m_mutex{};    //!< Orders writes from the loop and main threads.
+    std::condition_variable    m_finishedCv{};
+    bool                       m_finished = false;
+    std::vector<std::uint64_t> m_written{};    //!< Next line to write, per task id.
+    std::vector<std::size_t>   m_taskNode{};   //!< Step that started each task, per task id.
+};
+
+
+#endif  // BATCH_RUNNER_H
+/**
+ * ------------------------------------------------------------------------------------------------
+ */
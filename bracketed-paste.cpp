@@ -0,0 +1,126 @@
+/**
+ * ===============================================================================================
+ * @file    bracketed-paste.cpp
+ * @author  Pascal-Emmanuel Lachance
+ * @p       <a href="https://www.github.com/Raesangur">Raesangur</a>
+ * @p       <a href="https://www.raesangur.com/">https://www.raesangur.com/</a>
+ *
+ * @brief   Receives pasted text in one piece instead of as individual key presses.
+ *
+ * ------------------------------------------------------------------------------------------------
+ * @copyright Copyright (c) 2023 Pascal-Emmanuel Lachance | Raesangur
+ *
+ * @par License: <a href="https://opensource.org/license/mit/"> MIT </a>
+ *               This project is released under the MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ * BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NON INFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ * ===============================================================================================
+ */
+
+/** ===============================================================================================
+ *  INCLUDES
+ */
+#include "bracketed-paste.h"
+
+#include <term.h>
+
+
+/** ===============================================================================================
+ *  CONSTANTS
+ */
+
+// A paste whose end marker never arrives is given up after this long without input.
+constexpr int PASTE_TIMEOUT_MS = 500;
+
+// Anything beyond this is read but dropped, so that a runaway paste cannot exhaust memory.
+constexpr std::size_t MAX_PASTE_BYTES = 1024 * 1024;
+
+
+/** ===============================================================================================
+ *  LOCAL FUNCTIONS
+ */
+
+static const char* capability(const char* name)
+{
+    const char* value = ::tigetstr(const_cast<char*>(name));
+    return value == reinterpret_cast<char*>(-1) ? nullptr : value;
+}
+
+static bool s_enabled = false;
+
+
+/** ===============================================================================================
+ *  FUNCTION DEFINITIONS
+ */
+
+bool enable_bracketed_paste()
+{
+    const char* enable = capability("BE");
+    const char* begin  = capability("PS");
+    const char* end    = capability("PE");
+    if (enable == nullptr || begin == nullptr || end == nullptr)
+    {
+        return false;
+    }
+
+    ::define_key(begin, KEY_PASTE_BEGIN);
+    ::define_key(end, KEY_PASTE_END);
+    ::putp(enable);
+    ::fflush(stdout);
+
+    s_enabled = true;
+    return true;
+}
+
+void disable_bracketed_paste()
+{
+    const char* disable = capability("BD");
+    if (s_enabled && disable != nullptr)
+    {
+        ::putp(disable);
+        ::fflush(stdout);
+    }
+    s_enabled = false;
+}
+
+
+[[nodiscard]] std::string read_paste()
+{
+    std::string text{};
+
+    ::timeout(PASTE_TIMEOUT_MS);
+    for (int ch = ::getch(); ch != ERR && ch != KEY_PASTE_END; ch = ::getch())
+    {
+        if (text.size() >= MAX_PASTE_BYTES)
+        {
+            continue;
+        }
+        if (ch == KEY_ENTER || ch == '\r')
+        {
+            text += '\n';
+        }
+        else if (ch >= 0 && ch <= 0xFF)
+        {
+            text += static_cast<char>(ch);
+        }
+    }
+    return text;
+}
+
+
+/**
+ * ------------------------------------------------------------------------------------------------
+ */
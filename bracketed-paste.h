@@ -0,0 +1,74 @@
+/**
+ * ===============================================================================================
+ * @file    bracketed-paste.h
+ * @author  Pascal-Emmanuel Lachance
+ * @p       <a href="https://www.github.com/Raesangur">Raesangur</a>
+ * @p       <a href="https://www.raesangur.com/">https://www.raesangur.com/</a>
+ *
+ * @brief   Receives pasted text in one piece instead of as individual key presses.
+ *
+ * ------------------------------------------------------------------------------------------------
+ * @copyright Copyright (c) 2023 Pascal-Emmanuel Lachance | Raesangur
+ *
+ * @par License: <a href="https://opensource.org/license/mit/"> MIT </a>
+ *               This project is released under the MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ * BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NON INFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ * ------------------------------------------------------------------------------------------------
+ * @details
+ * With bracketed paste enabled, the terminal wraps pasted text between two escape sequences. Both are
+ * registered with ncurses as keys of their own, so getch() reports KEY_PASTE_BEGIN where a paste
+ * starts; read_paste() then collects everything up to KEY_PASTE_END, and the caller applies it as a
+ * single edit and draws a single frame. The sequences come from the terminfo `BE`, `BD`, `PS` and
+ * `PE` extended capabilities; terminals that do not advertise them just keep sending keys.
+ * ===============================================================================================
+ */
+#ifndef BRACKETED_PASTE_H
+#define BRACKETED_PASTE_H
+
+
+/** ===============================================================================================
+ *  INCLUDES
+ */
+#include <ncurses.h>
+
+#include <string>
+
+
+/** ===============================================================================================
+ *  CONSTANTS
+ */
+
+constexpr int KEY_PASTE_BEGIN = KEY_MAX + 1;
+constexpr int KEY_PASTE_END   = KEY_MAX + 2;
+
+
+/** ===============================================================================================
+ *  FUNCTION DECLARATIONS
+ */
+
+// Must be called after initscr(); returns false when the terminal does not support it.
+bool enable_bracketed_paste();
+void disable_bracketed_paste();
+
+// Reads the pasted bytes following KEY_PASTE_BEGIN; line breaks are kept as '\n'.
+[[nodiscard]] std::string read_paste();
+
+
+#endif  // BRACKETED_PASTE_H
+/**
+ * ------------------------------------------------------------------------------------------------
+ */
@@ -0,0 +1,583 @@
+/**
+ * ===============================================================================================
+ * @file    cell-renderer.cpp
+ * @author  Pascal-Emmanuel Lachance
+ * @p       <a href="https://www.github.com/Raesangur">Raesangur</a>
+ * @p       <a href="https://www.raesangur.com/">https://www.raesangur.com/</a>
+ *
+ * @brief   Terminal output backend diffing double-buffered cell grids, without ncurses.
+ *
+ * ------------------------------------------------------------------------------------------------
+ * @copyright Copyright (c) 2023 Pascal-Emmanuel Lachance | Raesangur
+ *
+ * @par License: <a href="https://opensource.org/license/mit/"> MIT </a>
+ *               This project is released under the MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ * BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NON INFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ * ===============================================================================================
+ */
+
+/** ===============================================================================================
+ *  INCLUDES
+ */
+#include "cell-renderer.h"
+
+#include "display-width.h"
+#include "memory-accounting.h"
+#include "trace.h"
+
+#include <ncurses.h>
+#include <term.h>
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <sys/uio.h>
+#include <unistd.h>
+
+
+/** ===============================================================================================
+ *  SINGLETON INSTANCE
+ */
+cell_renderer* cell_renderer::m_instance = nullptr;
+
+
+/** ===============================================================================================
+ *  CONSTANTS
+ */
+
+constexpr std::string_view SYNC_BEGIN = "\x1b[?2026h";
+constexpr std::string_view SYNC_END   = "\x1b[?2026l";
+
+// Unchanged cells shorter than a cursor movement are re-sent rather than jumped over.
+constexpr int MAX_GAP = 4;
+
+constexpr char32_t UNKNOWN_CELL = 0xFFFFFFFF;
+
+// Past this many colors, a color number is a 24-bit RGB value rather than a palette index.
+constexpr int DIRECT_COLORS = 0x1000000;
+
+constexpr char32_t BOX_HORIZONTAL   = U'─';
+constexpr char32_t BOX_VERTICAL     = U'│';
+constexpr char32_t BOX_TOP_LEFT     = U'┌';
+constexpr char32_t BOX_TOP_RIGHT    = U'┐';
+constexpr char32_t BOX_BOTTOM_LEFT  = U'└';
+constexpr char32_t BOX_BOTTOM_RIGHT = U'┘';
+
+
+/** ===============================================================================================
+ *  LOCAL FUNCTIONS
+ */
+
+static bool terminal_supports_sync()
+{
+    const char* forced = std::getenv("NCURSES_TEST_SYNC");
+    if (forced != nullptr)
+    {
+        return std::strcmp(forced, "0") != 0;
+    }
+
+    const char* sync = ::tigetstr(const_cast<char*>("Sync"));
+    return sync != nullptr && sync != reinterpret_cast<char*>(-1);
+}
+
+static void append_color(std::string& out, int color, bool background)
+{
+    char buffer[32];
+    int  base = background ? 40 : 30;
+
+    // On a direct-color terminal even the low numbers are RGB values, so black stays black.
+    bool direct = COLORS >= DIRECT_COLORS;
+
+    if (color < 0)
+    {
+        std::snprintf(buffer, sizeof(buffer), ";%d", base + 9);
+    }
+    else if (!direct && color < 8)
+    {
+        std::snprintf(buffer, sizeof(buffer), ";%d", base + color);
+    }
+    else if (!direct && color < 16)
+    {
+        std::snprintf(buffer, sizeof(buffer), ";%d", base + 60 + color - 8);
+    }
+    else if (!direct && color < 256)
+    {
+        std::snprintf(buffer, sizeof(buffer), ";%d;5;%d", base + 8, color);
+    }
+    else
+    {
+        std::snprintf(buffer,
+                      sizeof(buffer),
+                      ";%d;2;%d;%d;%d",
+                      base + 8,
+                      (color >> 16) & 0xFF,
+                      (color >> 8) & 0xFF,
+                      color & 0xFF);
+    }
+
+    out += buffer;
+}
+
+
+/** ===============================================================================================
+ *  MEMBER FUNCTIONS DEFINITIONS
+ */
+
+cell_renderer::cell_renderer(int rows, int cols) :
+    m_rows{rows},
+    m_cols{cols},
+    m_front(static_cast<std::size_t>(rows * cols), cell{UNKNOWN_CELL, style{}}),
+    m_back(static_cast<std::size_t>(rows * cols)),
+    m_dirtyRows(static_cast<std::size_t>(rows), true)
+{
+    m_synchronized = terminal_supports_sync();
+
+    // The front and back grids are charged as two objects; the renderer lives until exit.
+    memory_accounting::allocate(memory_category::windows,
+                                (m_front.capacity() + m_back.capacity()) * sizeof(cell), 2);
+}
+
+[[nodiscard]] cell_renderer* cell_renderer::get()
+{
+    if (m_instance == nullptr)
+    {
+        int rows = 0;
+        int cols = 0;
+        getmaxyx(stdscr, rows, cols);
+
+        m_instance = new cell_renderer{rows, cols};
+    }
+    return m_instance;
+}
+
+
+int cell_renderer::put(int y, int x, std::string_view text, const style& st, int limit)
+{
+    if (y < 0 || y >= m_rows)
+    {
+        return 0;
+    }
+
+    limit   = std::min(limit, m_cols);
+    int col = x;
+    while (!text.empty() && col < limit)
+    {
+        char32_t codepoint = 0;
+        text.remove_prefix(decode_utf8(text, codepoint));
+
+        int width = codepoint_width(codepoint);
+        if (width == 0)
+        {
+            continue;
+        }
+        if (col + width > limit)
+        {
+            break;
+        }
+
+        if (col >= 0)
+        {
+            set(y, col, codepoint, st);
+            if (width == 2)
+            {
+                set(y, col + 1, 0, st);
+            }
+        }
+        col += width;
+    }
+
+    return col - x;
+}
+
+void cell_renderer::fill(int y, int x, int h, int w, const style& st)
+{
+    for (int row = std::max(y, 0); row < std::min(y + h, m_rows); row++)
+    {
+        touch(row);
+        for (int col = std::max(x, 0); col < std::min(x + w, m_cols); col++)
+        {
+            at(row, col) = cell{U' ', st};
+        }
+    }
+}
+
+void cell_renderer::horizontal_line(int y, int x, int n, const style& st)
+{
+    for (int col = x; col < x + n; col++)
+    {
+        if (y >= 0 && y < m_rows && col >= 0 && col < m_cols)
+        {
+            set(y, col, BOX_HORIZONTAL, st);
+        }
+    }
+}
+
+void cell_renderer::box(int y, int x, int h, int w, const style& st)
+{
+    if (h < 2 || w < 2)
+    {
+        return;
+    }
+
+    horizontal_line(y, x + 1, w - 2, st);
+    horizontal_line(y + h - 1, x + 1, w - 2, st);
+    for (int row = y + 1; row < y + h - 1; row++)
+    {
+        if (row >= 0 && row < m_rows)
+        {
+            if (x >= 0 && x < m_cols)
+            {
+                set(row, x, BOX_VERTICAL, st);
+            }
+            if (x + w - 1 >= 0 && x + w - 1 < m_cols)
+            {
+                set(row, x + w - 1, BOX_VERTICAL, st);
+            }
+        }
+    }
+
+    auto corner = [&](int row, int col, char32_t ch)
+    {
+        if (row >= 0 && row < m_rows && col >= 0 && col < m_cols)
+        {
+            set(row, col, ch, st);
+        }
+    };
+    corner(y, x, BOX_TOP_LEFT);
+    corner(y, x + w - 1, BOX_TOP_RIGHT);
+    corner(y + h - 1, x, BOX_BOTTOM_LEFT);
+    corner(y + h - 1, x + w - 1, BOX_BOTTOM_RIGHT);
+}
+
+void cell_renderer::scroll_area(int y, int x, int h, int w, int n, const style& st)
+{
+    // Only the back grid moves: flush() then sends whatever differs from the screen.
+    int top    = std::max(y, 0);
+    int bottom = std::min(y + h, m_rows);
+    int left   = std::max(x, 0);
+    int right  = std::min(x + w, m_cols);
+    if (top >= bottom || left >= right)
+    {
+        return;
+    }
+
+    auto copy_row = [&](int from, int to)
+    {
+        touch(to);
+        std::copy(m_back.begin() + static_cast<std::ptrdiff_t>(from * m_cols + left),
+                  m_back.begin() + static_cast<std::ptrdiff_t>(from * m_cols + right),
+                  m_back.begin() + static_cast<std::ptrdiff_t>(to * m_cols + left));
+    };
+
+    if (n > 0)
+    {
+        for (int row = top; row + n < bottom; row++)
+        {
+            copy_row(row + n, row);
+        }
+        fill(std::max(bottom - n, top), left, std::min(n, bottom - top), right - left, st);
+    }
+    else if (n < 0)
+    {
+        for (int row = bottom - 1; row + n >= top; row--)
+        {
+            copy_row(row + n, row);
+        }
+        fill(top, left, std::min(-n, bottom - top), right - left, st);
+    }
+}
+
+
+void cell_renderer::resize(int rows, int cols)
+{
+    if (rows == m_rows && cols == m_cols)
+    {
+        return;
+    }
+
+    memory_accounting::release(memory_category::windows,
+                               (m_front.capacity() + m_back.capacity()) * sizeof(cell), 2);
+
+    m_rows = rows;
+    m_cols = cols;
+    std::vector<cell>(static_cast<std::size_t>(rows * cols), cell{UNKNOWN_CELL, style{}})
+      .swap(m_front);
+    std::vector<cell>(static_cast<std::size_t>(rows * cols)).swap(m_back);
+    m_dirtyRows.assign(static_cast<std::size_t>(rows), true);
+
+    memory_accounting::allocate(memory_category::windows,
+                                (m_front.capacity() + m_back.capacity()) * sizeof(cell), 2);
+}
+
+void cell_renderer::flush()
+{
+    m_frame.clear();
+
+    // ncurses may have moved the cursor while reading input, so every frame starts from scratch.
+    m_cursorY    = -1;
+    m_cursorX    = -1;
+    m_styleKnown = false;
+
+    for (int y = 0; y < m_rows; y++)
+    {
+        if (!m_dirtyRows[static_cast<std::size_t>(y)])
+        {
+            continue;
+        }
+        m_dirtyRows[static_cast<std::size_t>(y)] = false;
+
+        const std::size_t row = static_cast<std::size_t>(y * m_cols);
+
+        int x = 0;
+        while (x < m_cols)
+        {
+            if (m_back[row + x] == m_front[row + x])
+            {
+                x++;
+                continue;
+            }
+
+            int start = x;
+            if (m_back[row + start].ch == 0 && start > 0)
+            {
+                start--;
+            }
+
+            int end = x + 1;
+            for (int gap = 0, i = x + 1; i < m_cols && gap <= MAX_GAP; i++)
+            {
+                if (m_back[row + i] == m_front[row + i])
+                {
+                    gap++;
+                }
+                else
+                {
+                    gap = 0;
+                    end = i + 1;
+                }
+            }
+
+            move_to(y, start);
+            for (int i = start; i < end; i++)
+            {
+                const cell& current = m_back[row + i];
+                if (current.ch == 0)
+                {
+                    continue;
+                }
+
+                emit_style(current.st);
+                emit(current.ch);
+                m_cursorX += (i + 1 < m_cols && m_back[row + i + 1].ch == 0) ? 2 : 1;
+            }
+
+            std::copy(m_back.begin() + static_cast<std::ptrdiff_t>(row + start),
+                      m_back.begin() + static_cast<std::ptrdiff_t>(row + end),
+                      m_front.begin() + static_cast<std::ptrdiff_t>(row + start));
+            x = end;
+        }
+    }
+
+    m_stats.frames++;
+    m_stats.lastBytes    = 0;
+    m_stats.lastSyscalls = 0;
+    if (m_frame.empty())
+    {
+        return;
+    }
+
+    std::array<iovec, 3> parts{};
+    std::size_t          count = 0;
+    if (m_synchronized)
+    {
+        parts[count++] = iovec{const_cast<char*>(SYNC_BEGIN.data()), SYNC_BEGIN.size()};
+    }
+    parts[count++] = iovec{m_frame.data(), m_frame.size()};
+    if (m_synchronized)
+    {
+        parts[count++] = iovec{const_cast<char*>(SYNC_END.data()), SYNC_END.size()};
+    }
+
+    iovec* part = parts.data();
+    while (count > 0)
+    {
+        ssize_t written = ::writev(STDOUT_FILENO, part, static_cast<int>(count));
+        m_stats.lastSyscalls++;
+        if (written < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            break;
+        }
+
+        auto done = static_cast<std::size_t>(written);
+        m_stats.lastBytes += done;
+        while (count > 0 && done >= part->iov_len)
+        {
+            done -= part->iov_len;
+            part++;
+            count--;
+        }
+        if (count > 0)
+        {
+            part->iov_base = static_cast<char*>(part->iov_base) + done;
+            part->iov_len -= done;
+        }
+    }
+
+    m_stats.totalBytes += m_stats.lastBytes;
+    trace::counter("terminal bytes", m_stats.totalBytes);
+    m_stats.totalSyscalls += m_stats.lastSyscalls;
+}
+
+
+void cell_renderer::set(int y, int x, char32_t ch, const style& st)
+{
+    // Overwriting half of a double-width character blanks the other half.
+    if (at(y, x).ch == 0 && ch != 0 && x > 0)
+    {
+        at(y, x - 1).ch = U' ';
+    }
+    if (ch != 0 && x + 1 < m_cols && at(y, x + 1).ch == 0)
+    {
+        at(y, x + 1).ch = U' ';
+    }
+
+    at(y, x) = cell{ch, st};
+    touch(y);
+}
+
+void cell_renderer::move_to(int y, int x)
+{
+    if (y == m_cursorY && x == m_cursorX)
+    {
+        return;
+    }
+
+    char buffer[32];
+    if (y == m_cursorY && x > m_cursorX && m_cursorX >= 0)
+    {
+        std::snprintf(buffer, sizeof(buffer), "\x1b[%dC", x - m_cursorX);
+    }
+    else
+    {
+        std::snprintf(buffer, sizeof(buffer), "\x1b[%d;%dH", y + 1, x + 1);
+    }
+    m_frame += buffer;
+
+    m_cursorY = y;
+    m_cursorX = x;
+}
+
+void cell_renderer::emit_style(const style& st)
+{
+    if (m_styleKnown && st == m_current)
+    {
+        return;
+    }
+
+    m_frame += sgr(st);
+    m_current    = st;
+    m_styleKnown = true;
+}
+
+void cell_renderer::emit(char32_t ch)
+{
+    if (ch < 0x80)
+    {
+        m_frame += static_cast<char>(ch);
+    }
+    else if (ch < 0x800)
+    {
+        m_frame += static_cast<char>(0xC0 | (ch >> 6));
+        m_frame += static_cast<char>(0x80 | (ch & 0x3F));
+    }
+    else if (ch < 0x10000)
+    {
+        m_frame += static_cast<char>(0xE0 | (ch >> 12));
+        m_frame += static_cast<char>(0x80 | ((ch >> 6) & 0x3F));
+        m_frame += static_cast<char>(0x80 | (ch & 0x3F));
+    }
+    else
+    {
+        m_frame += static_cast<char>(0xF0 | (ch >> 18));
+        m_frame += static_cast<char>(0x80 | ((ch >> 12) & 0x3F));
+        m_frame += static_cast<char>(0x80 | ((ch >> 6) & 0x3F));
+        m_frame += static_cast<char>(0x80 | (ch & 0x3F));
+    }
+}
+
+
+[[nodiscard]] const std::string& cell_renderer::sgr(const style& st)
+{
+    std::uint64_t key = (static_cast<std::uint64_t>(st.attrs) << 16)
+                        | static_cast<std::uint16_t>(st.pair);
+
+    auto cached = m_sgrCache.find(key);
+    if (cached != m_sgrCache.end())
+    {
+        return cached->second;
+    }
+
+    std::string sequence = "\x1b[0";
+    if ((st.attrs & A_BOLD) != 0)
+    {
+        sequence += ";1";
+    }
+    if ((st.attrs & A_DIM) != 0)
+    {
+        sequence += ";2";
+    }
+    if ((st.attrs & A_ITALIC) != 0)
+    {
+        sequence += ";3";
+    }
+    if ((st.attrs & A_UNDERLINE) != 0)
+    {
+        sequence += ";4";
+    }
+    if ((st.attrs & A_BLINK) != 0)
+    {
+        sequence += ";5";
+    }
+    if ((st.attrs & (A_REVERSE | A_STANDOUT)) != 0)
+    {
+        sequence += ";7";
+    }
+
+    int foreground = -1;
+    int background = -1;
+    if (st.pair != 0)
+    {
+        extended_pair_content(st.pair, &foreground, &background);
+    }
+    append_color(sequence, foreground, false);
+    append_color(sequence, background, true);
+    sequence += 'm';
+
+    return m_sgrCache.emplace(key, std::move(sequence)).first->second;
+}
+
+
+/**
+ * ------------------------------------------------------------------------------------------------
+ */
@@ -0,0 +1,173 @@
+/**
+ * ===============================================================================================
+ * @file    cell-renderer.h
+ * @author  Pascal-Emmanuel Lachance
+ * @p       <a href="https://www.github.com/Raesangur">Raesangur</a>
+ * @p       <a href="https://www.raesangur.com/">https://www.raesangur.com/</a>
+ *
+ * @brief   Terminal output backend diffing double-buffered cell grids, without ncurses.
+ *
+ * ------------------------------------------------------------------------------------------------
+ * @copyright Copyright (c) 2023 Pascal-Emmanuel Lachance | Raesangur
+ *
+ * @par License: <a href="https://opensource.org/license/mit/"> MIT </a>
+ *               This project is released under the MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ * BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NON INFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ * ------------------------------------------------------------------------------------------------
+ * @details
+ * Windows draw into the back grid; flush() compares it with the front grid, which mirrors what
+ * the terminal shows, and only sends the cells that changed. Changed cells are grouped into runs
+ * per row: one cursor move per run, and an SGR sequence only when the style actually changes.
+ * A whole frame is built in one buffer and handed to the terminal with a single writev, bracketed
+ * by the synchronized update mode (DEC private mode 2026) when terminfo advertises the `Sync`
+ * capability, so the terminal never shows a half-drawn frame.
+ *
+ * ncurses keeps handling input; it is simply never asked to draw once this backend is enabled.
+ * ===============================================================================================
+ */
+#ifndef CELL_RENDERER_H
+#define CELL_RENDERER_H
+
+
+/** ===============================================================================================
+ *  INCLUDES
+ */
+#include "theme.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+
+/** ===============================================================================================
+ *  TYPES
+ */
+
+struct cell
+{
+    // 0 marks the second half of a double-width character.
+    char32_t ch = U' ';
+    style    st{};
+
+    bool operator==(const cell&) const = default;
+};
+
+struct render_stats
+{
+    std::size_t frames       = 0;
+    std::size_t lastBytes    = 0;
+    std::size_t lastSyscalls = 0;
+    std::size_t totalBytes   = 0;
+    std::size_t totalSyscalls = 0;
+};
+
+
+/** ===============================================================================================
+ *  CLASS DEFINITION
+ */
+
+class cell_renderer
+{
+protected:
+    cell_renderer(int rows, int cols);
+
+public:
+    cell_renderer(const cell_renderer&)  = delete;
+    void operator=(const cell_renderer&) = delete;
+
+    [[nodiscard]] static cell_renderer* get();
+
+    [[nodiscard]] int rows() const
+    {
+        return m_rows;
+    }
+    [[nodiscard]] int cols() const
+    {
+        return m_cols;
+    }
+
+    // Writes text at (y, x), clipped to the column limit; returns the number of columns used.
+    int  put(int y, int x, std::string_view text, const style& st, int limit);
+    void fill(int y, int x, int h, int w, const style& st);
+    void horizontal_line(int y, int x, int n, const style& st);
+    void box(int y, int x, int h, int w, const style& st);
+    void scroll_area(int y, int x, int h, int w, int n, const style& st);
+
+    // Reallocates both grids after the terminal was resized; the next flush repaints everything.
+    void resize(int rows, int cols);
+    void flush();
+
+    void set_synchronized(bool enabled)
+    {
+        m_synchronized = enabled;
+    }
+
+    [[nodiscard]] const render_stats& stats() const
+    {
+        return m_stats;
+    }
+
+protected:
+    [[nodiscard]] cell& at(int y, int x)
+    {
+        return m_back[static_cast<std::size_t>(y * m_cols + x)];
+    }
+
+    void touch(int y)
+    {
+        m_dirtyRows[static_cast<std::size_t>(y)] = true;
+    }
+
+    void set(int y, int x, char32_t ch, const style& st);
+    void move_to(int y, int x);
+    void emit_style(const style& st);
+    void emit(char32_t ch);
+
+    [[nodiscard]] const std::string& sgr(const style& st);
+
+protected:
+    static cell_renderer* m_instance;
+
+    int m_rows = 0;
+    int m_cols = 0;
+
+    std::vector<cell> m_front{};
+    std::vector<cell> m_back{};
+
+    // Rows written since the last flush; the others are not even compared.
+    std::vector<bool> m_dirtyRows{};
+
+    std::string m_frame{};
+    int         m_cursorY = -1;
+    int         m_cursorX = -1;
+    style       m_current{};
+    bool        m_styleKnown = false;
+
+    bool m_synchronized = false;
+
+    std::unordered_map<std::uint64_t, std::string> m_sgrCache{};
+    render_stats                                   m_stats{};
+};
+
+
+#endif  // CELL_RENDERER_H
+/**
+ * ------------------------------------------------------------------------------------------------
+ */
@@ -34,14 +34,10 @@
  *  INCLUDES
  */
 #include "colors.h"
+#include "theme.h"
 
-
-/** ===============================================================================================
- *  CONSTANTS
- */
-
-constexpr int STDSCR_COLORS = 1;
-constexpr int MENU_COLORS   = 2;
+#include <cstdio>
+#include <cstdlib>
 
 
 /** ===============================================================================================
@@ -65,10 +61,20 @@ bool enable_colors()
     return colors;
 }
 
+bool load_environment_theme()
+{
+    const char* themeFile = std::getenv("NCURSES_TEST_THEME");
+    if (themeFile != nullptr && !theme::get()->load_file(themeFile))
+    {
+        std::fprintf(stderr, "NCURSES_TEST_THEME: cannot load theme '%s'\n", themeFile);
+        return false;
+    }
+    return true;
+}
+
 void configure_background_colors()
 {
-    init_pair(STDSCR_COLORS, COLOR_WHITE, COLOR_BLUE);
-    init_pair(MENU_COLORS, COLOR_BLACK, COLOR_WHITE);
+    theme::get()->resolve();
 }
 
 
@@ -43,6 +43,9 @@
  */
 
 bool enable_colors();
+// Loads the theme file named by NCURSES_TEST_THEME, if set; false, once reported, when it is bad.
+bool load_environment_theme();
+// Resolves the theme's styles, with or without colors; must run after initscr().
 void configure_background_colors();
 
 
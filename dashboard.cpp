@@ -0,0 +1,450 @@
+/**
+ * ===============================================================================================
+ * @file    dashboard.cpp
+ * @author  Pascal-Emmanuel Lachance
+ * @p       <a href="https://www.github.com/Raesangur">Raesangur</a>
+ * @p       <a href="https://www.raesangur.com/">https://www.raesangur.com/</a>
+ *
+ * @brief   Panes of the main screen, laid out by main() with a layout tree.
+ *
+ * ------------------------------------------------------------------------------------------------
+ * @copyright Copyright (c) 2023 Pascal-Emmanuel Lachance | Raesangur
+ *
+ * @par License: <a href="https://opensource.org/license/mit/"> MIT </a>
+ *               This project is released under the MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ * BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NON INFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ * ===============================================================================================
+ */
+
+/** ===============================================================================================
+ *  INCLUDES
+ */
+#include "dashboard.h"
+
+#include "action.h"
+#include "display-width.h"
+#include "entry-metadata.h"
+#include "entry-probes.h"
+#include "memory-accounting.h"
+#include "menu-reload.h"
+#include "package-status.h"
+#include "task-runner.h"
+#include "theme.h"
+
+#include <algorithm>
+
+
+/** ===============================================================================================
+ *  CONSTANTS
+ */
+
+constexpr std::string_view TITLE = "Bon matin";
+
+constexpr int LABEL_COL = 2;
+constexpr int VALUE_COL = 13;
+
+
+/** ===============================================================================================
+ *  LOCAL FUNCTIONS
+ */
+
+static void draw_frame(window& win, const std::string& title)
+{
+    win.set_style(theme::get()->get(style_id::menu));
+    win.box();
+    win.print(0, clip_to_width(title, win.width() - 2));
+}
+
+static void draw_field(window& win, int y, const std::string& label, const std::string& value)
+{
+    win.print(y, LABEL_COL, label);
+    win.print(y, VALUE_COL, clip_to_width(value, win.width() - VALUE_COL - 1));
+}
+
+static const char* entry_kind(const menu_entry* entry)
+{
+    if (dynamic_cast<const menu_input_entry*>(entry) != nullptr)
+    {
+        return "input";
+    }
+    if (dynamic_cast<const menu_top_option_entry*>(entry) != nullptr)
+    {
+        return "group";
+    }
+    if (dynamic_cast<const menu_top_entry*>(entry) != nullptr)
+    {
+        return "menu";
+    }
+    if (dynamic_cast<const menu_option_entry*>(entry) != nullptr)
+    {
+        return "option";
+    }
+    return "text";
+}
+
+
+/** ===============================================================================================
+ *  MEMBER FUNCTIONS DEFINITIONS
+ */
+
+void header_pane::set_status(std::string status)
+{
+    m_status = std::move(status);
+    mark_dirty();
+}
+
+void header_pane::render(window& win, bool full)
+{
+    if (!full)
+    {
+        win.erase();
+    }
+
+    win.set_style(theme::get()->get(style_id::title));
+    win.print(0, std::string{TITLE});
+
+    win.move(1, 1);
+    win.line(win.width() - 2);
+    win.set_style(theme::get()->get(style_id::background));
+
+    if (!m_status.empty())
+    {
+        // Left of the title, which stays centered.
+        int columns = (win.width() - static_cast<int>(TITLE.size())) / 2 - 2;
+        win.print(0, 1, clip_to_width(m_status, columns));
+    }
+}
+
+
+void help_pane::render(window& win, bool full)
+{
+    if (!full)
+    {
+        return;
+    }
+
+    win.set_style(theme::get()->get(style_id::background));
+    win.print(0, {"'q' quits, 'm' writes the memory report, 'x' runs an option, "
+                  "'o' shows its output, 'l' the log."});
+    win.print(1, {"'PGUP'/'PGDN', 'HOME'/'END', '<n>g' navigate. "
+                  "'ENTER' enters, 't' a table, 'v' a tree, 's' sorts."});
+    win.print(2, {"Press 'ESC' to exit menu. Press 'SPACE' to select an option, "
+                  "'i' to install the selected packages."});
+}
+
+
+void main_pane::show(view_mode view)
+{
+    m_view = view;
+    mark_dirty();
+}
+
+void main_pane::toggle_table()
+{
+    m_table = !m_table;
+    mark_dirty();
+}
+
+bool main_pane::toggle_tree()
+{
+    mark_dirty();
+    if (m_tree.has_value())
+    {
+        m_tree.reset();
+        return true;
+    }
+
+    auto* menu = dynamic_cast<menu_top_entry*>(m_menus->top());
+    if (menu == nullptr)
+    {
+        return false;
+    }
+    m_tree.emplace(menu);
+    m_tree->move_to(menu->current_index());
+    return true;
+}
+
+bool main_pane::handle_log_key(int ch)
+{
+    if (m_view != view_mode::log || !m_logView.has_value() || !m_logView->handle_key(*m_log, ch))
+    {
+        return false;
+    }
+    mark_dirty();
+    return true;
+}
+
+[[nodiscard]] bool main_pane::is_animated() const
+{
+    switch (m_view)
+    {
+        case view_mode::output:
+            return task_runner::get()->has_running();
+        case view_mode::log:
+            return m_logView.has_value() && m_logView->is_animated(*m_log);
+        default:
+            return false;
+    }
+}
+
+[[nodiscard]] bool main_pane::is_dirty() const
+{
+    if (m_dirty)
+    {
+        return true;
+    }
+    if (m_view == view_mode::output)
+    {
+        return task_runner::get()->generation() != m_generation;
+    }
+    if (m_view == view_mode::menu)
+    {
+        return package_status::get()->generation() != m_packageGeneration ||
+               menu_reloader::get()->generation() != m_reloadGeneration ||
+               entry_probes::get()->generation() != m_probeGeneration ||
+               entry_probes::get()->due();
+    }
+    return m_view == view_mode::log && is_animated();
+}
+
+[[nodiscard]] int main_pane::visible_rows() const
+{
+    if (m_tree.has_value() && m_treeView.has_value())
+    {
+        return std::max(m_treeView->visible_rows(), 1);
+    }
+    return m_menuView.has_value() ? std::max(m_menuView->visible_rows(), 1) : 1;
+}
+
+void main_pane::render(window& win, bool full)
+{
+    if (!m_menuView.has_value())
+    {
+        m_menuView.emplace(win);
+        m_inputView.emplace(win);
+        m_outputView.emplace(win);
+        m_logView.emplace(win);
+        m_treeView.emplace(win);
+    }
+
+    const menu_entry* top                = m_menus->top();
+    std::uint64_t     packageGeneration  = package_status::get()->generation();
+    std::uint64_t     metadataGeneration = entry_metadata::get()->generation();
+    std::uint64_t     reloadGeneration   = menu_reloader::get()->generation();
+    std::uint64_t     probeGeneration    = entry_probes::get()->generation();
+    if (full || m_view != m_shown || top != m_top || packageGeneration != m_packageGeneration ||
+        metadataGeneration != m_metadataGeneration || reloadGeneration != m_reloadGeneration ||
+        probeGeneration != m_probeGeneration || m_tree.has_value() != m_treeShown)
+    {
+        // The views share the window, so each one starts from scratch when it comes back.
+        m_menuView->invalidate();
+        m_inputView->invalidate();
+        m_outputView->invalidate();
+        m_logView->invalidate();
+        m_treeView->invalidate();
+        if (m_tree.has_value() && reloadGeneration != m_reloadGeneration)
+        {
+            // A reload may have added or removed children under the tree's rows.
+            m_tree->rebuild();
+        }
+        m_shown              = m_view;
+        m_top                = top;
+        m_packageGeneration  = packageGeneration;
+        m_metadataGeneration = metadataGeneration;
+        m_reloadGeneration   = reloadGeneration;
+        m_probeGeneration    = probeGeneration;
+        m_treeShown          = m_tree.has_value();
+    }
+    m_menuView->set_table(m_table);
+
+    switch (m_shown)
+    {
+        case view_mode::menu:
+            if (auto* menu = dynamic_cast<const menu_top_entry*>(top); menu != nullptr && m_tree)
+            {
+                entry_probes::get()->request({});
+                m_treeView->render(*m_tree);
+            }
+            else if (menu != nullptr)
+            {
+                m_menuView->render(menu);
+            }
+            else if (auto* input = dynamic_cast<const menu_input_entry*>(top); input != nullptr)
+            {
+                entry_probes::get()->request({});
+                m_inputView->render(input);
+            }
+            break;
+        case view_mode::output:
+            entry_probes::get()->request({});
+            // Read first: output captured while drawing then makes the next frame dirty.
+            m_generation = task_runner::get()->generation();
+            m_outputView->render(task_runner::get()->last());
+            break;
+        case view_mode::log:
+            entry_probes::get()->request({});
+            m_logView->render(*m_log);
+            break;
+    }
+}
+
+
+[[nodiscard]] bool details_pane::is_dirty() const
+{
+    if (m_dirty)
+    {
+        return true;
+    }
+
+    const menu_entry* entry = highlighted();
+    if (entry != m_entry)
+    {
+        return true;
+    }
+    if (entry == nullptr)
+    {
+        return false;
+    }
+
+    auto* menu = dynamic_cast<const menu_top_entry*>(entry);
+    return entry->is_selected() != m_selected || (menu != nullptr && menu->size() != m_size);
+}
+
+void details_pane::render(window& win, bool full)
+{
+    if (!full)
+    {
+        win.erase();
+    }
+
+    m_entry    = highlighted();
+    m_selected = m_entry != nullptr && m_entry->is_selected();
+    m_size     = 0;
+
+    draw_frame(win, "Details");
+    if (m_entry == nullptr)
+    {
+        return;
+    }
+
+    draw_field(win, 1, "Name", m_entry->get_name());
+    draw_field(win, 2, "Kind", entry_kind(m_entry));
+    if (m_entry->can_select())
+    {
+        draw_field(win, 3, "Selected", m_selected ? "yes" : "no");
+    }
+
+    if (auto* menu = dynamic_cast<const menu_top_entry*>(m_entry); menu != nullptr)
+    {
+        m_size = menu->size();
+        draw_field(win,
+                   4,
+                   "Entries",
+                   menu->is_materialized() ? std::to_string(m_size) : "not loaded yet");
+    }
+    else if (auto* option = dynamic_cast<const menu_option_entry*>(m_entry);
+             option != nullptr && !option->command().empty())
+    {
+        draw_field(win, 4, "Command", option->command());
+    }
+    else if (auto* input = dynamic_cast<const menu_input_entry*>(m_entry); input != nullptr)
+    {
+        draw_field(win, 3, "Value", input->value());
+    }
+}
+
+[[nodiscard]] const menu_entry* details_pane::highlighted() const
+{
+    const menu_entry* top  = m_menus->top();
+    const menu_tree*  tree = m_view != nullptr ? m_view->tree() : nullptr;
+    if (tree != nullptr && top == tree->root())
+    {
+        return tree->cursor_entry();
+    }
+    return top == nullptr ? nullptr : top->highlighted_entry();
+}
+
+
+[[nodiscard]] bool task_pane::is_dirty() const
+{
+    return m_dirty || task_runner::get()->generation() != m_generation;
+}
+
+void task_pane::render(window& win, bool full)
+{
+    if (!m_view.has_value())
+    {
+        m_view.emplace(win);
+    }
+    if (full)
+    {
+        m_view->invalidate();
+    }
+
+    m_generation = task_runner::get()->generation();
+    m_view->render(task_runner::get()->last());
+}
+
+
+[[nodiscard]] bool stats_pane::is_dirty() const
+{
+    return m_dirty || sample() != m_shown;
+}
+
+void stats_pane::render(window& win, bool full)
+{
+    if (!full)
+    {
+        win.erase();
+    }
+
+    m_shown = sample();
+
+    draw_frame(win, "Stats");
+    draw_field(win,
+               1,
+               "Tasks",
+               std::to_string(m_shown.running) + " running, " + std::to_string(m_shown.done) +
+                 " done");
+    draw_field(win, 2, "Actions", std::to_string(m_shown.actions) + " running");
+    draw_field(win, 3, "Selected", std::to_string(m_shown.selected));
+    draw_field(win, 4, "Memory", std::to_string(m_shown.memoryKiB) + " KiB tracked");
+}
+
+[[nodiscard]] stats_pane::values stats_pane::sample()
+{
+    task_progress progress = task_runner::get()->progress();
+
+    values current{};
+    current.running  = progress.running;
+    current.done     = progress.done;
+    current.actions  = event_loop::get()->active();
+    current.selected = menu_option_entry::selected_count();
+    for (std::size_t i = 0; i < static_cast<std::size_t>(memory_category::count); i++)
+    {
+        current.memoryKiB += memory_accounting::usage(static_cast<memory_category>(i)).bytes;
+    }
+    // Counted in KiB so that small allocations do not redraw the pane every frame.
+    current.memoryKiB /= 1024;
+
+    return current;
+}
+
+
+/**
+ * ------------------------------------------------------------------------------------------------
+ */
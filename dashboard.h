@@ -0,0 +1,242 @@
+/**
+ * ===============================================================================================
+ * @file    dashboard.h
+ * @author  Pascal-Emmanuel Lachance
+ * @p       <a href="https://www.github.com/Raesangur">Raesangur</a>
+ * @p       <a href="https://www.raesangur.com/">https://www.raesangur.com/</a>
+ *
+ * @brief   Panes of the main screen, laid out by main() with a layout tree.
+ *
+ * ------------------------------------------------------------------------------------------------
+ * @copyright Copyright (c) 2023 Pascal-Emmanuel Lachance | Raesangur
+ *
+ * @par License: <a href="https://opensource.org/license/mit/"> MIT </a>
+ *               This project is released under the MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ * BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NON INFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ * ------------------------------------------------------------------------------------------------
+ * @details
+ * Each pane decides for itself when it is dirty. Panes driven by user input are marked by the input
+ * handler; the others compare the few values they display with what is on screen, so the task log
+ * only redraws when a task captured output and the stats only when a number they show moved.
+ * ===============================================================================================
+ */
+#ifndef DASHBOARD_H
+#define DASHBOARD_H
+
+
+/** ===============================================================================================
+ *  INCLUDES
+ */
+#include "input-view.h"
+#include "layout.h"
+#include "log-file.h"
+#include "log-view.h"
+#include "menu-manager.h"
+#include "menu-tree.h"
+#include "menu-view.h"
+#include "output-view.h"
+#include "tree-view.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+
+
+/** ===============================================================================================
+ *  TYPES
+ */
+
+enum class view_mode
+{
+    menu,
+    output,
+    log
+};
+
+
+/** ===============================================================================================
+ *  CLASS DEFINITION
+ */
+
+class header_pane : public pane
+{
+public:
+    void set_status(std::string status);
+
+protected:
+    void render(window& win, bool full) override;
+
+protected:
+    std::string m_status{};
+};
+
+
+class help_pane : public pane
+{
+protected:
+    void render(window& win, bool full) override;
+};
+
+
+// The large pane on the left: the current menu or text field, or the output or log view.
+class main_pane : public pane
+{
+public:
+    main_pane(menu_manager* menus, const log_file* log) : m_menus{menus}, m_log{log} {}
+
+    void show(view_mode view);
+    [[nodiscard]] view_mode view() const
+    {
+        return m_view;
+    }
+
+    // Switches the menu between its plain list and a table of the entries' metadata.
+    void toggle_table();
+    [[nodiscard]] bool is_table() const
+    {
+        return m_table;
+    }
+
+    // Shows the current menu as a tree whose submenus open in place; false when it is no menu.
+    bool toggle_tree();
+    // The tree while it is shown, nullptr otherwise.
+    [[nodiscard]] menu_tree* tree()
+    {
+        return m_tree.has_value() ? &*m_tree : nullptr;
+    }
+    [[nodiscard]] const menu_tree* tree() const
+    {
+        return m_tree.has_value() ? &*m_tree : nullptr;
+    }
+
+    // Returns false for keys the log view does not use, or when it is not shown.
+    bool handle_log_key(int ch);
+
+    // True while the shown view needs frame ticks to follow its content.
+    [[nodiscard]] bool is_animated() const;
+    [[nodiscard]] bool is_dirty() const override;
+    [[nodiscard]] int  visible_rows() const;
+
+    [[nodiscard]] style_id background() const override
+    {
+        return style_id::menu;
+    }
+
+protected:
+    void render(window& win, bool full) override;
+
+protected:
+    menu_manager*   m_menus = nullptr;
+    const log_file* m_log   = nullptr;
+
+    // Created on the first draw, once the layout gave the pane a window.
+    std::optional<menu_view>   m_menuView{};
+    std::optional<input_view>  m_inputView{};
+    std::optional<output_view> m_outputView{};
+    std::optional<log_view>    m_logView{};
+    std::optional<tree_view>   m_treeView{};
+
+    std::optional<menu_tree> m_tree{};
+
+    view_mode         m_view               = view_mode::menu;
+    view_mode         m_shown              = view_mode::menu;
+    const menu_entry* m_top                = nullptr;
+    std::uint64_t     m_generation         = 0;
+    std::uint64_t     m_packageGeneration  = 0;    //!< package_status set the menu was drawn with.
+    std::uint64_t     m_metadataGeneration = 0;    //!< entry_metadata the menu was drawn with.
+    std::uint64_t     m_reloadGeneration   = 0;    //!< menu_reloader changes drawn.
+    std::uint64_t     m_probeGeneration    = 0;    //!< entry_probes results drawn.
+    bool              m_table              = false;
+    bool              m_treeShown          = false;
+};
+
+
+class details_pane : public pane
+{
+public:
+    // With a main pane, the entry under the cursor of its tree is shown while it has one.
+    details_pane(const menu_manager* menus, const main_pane* view = nullptr) :
+        m_menus{menus}, m_view{view}
+    {
+    }
+
+    [[nodiscard]] bool is_dirty() const override;
+
+protected:
+    void render(window& win, bool full) override;
+
+    [[nodiscard]] const menu_entry* highlighted() const;
+
+protected:
+    const menu_manager* m_menus = nullptr;
+    const main_pane*    m_view  = nullptr;
+
+    const menu_entry* m_entry    = nullptr;
+    bool              m_selected = false;
+    std::size_t       m_size     = 0;
+};
+
+
+class task_pane : public pane
+{
+public:
+    [[nodiscard]] bool is_dirty() const override;
+
+    [[nodiscard]] style_id background() const override
+    {
+        return style_id::menu;
+    }
+
+protected:
+    void render(window& win, bool full) override;
+
+protected:
+    std::optional<output_view> m_view{};
+    std::uint64_t              m_generation = 0;
+};
+
+
+class stats_pane : public pane
+{
+public:
+    [[nodiscard]] bool is_dirty() const override;
+
+protected:
+    void render(window& win, bool full) override;
+
+    struct values
+    {
+        std::uint32_t running   = 0;
+        std::uint32_t done      = 0;
+        std::size_t   actions   = 0;
+        std::size_t   selected  = 0;
+        std::int64_t  memoryKiB = 0;
+
+        bool operator==(const values&) const = default;
+    };
+    [[nodiscard]] static values sample();
+
+protected:
+    values m_shown{};
+};
+
+
+#endif  // DASHBOARD_H
+/**
+ * ------------------------------------------------------------------------------------------------
+ */
@@ -0,0 +1,266 @@
+/**
+ * ===============================================================================================
+ * @file    display-width.cpp
+ * @author  Pascal-Emmanuel Lachance
+ * @p       <a href="https://www.github.com/Raesangur">Raesangur</a>
+ * @p       <a href="https://www.raesangur.com/">https://www.raesangur.com/</a>
+ *
+ * @brief   Terminal column width of UTF-8 strings.
+ *
+ * ------------------------------------------------------------------------------------------------
+ * @copyright Copyright (c) 2023 Pascal-Emmanuel Lachance | Raesangur
+ *
+ * @par License: <a href="https://opensource.org/license/mit/"> MIT </a>
+ *               This project is released under the MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ * BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NON INFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ * ===============================================================================================
+ */
+
+/** ===============================================================================================
+ *  INCLUDES
+ */
+#include "display-width.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <cwchar>
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+
+/** ===============================================================================================
+ *  CONSTANTS
+ */
+
+constexpr char32_t         REPLACEMENT_CHARACTER = 0xFFFD;
+constexpr std::string_view ELLIPSIS              = "...";
+
+
+/** ===============================================================================================
+ *  FUNCTION DEFINITIONS
+ */
+
+[[nodiscard]] std::size_t decode_utf8(std::string_view text, char32_t& codepoint)
+{
+    const auto lead = static_cast<unsigned char>(text[0]);
+
+    // Bounds of the second byte, narrower than 0x80..0xBF after some leads to reject overlong
+    // encodings, surrogates and code points past U+10FFFF (RFC 3629, section 4).
+    unsigned char low  = 0x80;
+    unsigned char high = 0xBF;
+
+    std::size_t length = 0;
+    if (lead < 0x80)
+    {
+        codepoint = lead;
+        return 1;
+    }
+    else if (lead >= 0xC2 && lead <= 0xDF)
+    {
+        length    = 2;
+        codepoint = lead & 0x1Fu;
+    }
+    else if (lead >= 0xE0 && lead <= 0xEF)
+    {
+        length    = 3;
+        codepoint = lead & 0x0Fu;
+        low       = lead == 0xE0 ? 0xA0 : low;
+        high      = lead == 0xED ? 0x9F : high;
+    }
+    else if (lead >= 0xF0 && lead <= 0xF4)
+    {
+        length    = 4;
+        codepoint = lead & 0x07u;
+        low       = lead == 0xF0 ? 0x90 : low;
+        high      = lead == 0xF4 ? 0x8F : high;
+    }
+    else
+    {
+        codepoint = REPLACEMENT_CHARACTER;
+        return 1;
+    }
+
+    if (text.size() < length)
+    {
+        codepoint = REPLACEMENT_CHARACTER;
+        return 1;
+    }
+
+    const auto second = static_cast<unsigned char>(text[1]);
+    if (second < low || second > high)
+    {
+        codepoint = REPLACEMENT_CHARACTER;
+        return 1;
+    }
+
+    for (std::size_t i = 1; i < length; i++)
+    {
+        const auto next = static_cast<unsigned char>(text[i]);
+        if ((next & 0xC0u) != 0x80u)
+        {
+            codepoint = REPLACEMENT_CHARACTER;
+            return 1;
+        }
+        codepoint = (codepoint << 6) | (next & 0x3Fu);
+    }
+
+    return length;
+}
+
+[[nodiscard]] int codepoint_width(char32_t codepoint)
+{
+    int width = ::wcwidth(static_cast<wchar_t>(codepoint));
+
+    // Unprintable characters still take a cell once ncurses renders them.
+    return width < 0 ? 1 : width;
+}
+
+[[nodiscard]] std::size_t ascii_prefix_length(std::string_view text)
+{
+    const char* data  = text.data();
+    std::size_t size  = text.size();
+    std::size_t index = 0;
+
+#if defined(__AVX2__)
+    for (; index + 32 <= size; index += 32)
+    {
+        __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + index));
+        auto    mask  = static_cast<unsigned>(_mm256_movemask_epi8(block));
+        if (mask != 0)
+        {
+            return index + static_cast<std::size_t>(__builtin_ctz(mask));
+        }
+    }
+#endif
+#if defined(__SSE2__)
+    for (; index + 16 <= size; index += 16)
+    {
+        __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + index));
+        auto    mask  = static_cast<unsigned>(_mm_movemask_epi8(block));
+        if (mask != 0)
+        {
+            return index + static_cast<std::size_t>(__builtin_ctz(mask));
+        }
+    }
+#else
+    for (; index + 8 <= size; index += 8)
+    {
+        std::uint64_t word = 0;
+        std::memcpy(&word, data + index, sizeof(word));
+        if ((word & 0x8080808080808080ull) != 0)
+        {
+            break;
+        }
+    }
+#endif
+
+    while (index < size && static_cast<unsigned char>(data[index]) < 0x80)
+    {
+        index++;
+    }
+    return index;
+}
+
+[[nodiscard]] int display_width(std::string_view text)
+{
+    int width = 0;
+
+    while (!text.empty())
+    {
+        std::size_t ascii = ascii_prefix_length(text);
+        width += static_cast<int>(ascii);
+        text.remove_prefix(ascii);
+
+        if (!text.empty())
+        {
+            char32_t codepoint = 0;
+            text.remove_prefix(decode_utf8(text, codepoint));
+            width += codepoint_width(codepoint);
+        }
+    }
+
+    return width;
+}
+
+[[nodiscard]] std::size_t fit_to_width(std::string_view text, int columns)
+{
+    std::size_t length = 0;
+    int         width  = 0;
+
+    while (length < text.size() && width < columns)
+    {
+        std::size_t ascii = ascii_prefix_length(text.substr(length));
+        if (ascii > 0)
+        {
+            std::size_t fitting = std::min(ascii, static_cast<std::size_t>(columns - width));
+            length += fitting;
+            width += static_cast<int>(fitting);
+            continue;
+        }
+
+        char32_t    codepoint = 0;
+        std::size_t size      = decode_utf8(text.substr(length), codepoint);
+        int         cells     = codepoint_width(codepoint);
+        if (width + cells > columns)
+        {
+            break;
+        }
+        length += size;
+        width += cells;
+    }
+
+    // Combining characters following the last fitted character take no room.
+    while (length < text.size() && static_cast<unsigned char>(text[length]) >= 0x80)
+    {
+        char32_t    codepoint = 0;
+        std::size_t size      = decode_utf8(text.substr(length), codepoint);
+        if (codepoint_width(codepoint) != 0)
+        {
+            break;
+        }
+        length += size;
+    }
+
+    return length;
+}
+
+[[nodiscard]] std::string clip_to_width(std::string_view text, int columns)
+{
+    if (columns <= 0)
+    {
+        return {};
+    }
+
+    std::size_t length = fit_to_width(text, columns);
+    if (length == text.size())
+    {
+        return std::string{text};
+    }
+
+    int         room = std::max(columns - static_cast<int>(ELLIPSIS.size()), 0);
+    std::string clipped{text.substr(0, fit_to_width(text, room))};
+    clipped += ELLIPSIS.substr(0, static_cast<std::size_t>(columns - room));
+    return clipped;
+}
+
+
+/**
+ * ------------------------------------------------------------------------------------------------
+ */
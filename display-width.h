@@ -0,0 +1,71 @@
+/**
+ * ===============================================================================================
+ * @file    display-width.h
+ * @author  Pascal-Emmanuel Lachance
+ * @p       <a href="https://www.github.com/Raesangur">Raesangur</a>
+ * @p       <a href="https://www.raesangur.com/">https://www.raesangur.com/</a>
+ *
+ * @brief   Terminal column width of UTF-8 strings.
+ *
+ * ------------------------------------------------------------------------------------------------
+ * @copyright Copyright (c) 2023 Pascal-Emmanuel Lachance | Raesangur
+ *
+ * @par License: <a href="https://opensource.org/license/mit/"> MIT </a>
+ *               This project is released under the MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ * BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NON INFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ * ------------------------------------------------------------------------------------------------
+ * @details
+ * Widths follow wcwidth() for the current locale, so initialize_ncurses() must have called setlocale
+ * for multi-byte characters to be measured. Runs of ASCII are measured without decoding: they are
+ * found 16 (or 32 with AVX2) bytes at a time and count one column per byte.
+ * ===============================================================================================
+ */
+#ifndef DISPLAY_WIDTH_H
+#define DISPLAY_WIDTH_H
+
+
+/** ===============================================================================================
+ *  INCLUDES
+ */
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+
+/** ===============================================================================================
+ *  FUNCTION DECLARATIONS
+ */
+
+// Decodes one UTF-8 sequence from a non-empty string, returning its length in bytes.
+// Malformed input is consumed one byte at a time as U+FFFD.
+[[nodiscard]] std::size_t decode_utf8(std::string_view text, char32_t& codepoint);
+[[nodiscard]] int         codepoint_width(char32_t codepoint);
+
+[[nodiscard]] std::size_t ascii_prefix_length(std::string_view text);
+[[nodiscard]] int         display_width(std::string_view text);
+
+// Length in bytes of the longest prefix of text that fits in the given number of columns.
+[[nodiscard]] std::size_t fit_to_width(std::string_view text, int columns);
+
+// Text clipped to the given number of columns, ending with "..." when something was cut off.
+[[nodiscard]] std::string clip_to_width(std::string_view text, int columns);
+
+
+#endif  // DISPLAY_WIDTH_H
+/**
+ * ------------------------------------------------------------------------------------------------
+ */
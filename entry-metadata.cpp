@@ -0,0 +1,415 @@
+/**
+ * ===============================================================================================
+ * @file    entry-metadata.cpp
+ * @author  Pascal-Emmanuel Lachance
+ * @p       <a href="https://www.github.com/Raesangur">Raesangur</a>
+ * @p       <a href="https://www.raesangur.com/">https://www.raesangur.com/</a>
+ *
+ * @brief   Typed per-entry columns, loaded from side files, and cached sort orders.
+ *
+ * ------------------------------------------------------------------------------------------------
+ * @copyright Copyright (c) 2023 Pascal-Emmanuel Lachance | Raesangur
+ *
+ * @par License: <a href="https://opensource.org/license/mit/"> MIT </a>
+ *               This project is released under the MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ * BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NON INFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ * ===============================================================================================
+ */
+/** ===============================================================================================
+ *  INCLUDES
+ */
+#include "entry-metadata.h"
+
+#include "file-text.h"
+
+#include <algorithm>
+#include <charconv>
+#include <filesystem>
+#include <numeric>
+#include <unordered_map>
+
+
+/** ===============================================================================================
+ *  CONSTANTS
+ */
+
+constexpr char CELL_SEPARATOR = '\t';
+
+constexpr std::string_view SIDE_FILE_EXTENSION = ".meta";
+constexpr std::string_view CHOICE_TYPE         = "choice";
+
+
+/** ===============================================================================================
+ *  LOCAL FUNCTIONS
+ */
+
+// Removes and returns the text up to the next `separator`.
+static std::string_view next_field(std::string_view& str, char separator)
+{
+    std::size_t      end   = str.find(separator);
+    std::string_view field = str.substr(0, end);
+    str.remove_prefix(end == std::string_view::npos ? str.size() : end + 1);
+    return trim(field);
+}
+
+
+/** ===============================================================================================
+ *  METADATA_COLUMN MEMBER FUNCTIONS DEFINITIONS
+ */
+
+metadata_column::metadata_column(std::string_view name, column_type type,
+                                 std::vector<std::string> choices) :
+    m_name{name}, m_type{type}, m_closed{!choices.empty()}
+{
+    for (std::string& choice : choices)
+    {
+        if (m_codesByValue.try_emplace(choice, static_cast<std::uint32_t>(m_values.size() + 1))
+                .second)
+        {
+            m_values.push_back(std::move(choice));
+        }
+    }
+}
+
+
+bool metadata_column::set(std::uint32_t id, std::string_view value)
+{
+    if (value.empty())
+    {
+        return true;
+    }
+
+    if (m_type == column_type::integer)
+    {
+        std::int64_t integer = 0;
+        auto [end, error]    = std::from_chars(value.data(), value.data() + value.size(), integer);
+        if (error != std::errc{} || end != value.data() + value.size() || integer == NO_INTEGER)
+        {
+            return false;
+        }
+
+        if (id >= m_integers.size())
+        {
+            m_integers.resize(id + 1, NO_INTEGER);
+        }
+        m_integers[id] = integer;
+        return true;
+    }
+
+    auto it = m_codesByValue.find(value);
+    if (it == m_codesByValue.end())
+    {
+        if (m_closed)
+        {
+            return false;
+        }
+        m_values.emplace_back(value);
+        it = m_codesByValue.emplace(std::string{value}, static_cast<std::uint32_t>(m_values.size()))
+                 .first;
+    }
+
+    if (id >= m_codes.size())
+    {
+        m_codes.resize(id + 1, 0);
+    }
+    m_codes[id] = it->second;
+    return true;
+}
+
+
+[[nodiscard]] bool metadata_column::has(std::uint32_t id) const
+{
+    if (m_type == column_type::integer)
+    {
+        return id < m_integers.size() && m_integers[id] != NO_INTEGER;
+    }
+    return id < m_codes.size() && m_codes[id] != 0;
+}
+
+[[nodiscard]] std::string metadata_column::format(std::uint32_t id) const
+{
+    if (!has(id))
+    {
+        return {};
+    }
+    return m_type == column_type::integer ? std::to_string(m_integers[id])
+                                          : m_values[m_codes[id] - 1];
+}
+
+[[nodiscard]] bool metadata_column::less(std::uint32_t a, std::uint32_t b) const
+{
+    if (!has(a))
+    {
+        return false;
+    }
+    if (!has(b))
+    {
+        return true;
+    }
+
+    switch (m_type)
+    {
+        case column_type::integer:
+            return m_integers[a] < m_integers[b];
+        case column_type::choice:
+            // Codes follow the declaration order, which is the order a choice sorts in.
+            return m_codes[a] < m_codes[b];
+        default:
+            return m_values[m_codes[a] - 1] < m_values[m_codes[b] - 1];
+    }
+}
+
+
+/** ===============================================================================================
+ *  SINGLETON INSTANCE
+ */
+entry_metadata* entry_metadata::m_instance = nullptr;
+
+
+/** ===============================================================================================
+ *  ENTRY_METADATA MEMBER FUNCTIONS DEFINITIONS
+ */
+
+[[nodiscard]] entry_metadata* entry_metadata::get()
+{
+    if (m_instance == nullptr)
+    {
+        m_instance = new entry_metadata;
+    }
+    return m_instance;
+}
+
+[[nodiscard]] std::string entry_metadata::side_file(std::string_view listFilename)
+{
+    std::filesystem::path path{listFilename};
+    path.replace_extension(SIDE_FILE_EXTENSION);
+    return path.string();
+}
+
+
+std::size_t entry_metadata::load(const std::string& path, std::span<menu_entry* const> entries)
+{
+    std::string text{};
+    read_whole_file(path, text);
+    if (text.empty() || entries.empty())
+    {
+        return 0;
+    }
+
+    std::unordered_map<std::string_view, std::uint32_t> ids{};
+    ids.reserve(entries.size());
+    for (const menu_entry* entry : entries)
+    {
+        ids.emplace(entry->get_name(), entry->id());
+    }
+
+    std::vector<metadata_column*> columns{};
+    bool                          header  = true;
+    std::size_t                   matched = 0;
+
+    std::string_view rest{text};
+    while (!rest.empty())
+    {
+        std::string_view line = next_field(rest, '\n');
+        if (line.empty() || line.front() == '#')
+        {
+            continue;
+        }
+
+        std::string_view name = next_field(line, CELL_SEPARATOR);
+        if (header)
+        {
+            // Columns with an unknown type are skipped along with their cells.
+            while (!line.empty())
+            {
+                columns.push_back(add_column(next_field(line, CELL_SEPARATOR)));
+            }
+            header = false;
+            continue;
+        }
+
+        auto it = ids.find(name);
+        if (it == ids.end())
+        {
+            continue;
+        }
+        for (std::size_t i = 0; i < columns.size() && !line.empty(); i++)
+        {
+            std::string_view value = next_field(line, CELL_SEPARATOR);
+            if (columns[i] != nullptr)
+            {
+                columns[i]->set(it->second, value);
+            }
+        }
+        matched++;
+    }
+
+    m_loads++;
+    m_generation++;
+    return matched;
+}
+
+
+std::string_view entry_metadata::sort_next(menu_top_entry* menu)
+{
+    menu_order& order = m_orders[menu];
+    if (order.original.size() != menu->size())
+    {
+        // Entries were added since the menu was last sorted; the order they are in now becomes the
+        // file order.
+        order = menu_order{{menu->begin(), menu->end()}, m_loads};
+    }
+    if (order.loads != m_loads)
+    {
+        order.loads = m_loads;
+        order.permutations.clear();
+    }
+    order.permutations.resize(FIRST_COLUMN_KEY + m_columns.size());
+
+    // The file order always applies, so this stops at the latest after one full turn.
+    std::size_t key = order.key;
+    do
+    {
+        key = (key + 1) % order.permutations.size();
+    } while (key >= FIRST_COLUMN_KEY && permutation(order, key).empty());
+
+    order.key = key;
+    menu->set_order(order.original, permutation(order, key));
+    m_generation++;
+
+    switch (key)
+    {
+        case FILE_ORDER:
+            return "file order";
+        case BY_NAME:
+            return "name";
+        default:
+            return m_columns[key - FIRST_COLUMN_KEY]->name();
+    }
+}
+
+[[nodiscard]] std::optional<std::size_t> entry_metadata::sorted_column(
+    const menu_top_entry* menu) const
+{
+    auto it = m_orders.find(menu);
+    if (it == m_orders.end() || it->second.key < FIRST_COLUMN_KEY ||
+        it->second.original.size() != menu->size())
+    {
+        return std::nullopt;
+    }
+    return it->second.key - FIRST_COLUMN_KEY;
+}
+
+
+void entry_metadata::forget(const menu_top_entry* menu)
+{
+    if (m_orders.erase(menu) > 0)
+    {
+        m_generation++;
+    }
+}
+
+
+metadata_column* entry_metadata::add_column(std::string_view header)
+{
+    std::string_view name = next_field(header, ':');
+    for (const auto& column : m_columns)
+    {
+        if (column->name() == name)
+        {
+            return column.get();
+        }
+    }
+
+    column_type              type = column_type::text;
+    std::vector<std::string> choices{};
+    if (header == "integer")
+    {
+        type = column_type::integer;
+    }
+    else if (header.starts_with(CHOICE_TYPE))
+    {
+        type = column_type::choice;
+        header.remove_prefix(CHOICE_TYPE.size());
+        if (header.starts_with('(') && header.ends_with(')'))
+        {
+            header = header.substr(1, header.size() - 2);
+            while (!header.empty())
+            {
+                choices.emplace_back(next_field(header, ','));
+            }
+        }
+        else if (!header.empty())
+        {
+            return nullptr;
+        }
+    }
+    else if (!header.empty() && header != "text")
+    {
+        return nullptr;
+    }
+
+    m_columns.push_back(std::make_unique<metadata_column>(name, type, std::move(choices)));
+    return m_columns.back().get();
+}
+
+const std::vector<std::uint32_t>& entry_metadata::permutation(menu_order& order, std::size_t key)
+{
+    std::optional<std::vector<std::uint32_t>>& cached = order.permutations[key];
+    if (cached.has_value())
+    {
+        return *cached;
+    }
+
+    const std::vector<menu_entry*>& entries = order.original;
+    std::vector<std::uint32_t>      indices(entries.size());
+    std::iota(indices.begin(), indices.end(), 0U);
+
+    if (key == BY_NAME)
+    {
+        std::stable_sort(indices.begin(), indices.end(),
+                         [&](std::uint32_t a, std::uint32_t b)
+                         {
+                             return entries[a]->get_name() < entries[b]->get_name();
+                         });
+    }
+    else if (key >= FIRST_COLUMN_KEY)
+    {
+        const metadata_column& column = *m_columns[key - FIRST_COLUMN_KEY];
+        if (std::none_of(entries.begin(), entries.end(),
+                         [&](const menu_entry* entry)
+                         {
+                             return column.has(entry->id());
+                         }))
+        {
+            indices.clear();
+        }
+        std::stable_sort(indices.begin(), indices.end(),
+                         [&](std::uint32_t a, std::uint32_t b)
+                         {
+                             return column.less(entries[a]->id(), entries[b]->id());
+                         });
+    }
+
+    cached = std::move(indices);
+    return *cached;
+}
+
+
+/**
+ * ------------------------------------------------------------------------------------------------
+ */
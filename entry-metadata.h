@@ -0,0 +1,202 @@
+/**
+ * ===============================================================================================
+ * @file    entry-metadata.h
+ * @author  Pascal-Emmanuel Lachance
+ * @p       <a href="https://www.github.com/Raesangur">Raesangur</a>
+ * @p       <a href="https://www.raesangur.com/">https://www.raesangur.com/</a>
+ *
+ * @brief   Typed per-entry columns, loaded from side files, and cached sort orders.
+ *
+ * ------------------------------------------------------------------------------------------------
+ * @copyright Copyright (c) 2023 Pascal-Emmanuel Lachance | Raesangur
+ *
+ * @par License: <a href="https://opensource.org/license/mit/"> MIT </a>
+ *               This project is released under the MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ * BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NON INFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ * ------------------------------------------------------------------------------------------------
+ * @details
+ * Package lists can come with a side file holding more about each package, such as its version or
+ * size. Rather than growing every menu_entry, the values are stored by column: each column is one
+ * dense array indexed by menu_entry::id(), so an entry without metadata costs nothing but an empty
+ * slot. Text values are interned, so that a source repeated over thousands of rows is stored once.
+ *
+ * The side file of `packages/cpp-dev.txt` is `packages/cpp-dev.meta`, a tab-separated table whose
+ * first line names the columns; the first column holds the entry names. Aligned here, the cells are
+separated by a single tab in the file:
+ *
+ *      name    version:integer    section    priority:choice(required,important,optional)
+ *      gcc     12                 devel      required
+ *
+ * A column is `text` unless its header says `:integer` or `:choice`. A choice is an enumeration:
+ * its values sort in the order they were declared in, or first seen in when none were. Lines
+ * starting with `#` are comments, and a cell that does not fit its column's type is left empty.
+ *
+ * Sorting a menu by a column computes the permutation once and keeps it until the metadata changes;
+ * switching keys afterwards only gathers the entries in the cached order.
+ * ===============================================================================================
+ */
+#ifndef ENTRY_METADATA_H
+#define ENTRY_METADATA_H
+
+
+/** ===============================================================================================
+ *  INCLUDES
+ */
+#include "memory-accounting.h"
+#include "menu.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+
+/** ===============================================================================================
+ *  CLASS DEFINITION
+ */
+
+enum class column_type
+{
+    text,
+    integer,
+    choice,
+};
+
+
+class metadata_column
+{
+public:
+    metadata_column(std::string_view name, column_type type, std::vector<std::string> choices = {});
+
+    [[nodiscard]] const std::string& name() const
+    {
+        return m_name;
+    }
+    [[nodiscard]] column_type type() const
+    {
+        return m_type;
+    }
+
+    // Returns false, leaving the cell as it was, when `value` does not fit the column's type.
+    bool set(std::uint32_t id, std::string_view value);
+
+    [[nodiscard]] bool has(std::uint32_t id) const;
+    // Empty when the entry has no value.
+    [[nodiscard]] std::string format(std::uint32_t id) const;
+    // Orders by value, with the entries that have none last.
+    [[nodiscard]] bool less(std::uint32_t a, std::uint32_t b) const;
+
+protected:
+    template<typename T>
+    using column_vector = std::vector<T, tracking_allocator<T, memory_category::entry_metadata>>;
+
+    static constexpr std::int64_t NO_INTEGER = INT64_MIN;
+
+    std::string m_name;
+    column_type m_type;
+    bool        m_closed = false;    //!< A choice whose values were all declared.
+
+    // Text and choice cells hold 1 + the index of their value, or 0; integer cells hold the value.
+    column_vector<std::uint32_t> m_codes{};
+    column_vector<std::int64_t>  m_integers{};
+
+    column_vector<std::string>                        m_values{};
+    std::map<std::string, std::uint32_t, std::less<>> m_codesByValue{};
+};
+
+
+class entry_metadata
+{
+protected:
+    entry_metadata() = default;
+
+public:
+    entry_metadata(const entry_metadata&)  = delete;
+    entry_metadata(const entry_metadata&&) = delete;
+    void operator=(const entry_metadata&)  = delete;
+
+    [[nodiscard]] static entry_metadata* get();
+
+    // `packages/cpp-dev.txt` is described by `packages/cpp-dev.meta`.
+    [[nodiscard]] static std::string side_file(std::string_view listFilename);
+
+    // Fills the columns for the rows of `path` naming one of `entries`, and returns how many did. A
+    // missing side file is not an error: most lists have none.
+    std::size_t load(const std::string& path, std::span<menu_entry* const> entries);
+
+    [[nodiscard]] std::size_t column_count() const
+    {
+        return m_columns.size();
+    }
+    [[nodiscard]] const metadata_column& column(std::size_t index) const
+    {
+        return *m_columns[index];
+    }
+
+    // Bumped when values are loaded or a menu is reordered, both of which change what is drawn.
+    [[nodiscard]] std::uint64_t generation() const
+    {
+        return m_generation;
+    }
+
+    // Reorders `menu` by its next sort key, skipping the columns none of its entries have, and
+    // returns the key's name. The keys are the file order, the name, then each column.
+    std::string_view sort_next(menu_top_entry* menu);
+    // The column `menu` is sorted by, if it is sorted by one.
+    [[nodiscard]] std::optional<std::size_t> sorted_column(const menu_top_entry* menu) const;
+    // Drops what is known of `menu`'s order after entries were inserted or removed; the order it
+    // is in counts as its file order from then on.
+    void forget(const menu_top_entry* menu);
+
+protected:
+    static constexpr std::size_t FILE_ORDER       = 0;
+    static constexpr std::size_t BY_NAME          = 1;
+    static constexpr std::size_t FIRST_COLUMN_KEY = 2;
+
+    struct menu_order
+    {
+        std::vector<menu_entry*> original{};    //!< The entries in the order they were added.
+        std::uint64_t            loads = 0;     //!< m_loads the column permutations were made with.
+        std::size_t              key   = FILE_ORDER;
+
+        // Indices into `original`, by key; an empty permutation means the key does not apply.
+        std::vector<std::optional<std::vector<std::uint32_t>>> permutations{};
+    };
+
+    metadata_column* add_column(std::string_view header);
+    const std::vector<std::uint32_t>& permutation(menu_order& order, std::size_t key);
+
+protected:
+    static entry_metadata* m_instance;
+
+    std::vector<std::unique_ptr<metadata_column>> m_columns{};
+
+    std::map<const menu_top_entry*, menu_order> m_orders{};
+    std::uint64_t                               m_loads      = 0;
+    std::uint64_t                               m_generation = 0;
+};
+
+
+#endif  // ENTRY_METADATA_H
+/**
+ * ------------------------------------------------------------------------------------------------
+ */
@@ -0,0 +1,204 @@
+/**
+ * ===============================================================================================
+ * @file    entry-probes.cpp
+ * @author  Pascal-Emmanuel Lachance
+ * @p       <a href="https://www.github.com/Raesangur">Raesangur</a>
+ * @p       <a href="https://www.raesangur.com/">https://www.raesangur.com/</a>
+ *
+ * @brief   Status probes run on demand for the menu rows on screen.
+ *
+ * ------------------------------------------------------------------------------------------------
+ * @copyright Copyright (c) 2023 Pascal-Emmanuel Lachance | Raesangur
+ *
+ * @par License: <a href="https://opensource.org/license/mit/"> MIT </a>
+ *               This project is released under the MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ * BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NON INFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ * ===============================================================================================
+ */
+/** ===============================================================================================
+ *  INCLUDES
+ */
+#include "entry-probes.h"
+
+#include "action.h"
+
+#include <algorithm>
+
+
+/** ===============================================================================================
+ *  SINGLETON INSTANCE
+ */
+entry_probes* entry_probes::m_instance = nullptr;
+
+
+/** ===============================================================================================
+ *  MEMBER FUNCTIONS DEFINITIONS
+ */
+
+[[nodiscard]] entry_probes* entry_probes::get()
+{
+    if (m_instance == nullptr)
+    {
+        m_instance = new entry_probes;
+    }
+    return m_instance;
+}
+
+
+void entry_probes::attach(const menu_entry* entry, probe_function probe, clock::duration ttl)
+{
+    std::lock_guard lock{m_mutex};
+
+    probe_state& state   = m_probes[entry->id()];
+    bool         running = state.running;
+    state                = probe_state{std::move(probe), ttl};
+
+    // A run in progress finishes into the new state; it is only counted once.
+    state.running = running;
+    m_empty.store(false, std::memory_order_release);
+}
+
+
+void entry_probes::request(std::span<const menu_entry* const> visible)
+{
+    if (m_empty.load(std::memory_order_acquire))
+    {
+        return;
+    }
+
+    std::lock_guard   lock{m_mutex};
+    clock::time_point now = clock::now();
+
+    m_visible.clear();
+    m_waiting.clear();
+    for (auto it = visible.rbegin(); it != visible.rend(); ++it)
+    {
+        auto state = m_probes.find((*it)->id());
+        if (state == m_probes.end())
+        {
+            continue;
+        }
+
+        m_visible.push_back(state->first);
+        if (!state->second.running && is_stale(state->second, now))
+        {
+            m_waiting.push_back(state->first);
+        }
+    }
+    std::sort(m_visible.begin(), m_visible.end());
+
+    pump();
+}
+
+[[nodiscard]] bool entry_probes::due() const
+{
+    if (m_empty.load(std::memory_order_acquire))
+    {
+        return false;
+    }
+
+    std::lock_guard   lock{m_mutex};
+    clock::time_point now = clock::now();
+    for (std::uint32_t id : m_visible)
+    {
+        const probe_state& state = m_probes.at(id);
+        if (!state.running && is_stale(state, now) &&
+            std::find(m_waiting.begin(), m_waiting.end(), id) == m_waiting.end())
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+
+[[nodiscard]] std::string entry_probes::status(const menu_entry* entry) const
+{
+    if (m_empty.load(std::memory_order_acquire))
+    {
+        return {};
+    }
+
+    std::lock_guard lock{m_mutex};
+    auto            state = m_probes.find(entry->id());
+    return state == m_probes.end() ? std::string{} : state->second.status;
+}
+
+
+[[nodiscard]] bool entry_probes::is_stale(const probe_state& state, clock::time_point now) const
+{
+    return !state.known || now - state.checked >= state.ttl;
+}
+
+[[nodiscard]] bool entry_probes::is_visible(std::uint32_t id) const
+{
+    return std::binary_search(m_visible.begin(), m_visible.end(), id);
+}
+
+
+void entry_probes::pump()
+{
+    while (m_running < MAX_RUNNING_PROBES && !m_waiting.empty())
+    {
+        std::uint32_t id = m_waiting.back();
+        m_waiting.pop_back();
+
+        m_probes.at(id).running = true;
+        m_running++;
+        event_loop::get()->submit([this, id] { run(id); });
+    }
+}
+
+void entry_probes::run(std::uint32_t id)
+{
+    probe_function probe{};
+    {
+        std::lock_guard lock{m_mutex};
+        probe_state&    state = m_probes.at(id);
+
+        // Scrolled out of view while it waited for a pool thread.
+        if (!is_visible(id))
+        {
+            state.running = false;
+            m_running--;
+            pump();
+            return;
+        }
+        probe = state.probe;
+    }
+
+    std::string status = probe();
+
+    std::lock_guard lock{m_mutex};
+    probe_state&    state = m_probes.at(id);
+    state.running         = false;
+    state.checked         = clock::now();
+    m_running--;
+
+    if (!state.known || status != state.status)
+    {
+        state.status = std::move(status);
+        m_generation.fetch_add(1, std::memory_order_release);
+    }
+    state.known = true;
+    pump();
+}
+
+
+/**
+ * ------------------------------------------------------------------------------------------------
+ */
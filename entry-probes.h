@@ -0,0 +1,151 @@
+/**
+ * ===============================================================================================
+ * @file    entry-probes.h
+ * @author  Pascal-Emmanuel Lachance
+ * @p       <a href="https://www.github.com/Raesangur">Raesangur</a>
+ * @p       <a href="https://www.raesangur.com/">https://www.raesangur.com/</a>
+ *
+ * @brief   Status probes run on demand for the menu rows on screen.
+ *
+ * ------------------------------------------------------------------------------------------------
+ * @copyright Copyright (c) 2023 Pascal-Emmanuel Lachance | Raesangur
+ *
+ * @par License: <a href="https://opensource.org/license/mit/"> MIT </a>
+ *               This project is released under the MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ * BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NON INFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ * ------------------------------------------------------------------------------------------------
+ * @details
+ * Some entries show a computed status, such as whether an ssh key exists yet. A probe is a
+ * function returning that status as short text; it may block, so it runs on the event_loop's
+ * thread pool, and only when its row is on screen: menu_view hands the visible entries to
+ * request() every time it draws, and nothing is computed for the rest of the menu.
+ *
+ * Results are cached for the probe's time to live. A visible probe whose result expired reports
+ * itself through due(), which makes the menu pane draw, and thus request it, again.
+ *
+ * The work stays bounded however fast the menu scrolls. At most MAX_RUNNING_PROBES probes are
+ * handed to the pool at a time; the others wait in a list that request() replaces with the rows
+ * currently on screen, so a row scrolled out of view is dropped before it ever runs. A probe that
+ * was handed to the pool but has not started yet checks that its row is still visible and is
+ * skipped if not. A probe already running is not interrupted, but its result is still kept.
+ * ===============================================================================================
+ */
+#ifndef ENTRY_PROBES_H
+#define ENTRY_PROBES_H
+
+
+/** ===============================================================================================
+ *  INCLUDES
+ */
+#include "menu.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <span>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+
+/** ===============================================================================================
+ *  CONSTANTS
+ */
+
+constexpr std::size_t               MAX_RUNNING_PROBES = 4;
+constexpr std::chrono::milliseconds DEFAULT_PROBE_TTL{10'000};
+
+
+/** ===============================================================================================
+ *  CLASS DEFINITION
+ */
+
+// Runs on a pool thread; returns the entry's status, or an empty string when there is none to show.
+using probe_function = std::function<std::string()>;
+
+
+class entry_probes
+{
+protected:
+    entry_probes() = default;
+
+public:
+    using clock = std::chrono::steady_clock;
+
+    entry_probes(const entry_probes&)  = delete;
+    entry_probes(const entry_probes&&) = delete;
+    void operator=(const entry_probes&) = delete;
+
+    [[nodiscard]] static entry_probes* get();
+
+    // Gives `entry` a probe, replacing any previous one and its cached result.
+    void attach(const menu_entry* entry, probe_function probe,
+                clock::duration ttl = DEFAULT_PROBE_TTL);
+
+    // The entries on screen, top to bottom: starts their probes when stale and drops the others'.
+    void request(std::span<const menu_entry* const> visible);
+    // Whether a probe on screen has a result past its time to live.
+    [[nodiscard]] bool due() const;
+
+    // The last result, empty when there is none yet.
+    [[nodiscard]] std::string status(const menu_entry* entry) const;
+
+    // Changes every time a shown status changes.
+    [[nodiscard]] std::uint64_t generation() const
+    {
+        return m_generation.load(std::memory_order_acquire);
+    }
+
+protected:
+    struct probe_state
+    {
+        probe_function    probe{};
+        clock::duration   ttl{};
+        std::string       status{};
+        clock::time_point checked{};
+        bool              known   = false;
+        bool              running = false;    //!< Handed to the pool and not finished yet.
+    };
+
+    [[nodiscard]] bool is_stale(const probe_state& state, clock::time_point now) const;
+    [[nodiscard]] bool is_visible(std::uint32_t id) const;
+
+    // With m_mutex held: hands waiting probes to the pool while there is room.
+    void pump();
+    void run(std::uint32_t id);
+
+protected:
+    static entry_probes* m_instance;
+
+    mutable std::mutex                             m_mutex{};
+    std::unordered_map<std::uint32_t, probe_state> m_probes{};
+    std::vector<std::uint32_t>                     m_visible{};    //!< Sorted ids with a probe.
+    std::vector<std::uint32_t>                     m_waiting{};    //!< In row order, last first.
+    std::size_t                                    m_running = 0;
+
+    std::atomic<bool>          m_empty{true};    //!< Lets menus without probes skip the lock.
+    std::atomic<std::uint64_t> m_generation{0};
+};
+
+
+#endif  // ENTRY_PROBES_H
+/**
+ * ------------------------------------------------------------------------------------------------
+ */
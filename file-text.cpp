@@ -0,0 +1,102 @@
+/**
+ * ===============================================================================================
+ * @file    file-text.cpp
+ * @author  Pascal-Emmanuel Lachance
+ * @p       <a href="https://www.github.com/Raesangur">Raesangur</a>
+ * @p       <a href="https://www.raesangur.com/">https://www.raesangur.com/</a>
+ *
+ * @brief   Reads whole text files and trims the lines read from them.
+ *
+ * ------------------------------------------------------------------------------------------------
+ * @copyright Copyright (c) 2023 Pascal-Emmanuel Lachance | Raesangur
+ *
+ * @par License: <a href="https://opensource.org/license/mit/"> MIT </a>
+ *               This project is released under the MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ * BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NON INFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ * ===============================================================================================
+ */
+/** ===============================================================================================
+ *  INCLUDES
+ */
+#include "file-text.h"
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+
+/** ===============================================================================================
+ *  CONSTANTS
+ */
+
+constexpr std::string_view BLANKS = " \t\r";
+
+
+/** ===============================================================================================
+ *  FUNCTION DEFINITIONS
+ */
+
+bool read_whole_file(const std::string& path, std::string& content)
+{
+    content.clear();
+
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+    {
+        return false;
+    }
+
+    struct stat info{};
+    if (::fstat(fd, &info) == 0 && info.st_size > 0)
+    {
+        content.reserve(static_cast<std::size_t>(info.st_size));
+    }
+
+    // A signal interrupting a read must not cut the file short.
+    std::array<char, 64 * 1024> buffer{};
+    ssize_t                     count = 0;
+    while ((count = ::read(fd, buffer.data(), buffer.size())) != 0)
+    {
+        if (count < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            break;
+        }
+        content.append(buffer.data(), static_cast<std::size_t>(count));
+    }
+    ::close(fd);
+
+    return count == 0;
+}
+
+[[nodiscard]] std::string_view trim(std::string_view str)
+{
+    str.remove_prefix(std::min(str.find_first_not_of(BLANKS), str.size()));
+    str.remove_suffix(str.size() - std::min(str.find_last_not_of(BLANKS) + 1, str.size()));
+    return str;
+}
+
+
+/**
+ * ------------------------------------------------------------------------------------------------
+ */
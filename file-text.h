@@ -0,0 +1,58 @@
+/**
+ * ===============================================================================================
+ * @file    file-text.h
+ * @author  Pascal-Emmanuel Lachance
+ * @p       <a href="https://www.github.com/Raesangur">Raesangur</a>
+ * @p       <a href="https://www.raesangur.com/">https://www.raesangur.com/</a>
+ *
+ * @brief   Reads whole text files and trims the lines read from them.
+ *
+ * ------------------------------------------------------------------------------------------------
+ * @copyright Copyright (c) 2023 Pascal-Emmanuel Lachance | Raesangur
+ *
+ * @par License: <a href="https://opensource.org/license/mit/"> MIT </a>
+ *               This project is released under the MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ * BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NON INFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ * ===============================================================================================
+ */
+#ifndef FILE_TEXT_H
+#define FILE_TEXT_H
+
+
+/** ===============================================================================================
+ *  INCLUDES
+ */
+#include <string>
+#include <string_view>
+
+
+/** ===============================================================================================
+ *  FUNCTION DECLARATIONS
+ */
+
+// Replaces `content` with the whole of `path`; false when it cannot be opened or read to the end,
+// in which case `content` holds what was read, if anything.
+bool read_whole_file(const std::string& path, std::string& content);
+
+// `str` without its leading and trailing spaces, tabs and carriage returns.
+[[nodiscard]] std::string_view trim(std::string_view str);
+
+
+#endif  // FILE_TEXT_H
+/**
+ * ------------------------------------------------------------------------------------------------
+ */
@@ -0,0 +1,145 @@
+/**
+ * ===============================================================================================
+ * @file    file-watcher.cpp
+ * @author  Pascal-Emmanuel Lachance
+ * @p       <a href="https://www.github.com/Raesangur">Raesangur</a>
+ * @p       <a href="https://www.raesangur.com/">https://www.raesangur.com/</a>
+ *
+ * @brief   Follows files through inotify watches on their directories.
+ *
+ * ------------------------------------------------------------------------------------------------
+ * @copyright Copyright (c) 2023 Pascal-Emmanuel Lachance | Raesangur
+ *
+ * @par License: <a href="https://opensource.org/license/mit/"> MIT </a>
+ *               This project is released under the MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ * BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NON INFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ * ===============================================================================================
+ */
+/** ===============================================================================================
+ *  INCLUDES
+ */
+#include "file-watcher.h"
+
+#include <array>
+#include <cstdint>
+#include <filesystem>
+#include <sys/inotify.h>
+#include <unistd.h>
+
+
+/** ===============================================================================================
+ *  CONSTANTS
+ */
+
+constexpr std::uint32_t WATCHED_EVENTS = IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE | IN_DELETE;
+
+
+/** ===============================================================================================
+ *  MEMBER FUNCTIONS DEFINITIONS
+ */
+
+file_watcher::~file_watcher()
+{
+    if (m_fd >= 0)
+    {
+        ::close(m_fd);
+    }
+}
+
+
+bool file_watcher::add(std::string_view path)
+{
+    std::filesystem::path file{path};
+    std::string           directory = file.has_parent_path() ? file.parent_path().string() : ".";
+
+    std::lock_guard lock{m_mutex};
+    if (m_fd < 0)
+    {
+        m_fd = ::inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        if (m_fd < 0)
+        {
+            return false;
+        }
+    }
+
+    // Watching a directory again returns the watch it already has.
+    int watch = ::inotify_add_watch(m_fd, directory.c_str(), WATCHED_EVENTS);
+    if (watch < 0)
+    {
+        return false;
+    }
+    m_names[watch].emplace(file.filename().string(), std::string{path});
+    return true;
+}
+
+action file_watcher::changes(std::set<std::string>& changed)
+{
+    while (changed.empty())
+    {
+        co_await readable(m_fd);
+        drain(changed);
+    }
+
+    co_await sleep_for{m_settleDelay};
+    drain(changed);
+}
+
+
+void file_watcher::drain(std::set<std::string>& changed)
+{
+    alignas(inotify_event) std::array<char, 4096> buffer{};
+
+    ssize_t count = 0;
+    while ((count = ::read(m_fd, buffer.data(), buffer.size())) > 0)
+    {
+        std::lock_guard lock{m_mutex};
+        for (ssize_t offset = 0; offset < count;)
+        {
+            const auto* event = reinterpret_cast<const inotify_event*>(buffer.data() + offset);
+            offset += static_cast<ssize_t>(sizeof(inotify_event) + event->len);
+
+            // Events were lost: any file may have changed.
+            if ((event->mask & IN_Q_OVERFLOW) != 0)
+            {
+                for (const auto& [watch, names] : m_names)
+                {
+                    for (const auto& [name, path] : names)
+                    {
+                        changed.insert(path);
+                    }
+                }
+                continue;
+            }
+
+            auto directory = m_names.find(event->wd);
+            if (event->len == 0 || directory == m_names.end())
+            {
+                continue;
+            }
+            auto name = directory->second.find(event->name);
+            if (name != directory->second.end())
+            {
+                changed.insert(name->second);
+            }
+        }
+    }
+}
+
+
+/**
+ * ------------------------------------------------------------------------------------------------
+ */
@@ -0,0 +1,96 @@
+/**
+ * ===============================================================================================
+ * @file    file-watcher.h
+ * @author  Pascal-Emmanuel Lachance
+ * @p       <a href="https://www.github.com/Raesangur">Raesangur</a>
+ * @p       <a href="https://www.raesangur.com/">https://www.raesangur.com/</a>
+ *
+ * @brief   Follows files through inotify watches on their directories.
+ *
+ * ------------------------------------------------------------------------------------------------
+ * @copyright Copyright (c) 2023 Pascal-Emmanuel Lachance | Raesangur
+ *
+ * @par License: <a href="https://opensource.org/license/mit/"> MIT </a>
+ *               This project is released under the MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ * BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NON INFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ * ------------------------------------------------------------------------------------------------
+ * @details
+ * Package managers and editors often replace a file rather than write it in place, through a
+ * temporary file renamed over it, so the directory of each followed file is watched instead of the
+ * file itself, and events are matched against the file's name.
+ *
+ * Files are added from any thread. Changes are awaited from an action on the event loop, and only
+ * reported once the directory has stayed quiet for a settle delay, so that a burst of writes is
+ * read once.
+ * ===============================================================================================
+ */
+#ifndef FILE_WATCHER_H
+#define FILE_WATCHER_H
+
+
+/** ===============================================================================================
+ *  INCLUDES
+ */
+#include "action.h"
+
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <set>
+#include <string>
+#include <string_view>
+
+
+/** ===============================================================================================
+ *  CLASS DEFINITION
+ */
+
+class file_watcher
+{
+public:
+    explicit file_watcher(std::chrono::milliseconds settleDelay) : m_settleDelay{settleDelay} {}
+    ~file_watcher();
+
+    file_watcher(const file_watcher&)   = delete;
+    void operator=(const file_watcher&) = delete;
+
+    // Starts following `path`; false when its directory cannot be watched.
+    bool add(std::string_view path);
+
+    // Waits until followed files changed and stayed quiet for the settle delay, then adds their
+    // paths, as given to add(), to `changed`. From one action on the event loop at a time.
+    action changes(std::set<std::string>& changed);
+
+protected:
+    // Reads every pending event and adds the followed files they are about to `changed`.
+    void drain(std::set<std::string>& changed);
+
+protected:
+    std::chrono::milliseconds m_settleDelay;
+
+    // m_names maps a directory's watch to the names of the files followed in it, and those to the
+    // paths they were added with.
+    std::mutex                                         m_mutex{};
+    int                                                m_fd = -1;
+    std::map<int, std::map<std::string, std::string>> m_names{};
+};
+
+
+#endif  // FILE_WATCHER_H
+/**
+ * ------------------------------------------------------------------------------------------------
+ */
@@ -0,0 +1,197 @@
+/**
+ * ===============================================================================================
+ * @file    gap-buffer.cpp
+ * @author  Pascal-Emmanuel Lachance
+ * @p       <a href="https://www.github.com/Raesangur">Raesangur</a>
+ * @p       <a href="https://www.raesangur.com/">https://www.raesangur.com/</a>
+ *
+ * @brief   Text buffer with a movable gap at the cursor, for editable fields.
+ *
+ * ------------------------------------------------------------------------------------------------
+ * @copyright Copyright (c) 2023 Pascal-Emmanuel Lachance | Raesangur
+ *
+ * @par License: <a href="https://opensource.org/license/mit/"> MIT </a>
+ *               This project is released under the MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ * BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NON INFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ * ===============================================================================================
+ */
+
+/** ===============================================================================================
+ *  INCLUDES
+ */
+#include "gap-buffer.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+
+
+/** ===============================================================================================
+ *  LOCAL FUNCTIONS
+ */
+
+static bool is_continuation(char byte)
+{
+    return (static_cast<unsigned char>(byte) & 0xC0) == 0x80;
+}
+
+
+/** ===============================================================================================
+ *  MEMBER FUNCTIONS DEFINITIONS
+ */
+
+void gap_buffer::insert(std::string_view text)
+{
+    reserve_gap(text.size());
+    std::copy(text.begin(), text.end(), m_buffer.begin() + static_cast<std::ptrdiff_t>(m_gapBegin));
+    m_gapBegin += text.size();
+}
+
+bool gap_buffer::erase_before()
+{
+    if (m_gapBegin == 0)
+    {
+        return false;
+    }
+
+    do
+    {
+        m_gapBegin--;
+    } while (m_gapBegin > 0 && is_continuation(m_buffer[m_gapBegin]));
+    return true;
+}
+
+bool gap_buffer::erase_after()
+{
+    if (m_gapEnd == m_buffer.size())
+    {
+        return false;
+    }
+
+    do
+    {
+        m_gapEnd++;
+    } while (m_gapEnd < m_buffer.size() && is_continuation(m_buffer[m_gapEnd]));
+    return true;
+}
+
+void gap_buffer::clear()
+{
+    m_gapBegin = 0;
+    m_gapEnd   = m_buffer.size();
+}
+
+
+bool gap_buffer::move_left()
+{
+    if (m_gapBegin == 0)
+    {
+        return false;
+    }
+
+    std::size_t position = m_gapBegin - 1;
+    while (position > 0 && is_continuation(m_buffer[position]))
+    {
+        position--;
+    }
+    move_gap(position);
+    return true;
+}
+
+bool gap_buffer::move_right()
+{
+    if (m_gapEnd == m_buffer.size())
+    {
+        return false;
+    }
+
+    std::size_t position = m_gapEnd + 1;
+    while (position < m_buffer.size() && is_continuation(m_buffer[position]))
+    {
+        position++;
+    }
+    move_gap(m_gapBegin + (position - m_gapEnd));
+    return true;
+}
+
+void gap_buffer::move_home()
+{
+    move_gap(0);
+}
+
+void gap_buffer::move_end()
+{
+    move_gap(size());
+}
+
+
+[[nodiscard]] std::string gap_buffer::text() const
+{
+    std::string text{};
+    text.reserve(size());
+    text.append(before());
+    text.append(after());
+    return text;
+}
+
+
+void gap_buffer::reserve_gap(std::size_t bytes)
+{
+    if (gap() >= bytes)
+    {
+        return;
+    }
+
+    // Grow geometrically so that typing stays amortized constant time.
+    std::size_t tail     = m_buffer.size() - m_gapEnd;
+    std::size_t capacity = std::max({m_buffer.size() * 2, size() + bytes + MIN_GAP, MIN_GAP});
+
+    std::vector<char> grown(capacity);
+    std::copy(m_buffer.begin(),
+              m_buffer.begin() + static_cast<std::ptrdiff_t>(m_gapBegin),
+              grown.begin());
+    std::copy(m_buffer.begin() + static_cast<std::ptrdiff_t>(m_gapEnd),
+              m_buffer.end(),
+              grown.end() - static_cast<std::ptrdiff_t>(tail));
+
+    m_buffer.swap(grown);
+    m_gapEnd = capacity - tail;
+}
+
+void gap_buffer::move_gap(std::size_t position)
+{
+    if (position < m_gapBegin)
+    {
+        // The bytes between the new and the old cursor move to just after the gap.
+        std::size_t count = m_gapBegin - position;
+        std::memmove(m_buffer.data() + m_gapEnd - count, m_buffer.data() + position, count);
+        m_gapBegin -= count;
+        m_gapEnd -= count;
+    }
+    else if (position > m_gapBegin)
+    {
+        std::size_t count = position - m_gapBegin;
+        std::memmove(m_buffer.data() + m_gapBegin, m_buffer.data() + m_gapEnd, count);
+        m_gapBegin += count;
+        m_gapEnd += count;
+    }
+}
+
+
+/**
+ * ------------------------------------------------------------------------------------------------
+ */
@@ -0,0 +1,122 @@
+/**
+ * ===============================================================================================
+ * @file    gap-buffer.h
+ * @author  Pascal-Emmanuel Lachance
+ * @p       <a href="https://www.github.com/Raesangur">Raesangur</a>
+ * @p       <a href="https://www.raesangur.com/">https://www.raesangur.com/</a>
+ *
+ * @brief   Text buffer with a movable gap at the cursor, for editable fields.
+ *
+ * ------------------------------------------------------------------------------------------------
+ * @copyright Copyright (c) 2023 Pascal-Emmanuel Lachance | Raesangur
+ *
+ * @par License: <a href="https://opensource.org/license/mit/"> MIT </a>
+ *               This project is released under the MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ * BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NON INFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ * ------------------------------------------------------------------------------------------------
+ * @details
+ * The text lives in one array with a hole at the cursor: typing fills the hole, deleting widens it,
+ * and moving the cursor moves the bytes between the old and the new position across it. Edits at
+ * the cursor are therefore constant time whatever the length of the text, and a large insert only
+ * grows the array once.
+ *
+ * The cursor always sits on a UTF-8 code point boundary: moves and deletions step over whole
+ * sequences, and callers are expected to insert complete ones.
+ * ===============================================================================================
+ */
+#ifndef GAP_BUFFER_H
+#define GAP_BUFFER_H
+
+
+/** ===============================================================================================
+ *  INCLUDES
+ */
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+
+
+/** ===============================================================================================
+ *  CLASS DEFINITION
+ */
+
+class gap_buffer
+{
+public:
+    gap_buffer() = default;
+
+    void insert(std::string_view text);
+    // Remove the code point before or after the cursor; false when there is none.
+    bool erase_before();
+    bool erase_after();
+    void clear();
+
+    // Move the cursor by one code point; false when it is already at that end.
+    bool move_left();
+    bool move_right();
+    void move_home();
+    void move_end();
+
+    [[nodiscard]] std::size_t size() const
+    {
+        return m_buffer.size() - gap();
+    }
+    [[nodiscard]] bool empty() const
+    {
+        return size() == 0;
+    }
+    // Byte offset of the cursor in the text.
+    [[nodiscard]] std::size_t cursor() const
+    {
+        return m_gapBegin;
+    }
+
+    // The text on either side of the cursor, valid until the next modification.
+    [[nodiscard]] std::string_view before() const
+    {
+        return std::string_view{m_buffer.data(), m_gapBegin};
+    }
+    [[nodiscard]] std::string_view after() const
+    {
+        return std::string_view{m_buffer.data() + m_gapEnd, m_buffer.size() - m_gapEnd};
+    }
+
+    [[nodiscard]] std::string text() const;
+
+protected:
+    [[nodiscard]] std::size_t gap() const
+    {
+        return m_gapEnd - m_gapBegin;
+    }
+
+    void reserve_gap(std::size_t bytes);
+    void move_gap(std::size_t position);
+
+protected:
+    static constexpr std::size_t MIN_GAP = 64;
+
+    std::vector<char> m_buffer{};
+    std::size_t       m_gapBegin = 0;
+    std::size_t       m_gapEnd   = 0;
+};
+
+
+#endif  // GAP_BUFFER_H
+/**
+ * ------------------------------------------------------------------------------------------------
+ */
@@ -0,0 +1,208 @@
+/**
+ * ===============================================================================================
+ * @file    input-view.cpp
+ * @author  Pascal-Emmanuel Lachance
+ * @p       <a href="https://www.github.com/Raesangur">Raesangur</a>
+ * @p       <a href="https://www.raesangur.com/">https://www.raesangur.com/</a>
+ *
+ * @brief   Editor for a menu_input_entry, redrawing only the cells that changed.
+ *
+ * ------------------------------------------------------------------------------------------------
+ * @copyright Copyright (c) 2023 Pascal-Emmanuel Lachance | Raesangur
+ *
+ * @par License: <a href="https://opensource.org/license/mit/"> MIT </a>
+ *               This project is released under the MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ * BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NON INFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ * ===============================================================================================
+ */
+
+/** ===============================================================================================
+ *  INCLUDES
+ */
+#include "input-view.h"
+
+#include "display-width.h"
+#include "theme.h"
+
+#include <algorithm>
+#include <string_view>
+
+
+/** ===============================================================================================
+ *  MEMBER FUNCTIONS DEFINITIONS
+ */
+
+void input_view::render(const menu_input_entry* entry)
+{
+    if (m_valid && entry == m_entry && entry->generation() == m_generation)
+    {
+        return;
+    }
+
+    if (!m_valid || entry != m_entry)
+    {
+        m_win.set_style(theme::get()->get(style_id::menu));
+        m_win.erase();
+        m_win.box();
+        m_win.print(0, clip_to_width(entry->get_name(), m_win.width() - 2));
+        m_win.print(HINT_ROW,
+                    clip_to_width("Press 'ENTER' or 'ESC' to go back.", m_win.width() - 2));
+
+        m_scroll = 0;
+        m_cells.clear();
+    }
+    m_entry      = entry;
+    m_generation = entry->generation();
+    m_valid      = true;
+
+    const gap_buffer& buffer  = entry->buffer();
+    const int         columns = std::max(0, m_win.width() - 2 * FIRST_COL);
+    scroll_to_cursor(buffer, columns);
+
+    std::vector<field_cell> cells(static_cast<std::size_t>(columns), field_cell{" ", false});
+    int                     col = 0;
+    auto                    place = [&](std::string_view text)
+    {
+        while (!text.empty() && col < columns)
+        {
+            char32_t         codepoint = 0;
+            std::string_view bytes     = text.substr(0, decode_utf8(text, codepoint));
+            text.remove_prefix(bytes.size());
+
+            int width = codepoint_width(codepoint);
+            if (width <= 0)
+            {
+                continue;
+            }
+            if (col + width > columns)
+            {
+                break;
+            }
+
+            cells[static_cast<std::size_t>(col)] = field_cell{std::string{bytes}, false};
+            if (width == 2)
+            {
+                cells[static_cast<std::size_t>(col) + 1] = field_cell{"", false};
+            }
+            col += width;
+        }
+    };
+
+    place(buffer.before().substr(m_scroll));
+    const int cursorCol = col;
+    place(buffer.after());
+
+    // The cursor covers both halves of a double-width character.
+    for (int x = cursorCol; x < std::min(cursorCol + 2, columns); x++)
+    {
+        field_cell& cell = cells[static_cast<std::size_t>(x)];
+        cell.cursor      = cell.cursor || x == cursorCol || cell.text.empty();
+    }
+
+    draw_changes(cells);
+    m_cells.swap(cells);
+    m_win.set_style(theme::get()->get(style_id::menu));
+}
+
+void input_view::invalidate()
+{
+    m_valid = false;
+}
+
+
+void input_view::scroll_to_cursor(const gap_buffer& buffer, int columns)
+{
+    std::string_view before = buffer.before();
+    if (m_scroll >= before.size())
+    {
+        // The cursor moved left of the field, or the text under it was erased.
+        m_scroll = before.size();
+        return;
+    }
+
+    // One column is kept for the cursor itself, past the last character.
+    std::string_view shown = before.substr(m_scroll);
+    if (fit_to_width(shown, columns - 1) == shown.size())
+    {
+        return;
+    }
+
+    // Walk back from the cursor until the field is full, whatever the length of the text.
+    std::size_t start = before.size();
+    int         width = 0;
+    while (start > 0)
+    {
+        std::size_t previous = start - 1;
+        while (previous > 0 && (static_cast<unsigned char>(before[previous]) & 0xC0) == 0x80)
+        {
+            previous--;
+        }
+
+        char32_t codepoint = 0;
+        (void)decode_utf8(before.substr(previous), codepoint);
+        int charWidth = std::max(codepoint_width(codepoint), 0);
+        if (width + charWidth > columns - 1)
+        {
+            break;
+        }
+        width += charWidth;
+        start = previous;
+    }
+    m_scroll = start;
+}
+
+void input_view::draw_changes(const std::vector<field_cell>& cells)
+{
+    const int columns = static_cast<int>(cells.size());
+    auto      same    = [&](int x)
+    {
+        auto i = static_cast<std::size_t>(x);
+        return i < m_cells.size() && cells[i] == m_cells[i];
+    };
+
+    int x = 0;
+    while (x < columns)
+    {
+        if (same(x))
+        {
+            x++;
+            continue;
+        }
+
+        // A changed second half is redrawn from the character it belongs to.
+        int  start  = cells[static_cast<std::size_t>(x)].text.empty() && x > 0 ? x - 1 : x;
+        bool cursor = cells[static_cast<std::size_t>(start)].cursor;
+
+        std::string run{};
+        int         end = start;
+        while (end < columns && (end <= x || !same(end)) &&
+               cells[static_cast<std::size_t>(end)].cursor == cursor)
+        {
+            run += cells[static_cast<std::size_t>(end)].text;
+            end++;
+        }
+
+        m_win.set_style(theme::get()->get(cursor ? style_id::highlight : style_id::menu));
+        m_win.print(FIELD_ROW, FIRST_COL + start, run);
+        x = end;
+    }
+}
+
+
+/**
+ * ------------------------------------------------------------------------------------------------
+ */
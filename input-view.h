@@ -0,0 +1,93 @@
+/**
+ * ===============================================================================================
+ * @file    input-view.h
+ * @author  Pascal-Emmanuel Lachance
+ * @p       <a href="https://www.github.com/Raesangur">Raesangur</a>
+ * @p       <a href="https://www.raesangur.com/">https://www.raesangur.com/</a>
+ *
+ * @brief   Editor for a menu_input_entry, redrawing only the cells that changed.
+ *
+ * ------------------------------------------------------------------------------------------------
+ * @copyright Copyright (c) 2023 Pascal-Emmanuel Lachance | Raesangur
+ *
+ * @par License: <a href="https://opensource.org/license/mit/"> MIT </a>
+ *               This project is released under the MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ * BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NON INFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ * ===============================================================================================
+ */
+#ifndef INPUT_VIEW_H
+#define INPUT_VIEW_H
+
+
+/** ===============================================================================================
+ *  INCLUDES
+ */
+#include "menu.h"
+#include "window.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+
+/** ===============================================================================================
+ *  CLASS DEFINITION
+ */
+
+class input_view
+{
+public:
+    input_view(window& win) : m_win{win} {}
+
+    // Draws the frame when the entry changes; after that only the field cells that differ from
+    // the previous frame are sent, scrolled sideways so that the cursor stays visible.
+    void render(const menu_input_entry* entry);
+    void invalidate();
+
+protected:
+    struct field_cell
+    {
+        std::string text{};    //!< Empty on the second column of a double-width character.
+        bool        cursor = false;
+
+        bool operator==(const field_cell&) const = default;
+    };
+
+    void scroll_to_cursor(const gap_buffer& buffer, int columns);
+    void draw_changes(const std::vector<field_cell>& cells);
+
+protected:
+    static constexpr int FIELD_ROW = 2;
+    static constexpr int HINT_ROW  = 4;
+    static constexpr int FIRST_COL = 2;
+
+    window& m_win;
+
+    const menu_input_entry* m_entry      = nullptr;
+    std::uint64_t           m_generation = 0;
+    bool                    m_valid      = false;
+
+    std::size_t             m_scroll = 0;    //!< Byte offset of the first character shown.
+    std::vector<field_cell> m_cells{};
+};
+
+
+#endif  // INPUT_VIEW_H
+/**
+ * ------------------------------------------------------------------------------------------------
+ */
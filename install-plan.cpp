@@ -0,0 +1,215 @@
+/**
+ * ===============================================================================================
+ * @file    install-plan.cpp
+ * @author  Pascal-Emmanuel Lachance
+ * @p       <a href="https://www.github.com/Raesangur">Raesangur</a>
+ * @p       <a href="https://www.raesangur.com/">https://www.raesangur.com/</a>
+ *
+ * @brief   Groups selected package entries into batched installer runs.
+ *
+ * ------------------------------------------------------------------------------------------------
+ * @copyright Copyright (c) 2023 Pascal-Emmanuel Lachance | Raesangur
+ *
+ * @par License: <a href="https://opensource.org/license/mit/"> MIT </a>
+ *               This project is released under the MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ * BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NON INFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ * ===============================================================================================
+ */
+/** ===============================================================================================
+ *  INCLUDES
+ */
+#include "install-plan.h"
+
+#include "menu.h"
+#include "task-runner.h"
+
+#include <algorithm>
+#include <unordered_set>
+
+
+/** ===============================================================================================
+ *  CONSTANTS
+ */
+
+constexpr std::string_view DEFAULT_INSTALLER = "apt";
+
+// Well under the kernel's 128 KiB limit on a single argument, which `sh -c` commands are.
+constexpr std::size_t MAX_COMMAND_BYTES = 64 * 1024;
+
+
+/** ===============================================================================================
+ *  SINGLETON INSTANCE
+ */
+install_planner* install_planner::m_instance = nullptr;
+
+
+/** ===============================================================================================
+ *  MEMBER FUNCTIONS DEFINITIONS
+ */
+
+install_planner::install_planner()
+{
+    set_installer("apt", "sudo apt-get install -y");
+    set_installer("dnf", "sudo dnf install -y");
+    set_installer("pacman", "sudo pacman -S --needed --noconfirm");
+    set_installer("pip", "python3 -m pip install --user");
+}
+
+[[nodiscard]] install_planner* install_planner::get()
+{
+    if (m_instance == nullptr)
+    {
+        m_instance = new install_planner;
+    }
+    return m_instance;
+}
+
+
+void install_planner::set_installer(std::string_view name, std::string_view command)
+{
+    std::lock_guard lock{m_mutex};
+    m_installers.insert_or_assign(std::string{name}, std::string{command});
+}
+
+bool install_planner::set_installer(std::string_view spec)
+{
+    std::size_t equal = spec.find('=');
+    if (equal == 0 || equal == std::string_view::npos || equal + 1 == spec.size())
+    {
+        return false;
+    }
+
+    set_installer(spec.substr(0, equal), spec.substr(equal + 1));
+    return true;
+}
+
+[[nodiscard]] bool install_planner::has_installer(std::string_view name) const
+{
+    std::lock_guard lock{m_mutex};
+    return m_installers.find(name) != m_installers.end();
+}
+
+
+[[nodiscard]] package_list* install_planner::list(std::string_view filename)
+{
+    std::lock_guard lock{m_mutex};
+    return find_list(filename);
+}
+
+bool install_planner::set_list_installer(std::string_view filename, std::string_view installer)
+{
+    std::lock_guard lock{m_mutex};
+    if (m_installers.find(installer) == m_installers.end())
+    {
+        return false;
+    }
+
+    find_list(filename)->installer = installer;
+    return true;
+}
+
+void install_planner::add_package(package_list* list, menu_option_entry* entry)
+{
+    entry->mark_package();
+
+    std::lock_guard lock{m_mutex};
+    list->packages.push_back(entry);
+}
+
+void install_planner::remove_packages(package_list*                                list,
+                                      const std::vector<const menu_option_entry*>& gone)
+{
+    std::lock_guard lock{m_mutex};
+    std::erase_if(list->packages,
+                  [&](const menu_option_entry* entry)
+                  {
+                      return std::binary_search(gone.begin(), gone.end(), entry);
+                  });
+}
+
+
+[[nodiscard]] package_list* install_planner::find_list(std::string_view filename)
+{
+    // There are only ever a handful of lists.
+    for (package_list& list : m_lists)
+    {
+        if (list.filename == filename)
+        {
+            return &list;
+        }
+    }
+
+    return &m_lists.emplace_back(
+      package_list{std::string{filename}, std::string{DEFAULT_INSTALLER}, {}});
+}
+
+
+[[nodiscard]] install_plan install_planner::plan(const selection_set& selection) const
+{
+    std::lock_guard lock{m_mutex};
+
+    install_plan plan{};
+
+    std::unordered_set<const menu_option_entry*> planned{};
+    std::map<std::string_view, std::size_t>      openBatches{};    //!< Installer to batch index.
+    for (const package_list& list : m_lists)
+    {
+        for (const menu_option_entry* entry : list.packages)
+        {
+            if (!selection.test(entry->id()))
+            {
+                continue;
+            }
+            // An entry's name is unique in the menu, so a repeated package is the same entry.
+            if (!planned.insert(entry).second)
+            {
+                plan.duplicates++;
+                continue;
+            }
+
+            std::string quoted = shell_quote(entry->get_name());
+            std::string package;
+            package.reserve(quoted.size() + 1);
+            package.append(1, ' ').append(quoted);
+
+            auto it = openBatches.find(list.installer);
+            if (it == openBatches.end() ||
+                plan.batches[it->second].command.size() + package.size() > MAX_COMMAND_BYTES)
+            {
+                plan.batches.push_back(
+                  install_batch{list.installer, m_installers.find(list.installer)->second});
+                it = openBatches.insert_or_assign(list.installer, plan.batches.size() - 1).first;
+            }
+
+            install_batch& batch = plan.batches[it->second];
+            batch.command += package;
+            batch.packages.push_back(entry);
+            if (batch.lists.empty() || batch.lists.back() != &list)
+            {
+                batch.lists.push_back(&list);
+            }
+            plan.packages++;
+        }
+    }
+
+    return plan;
+}
+
+
+/**
+ * ------------------------------------------------------------------------------------------------
+ */
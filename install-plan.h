@@ -0,0 +1,141 @@
+/**
+ * ===============================================================================================
+ * @file    install-plan.h
+ * @author  Pascal-Emmanuel Lachance
+ * @p       <a href="https://www.github.com/Raesangur">Raesangur</a>
+ * @p       <a href="https://www.raesangur.com/">https://www.raesangur.com/</a>
+ *
+ * @brief   Groups selected package entries into batched installer runs.
+ *
+ * ------------------------------------------------------------------------------------------------
+ * @copyright Copyright (c) 2023 Pascal-Emmanuel Lachance | Raesangur
+ *
+ * @par License: <a href="https://opensource.org/license/mit/"> MIT </a>
+ *               This project is released under the MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ * BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NON INFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ * ------------------------------------------------------------------------------------------------
+ * @details
+ * Every option read from a package list file, by `file` entries or submenu_manager::add_file(), is
+ * one package, installed by the installer the list names ("apt" unless told otherwise). Running
+ * the package manager once per package pays its lock and metadata loading every time, so
+ * install_planner::plan() instead walks the lists in the order they were loaded and puts every
+ * selected package in one batch per installer, whichever list it came from. A package listed more
+ * than once, in one list or in several, is only installed once, by the first list holding it.
+ *
+ * A batch is a single `/bin/sh -c` command, which the kernel limits to MAX_ARG_STRLEN bytes, so a
+ * batch whose command would grow past MAX_COMMAND_BYTES is continued in a new one.
+ *
+ * Runs plan from a selection snapshot, on the thread pool, while the input thread may still be
+ * adding packages to the lists or removing them on a reload; the planner's lock orders the two.
+ *
+ * Installers are command prefixes to which the quoted package names are appended. They can be
+ * replaced from the command line, such as `--installer apt=echo` to try a plan without installing.
+ * ===============================================================================================
+ */
+#ifndef INSTALL_PLAN_H
+#define INSTALL_PLAN_H
+
+
+/** ===============================================================================================
+ *  INCLUDES
+ */
+#include "selection-set.h"
+
+#include <cstddef>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+
+/** ===============================================================================================
+ *  CLASS DEFINITION
+ */
+
+class menu_option_entry;
+
+struct package_list
+{
+    std::string                     filename{};
+    std::string                     installer{};
+    std::vector<menu_option_entry*> packages{};    //!< In file order.
+};
+
+
+struct install_batch
+{
+    std::string                           installer{};
+    std::string                           command{};
+    std::vector<const package_list*>      lists{};    //!< Lists contributing to the batch.
+    std::vector<const menu_option_entry*> packages{};
+};
+
+struct install_plan
+{
+    std::vector<install_batch> batches{};
+    std::size_t                packages   = 0;    //!< Distinct packages to install.
+    std::size_t                duplicates = 0;    //!< Selected entries skipped as already planned.
+};
+
+
+class install_planner
+{
+protected:
+    install_planner();
+
+public:
+    install_planner(const install_planner&)  = delete;
+    install_planner(const install_planner&&) = delete;
+    void operator=(const install_planner&)   = delete;
+
+    [[nodiscard]] static install_planner* get();
+
+    // Adds or replaces an installer; `command` is run with the package names appended.
+    void set_installer(std::string_view name, std::string_view command);
+    // Same, from a `<name>=<command>` command line argument.
+    bool set_installer(std::string_view spec);
+    [[nodiscard]] bool has_installer(std::string_view name) const;
+
+    // The list read from `filename`, created with the default installer on first use.
+    [[nodiscard]] package_list* list(std::string_view filename);
+    bool set_list_installer(std::string_view filename, std::string_view installer);
+    void add_package(package_list* list, menu_option_entry* entry);
+    // Drops the packages in `gone`, which is sorted, from `list`.
+    void remove_packages(package_list* list, const std::vector<const menu_option_entry*>& gone);
+
+    // Plans the packages in `selection`, a snapshot taken with menu_option_entry::selection() when
+    // the run started, so that later edits do not change what it installs. Safe from any thread.
+    [[nodiscard]] install_plan plan(const selection_set& selection) const;
+
+protected:
+    [[nodiscard]] package_list* find_list(std::string_view filename);
+
+protected:
+    static install_planner* m_instance;
+
+    mutable std::mutex                              m_mutex{};    //!< Guards what follows.
+    std::map<std::string, std::string, std::less<>> m_installers{};
+    std::deque<package_list>                         m_lists{};    //!< A deque keeps them in place.
+};
+
+
+#endif  // INSTALL_PLAN_H
+/**
+ * ------------------------------------------------------------------------------------------------
+ */
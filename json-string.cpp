@@ -0,0 +1,106 @@
+/**
+ * ===============================================================================================
+ * @file    json-string.cpp
+ * @author  Pascal-Emmanuel Lachance
+ * @p       <a href="https://www.github.com/Raesangur">Raesangur</a>
+ * @p       <a href="https://www.raesangur.com/">https://www.raesangur.com/</a>
+ *
+ * @brief   Escapes text into JSON strings.
+ *
+ * ------------------------------------------------------------------------------------------------
+ * @copyright Copyright (c) 2023 Pascal-Emmanuel Lachance | Raesangur
+ *
+ * @par License: <a href="https://opensource.org/license/mit/"> MIT </a>
+ *               This project is released under the MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ * BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NON INFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ * ===============================================================================================
+ */
+/** ===============================================================================================
+ *  INCLUDES
+ */
+#include "json-string.h"
+
+#include "display-width.h"
+
+#include <cstdio>
+
+
+/** ===============================================================================================
+ *  FUNCTION DEFINITIONS
+ */
+
+void append_json_string(std::string& out, std::string_view text)
+{
+    out.reserve(out.size() + text.size() + 2);
+    out += '"';
+    for (std::size_t i = 0; i < text.size();)
+    {
+        char c = text[i];
+        if (static_cast<unsigned char>(c) >= 0x80)
+        {
+            char32_t    codepoint = 0;
+            std::size_t length    = decode_utf8(text.substr(i), codepoint);
+            out += length == 1 ? std::string_view{"\\ufffd"} : text.substr(i, length);
+            i += length;
+            continue;
+        }
+
+        i++;
+        switch (c)
+        {
+            case '"':
+                out += "\\\"";
+                break;
+            case '\\':
+                out += "\\\\";
+                break;
+            case '\n':
+                out += "\\n";
+                break;
+            case '\t':
+                out += "\\t";
+                break;
+            case '\r':
+                out += "\\r";
+                break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20)
+                {
+                    char escape[8];
+                    std::snprintf(escape, sizeof(escape), "\\u%04x", static_cast<unsigned>(c));
+                    out += escape;
+                }
+                else
+                {
+                    out += c;
+                }
+        }
+    }
+    out += '"';
+}
+
+[[nodiscard]] std::string json_string(std::string_view text)
+{
+    std::string quoted{};
+    append_json_string(quoted, text);
+    return quoted;
+}
+
+
+/**
+ * ------------------------------------------------------------------------------------------------
+ */
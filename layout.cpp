@@ -0,0 +1,227 @@
+/**
+ * ===============================================================================================
+ * @file    layout.cpp
+ * @author  Pascal-Emmanuel Lachance
+ * @p       <a href="https://www.github.com/Raesangur">Raesangur</a>
+ * @p       <a href="https://www.raesangur.com/">https://www.raesangur.com/</a>
+ *
+ * @brief   Split-pane layout tree that only redraws the panes that changed.
+ *
+ * ------------------------------------------------------------------------------------------------
+ * @copyright Copyright (c) 2023 Pascal-Emmanuel Lachance | Raesangur
+ *
+ * @par License: <a href="https://opensource.org/license/mit/"> MIT </a>
+ *               This project is released under the MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ * BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NON INFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ * ===============================================================================================
+ */
+
+/** ===============================================================================================
+ *  INCLUDES
+ */
+#include "layout.h"
+
+#include <algorithm>
+#include <cstddef>
+
+
+/** ===============================================================================================
+ *  MEMBER FUNCTIONS DEFINITIONS
+ */
+
+layout_node::layout_node(pane* content, size_constraint constraint) :
+    m_constraint{constraint}, m_pane{content}
+{
+}
+
+
+void layout_node::place(int y, int x, int h, int w)
+{
+    if (h <= 0 || w <= 0)
+    {
+        return hide();
+    }
+    m_shown = true;
+
+    if (m_pane != nullptr)
+    {
+        if (m_window == nullptr)
+        {
+            m_window = std::make_unique<window>(h, w, y, x);
+        }
+        else
+        {
+            m_window->reshape(h, w, y, x);
+        }
+        m_fresh = true;
+        return;
+    }
+
+    const bool        rows   = m_split == split::rows;
+    const int         length = rows ? h : w;
+    const std::size_t count  = m_children.size();
+
+    std::vector<int>  sizes(count, 0);
+    std::vector<bool> hidden(count, false);
+    while (true)
+    {
+        // Fixed children are served first, in order, then the flexible ones split what is left.
+        int remaining = length;
+        int weights   = 0;
+        for (std::size_t i = 0; i < count; i++)
+        {
+            const size_constraint& c = m_children[i].m_constraint;
+            if (hidden[i])
+            {
+                sizes[i] = 0;
+            }
+            else if (c.fixed > 0)
+            {
+                sizes[i] = std::min(c.fixed, remaining);
+                remaining -= sizes[i];
+            }
+            else
+            {
+                weights += c.weight;
+            }
+        }
+
+        for (std::size_t i = 0; i < count; i++)
+        {
+            const size_constraint& c = m_children[i].m_constraint;
+            if (hidden[i] || c.fixed > 0 || weights == 0)
+            {
+                continue;
+            }
+            // Sharing what is left each time hands the rounding remainder to the last child.
+            sizes[i] = remaining * c.weight / weights;
+            remaining -= sizes[i];
+            weights -= c.weight;
+        }
+
+        // The last child that does not fit is given up first; its space goes back to the others.
+        std::size_t squeezed = count;
+        for (std::size_t i = 0; i < count; i++)
+        {
+            if (!hidden[i] && sizes[i] < m_children[i].m_constraint.min)
+            {
+                squeezed = i;
+            }
+        }
+        if (squeezed == count)
+        {
+            break;
+        }
+        hidden[squeezed] = true;
+    }
+
+    int offset = 0;
+    for (std::size_t i = 0; i < count; i++)
+    {
+        if (hidden[i])
+        {
+            m_children[i].hide();
+            continue;
+        }
+
+        if (rows)
+        {
+            m_children[i].place(y + offset, x, sizes[i], w);
+        }
+        else
+        {
+            m_children[i].place(y, x + offset, h, sizes[i]);
+        }
+        offset += sizes[i];
+    }
+}
+
+void layout_node::hide()
+{
+    m_shown = false;
+    for (layout_node& child : m_children)
+    {
+        child.hide();
+    }
+}
+
+void layout_node::render()
+{
+    if (!m_shown)
+    {
+        return;
+    }
+
+    if (m_pane == nullptr)
+    {
+        for (layout_node& child : m_children)
+        {
+            child.render();
+        }
+    }
+    else if (m_fresh)
+    {
+        m_window->set_background(theme::get()->get(m_pane->background()));
+        m_window->erase();
+        m_pane->draw(*m_window, true);
+        m_fresh = false;
+    }
+    else if (m_pane->is_dirty())
+    {
+        m_pane->draw(*m_window, false);
+    }
+}
+
+
+[[nodiscard]] const layout_node* layout_node::find(const pane* content) const
+{
+    if (m_pane != nullptr && m_pane == content)
+    {
+        return this;
+    }
+
+    for (const layout_node& child : m_children)
+    {
+        if (const layout_node* node = child.find(content); node != nullptr)
+        {
+            return node;
+        }
+    }
+    return nullptr;
+}
+
+
+void layout::resize(int rows, int cols)
+{
+    m_root.place(0, 0, rows, cols);
+}
+
+void layout::render()
+{
+    m_root.render();
+}
+
+[[nodiscard]] bool layout::is_shown(const pane* content) const
+{
+    const layout_node* node = m_root.find(content);
+    return node != nullptr && node->m_shown;
+}
+
+
+/**
+ * ------------------------------------------------------------------------------------------------
+ */
@@ -0,0 +1,172 @@
+/**
+ * ===============================================================================================
+ * @file    layout.h
+ * @author  Pascal-Emmanuel Lachance
+ * @p       <a href="https://www.github.com/Raesangur">Raesangur</a>
+ * @p       <a href="https://www.raesangur.com/">https://www.raesangur.com/</a>
+ *
+ * @brief   Split-pane layout tree that only redraws the panes that changed.
+ *
+ * ------------------------------------------------------------------------------------------------
+ * @copyright Copyright (c) 2023 Pascal-Emmanuel Lachance | Raesangur
+ *
+ * @par License: <a href="https://opensource.org/license/mit/"> MIT </a>
+ *               This project is released under the MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ * BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NON INFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ * ------------------------------------------------------------------------------------------------
+ * @details
+ * The screen is described once as a tree of nested splits. Each leaf owns a window and a pane, the
+ * object that draws into it; each node carries a size constraint along its parent's axis:
+ *  - `fixed`   an exact number of rows or columns, taken before anything else;
+ *  - `weight`  a share of what the fixed siblings leave over;
+ *  - `min`     below this the node is hidden instead of squeezed, and its space is given back.
+ *
+ * Geometry is only computed by resize(), at start-up and when the terminal changes size; windows
+ * are moved rather than recreated. render() asks every visible pane whether it is dirty and only
+ * draws those, so a frame where nothing changed touches no window at all and a keystroke only
+ * costs the panes it affected.
+ * ===============================================================================================
+ */
+#ifndef LAYOUT_H
+#define LAYOUT_H
+
+
+/** ===============================================================================================
+ *  INCLUDES
+ */
+#include "theme.h"
+#include "window.h"
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+
+/** ===============================================================================================
+ *  TYPES
+ */
+
+struct size_constraint
+{
+    int fixed  = 0;    //!< Exact size along the parent's axis, 0 to share the remaining space.
+    int min    = 1;    //!< Smallest size the node can be shown at.
+    int weight = 1;    //!< Share of the space left by fixed siblings.
+};
+
+
+/** ===============================================================================================
+ *  CLASS DEFINITION
+ */
+
+class pane
+{
+public:
+    virtual ~pane() = default;
+
+    // Draws the pane; `full` is set when the window was just placed and holds nothing yet.
+    void draw(window& win, bool full)
+    {
+        m_dirty = false;
+        render(win, full);
+    }
+
+    void mark_dirty()
+    {
+        m_dirty = true;
+    }
+
+    // Polled every frame; panes whose content comes from elsewhere compare it here.
+    [[nodiscard]] virtual bool is_dirty() const
+    {
+        return m_dirty;
+    }
+
+    [[nodiscard]] virtual style_id background() const
+    {
+        return style_id::background;
+    }
+
+protected:
+    virtual void render(window& win, bool full) = 0;
+
+protected:
+    bool m_dirty = true;
+};
+
+
+class layout_node
+{
+public:
+    enum class split
+    {
+        rows,       //!< Children are stacked from top to bottom.
+        columns     //!< Children are placed side by side from left to right.
+    };
+
+    layout_node(pane* content, size_constraint constraint = {});
+
+    // Leaves own their window, so children are moved in rather than taken from an initializer list.
+    template<typename... nodes>
+    layout_node(split direction, size_constraint constraint, nodes... children) :
+        m_constraint{constraint}, m_split{direction}
+    {
+        m_children.reserve(sizeof...(children));
+        (m_children.push_back(std::move(children)), ...);
+    }
+
+protected:
+    friend class layout;
+
+    void place(int y, int x, int h, int w);
+    void hide();
+    void render();
+
+    [[nodiscard]] const layout_node* find(const pane* content) const;
+
+protected:
+    size_constraint m_constraint{};
+
+    pane*                   m_pane = nullptr;
+    std::unique_ptr<window> m_window{};
+    bool                    m_shown = false;
+    bool                    m_fresh = false;    //!< Placed since the pane last drew.
+
+    split                    m_split = split::rows;
+    std::vector<layout_node> m_children{};
+};
+
+
+class layout
+{
+public:
+    layout(layout_node root) : m_root{std::move(root)} {}
+
+    // Recomputes the geometry of every node; panes that moved redraw in full on the next render.
+    void resize(int rows, int cols);
+    void render();
+
+    [[nodiscard]] bool is_shown(const pane* content) const;
+
+protected:
+    layout_node m_root;
+};
+
+
+#endif  // LAYOUT_H
+/**
+ * ------------------------------------------------------------------------------------------------
+ */
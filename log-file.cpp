@@ -0,0 +1,497 @@
+/**
+ * ===============================================================================================
+ * @file    log-file.cpp
+ * @author  Pascal-Emmanuel Lachance
+ * @p       <a href="https://www.github.com/Raesangur">Raesangur</a>
+ * @p       <a href="https://www.raesangur.com/">https://www.raesangur.com/</a>
+ *
+ * @brief   Memory-mapped text file with an incremental, sparse line index.
+ *
+ * ------------------------------------------------------------------------------------------------
+ * @copyright Copyright (c) 2023 Pascal-Emmanuel Lachance | Raesangur
+ *
+ * @par License: <a href="https://opensource.org/license/mit/"> MIT </a>
+ *               This project is released under the MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ * BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NON INFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ * ===============================================================================================
+ */
+/** ===============================================================================================
+ *  INCLUDES
+ */
+#include "log-file.h"
+
+#include <algorithm>
+#include <chrono>
+#include <csetjmp>
+#include <csignal>
+#include <cstring>
+#include <fcntl.h>
+#include <mutex>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+
+/** ===============================================================================================
+ *  CONSTANTS
+ */
+
+constexpr std::uint64_t MIN_MAPPING  = 64 * 1024 * 1024;
+constexpr std::uint64_t INDEX_CHUNK  = 8 * 1024 * 1024;     //!< Bytes scanned between publications.
+constexpr std::uint64_t SEARCH_CHUNK = 1024 * 1024;
+
+constexpr auto FOLLOW_POLL = std::chrono::milliseconds{100};
+
+
+/** ===============================================================================================
+ *  LOCAL FUNCTIONS
+ */
+
+// Reading a page of the mapping that the file no longer covers raises SIGBUS. The handler returns
+// to the read that faulted, if it is one, which then gives up instead of killing the process.
+static thread_local sigjmp_buf* t_mappedRead = nullptr;
+
+static void on_bus_error(int signal)
+{
+    if (t_mappedRead != nullptr)
+    {
+        siglongjmp(*t_mappedRead, 1);
+    }
+
+    // Any other fault ends the process as it would have without the handler.
+    std::signal(signal, SIG_DFL);
+    std::raise(signal);
+}
+
+static void install_bus_handler()
+{
+    static std::once_flag once{};
+    std::call_once(once,
+                   []
+                   {
+                       struct sigaction action{};
+                       action.sa_handler = on_bus_error;
+                       sigemptyset(&action.sa_mask);
+                       ::sigaction(SIGBUS, &action, nullptr);
+                   });
+}
+
+// Runs `read` over the mapping and returns false if the file shrank under it. Jumping out of
+// `read` skips destructors, so it must not own anything.
+template<typename F>
+static bool mapped_read(F&& read)
+{
+    sigjmp_buf* outer = t_mappedRead;
+    sigjmp_buf  jump;
+    if (sigsetjmp(jump, 1) != 0)
+    {
+        t_mappedRead = outer;
+        return false;
+    }
+
+    t_mappedRead = &jump;
+    read();
+    t_mappedRead = outer;
+    return true;
+}
+
+
+struct newline_scan
+{
+    std::uint64_t              newlines      = 0;
+    std::uint64_t              lastLineStart = 0;
+    std::vector<std::uint64_t> checkpoints{};
+
+    void add_mask(std::uint64_t offset, unsigned mask)
+    {
+        auto count = static_cast<std::uint64_t>(__builtin_popcount(mask));
+        if (newlines % log_file::LINE_STRIDE + count < log_file::LINE_STRIDE)
+        {
+            // The common case: no checkpoint in this block, so only the count matters.
+            newlines += count;
+            lastLineStart = offset + static_cast<std::uint64_t>(31 - __builtin_clz(mask)) + 1;
+            return;
+        }
+
+        for (; mask != 0; mask &= mask - 1)
+        {
+            add(offset + static_cast<std::uint64_t>(__builtin_ctz(mask)));
+        }
+    }
+
+    void add(std::uint64_t newline)
+    {
+        newlines++;
+        lastLineStart = newline + 1;
+        if (newlines % log_file::LINE_STRIDE == 0)
+        {
+            checkpoints.push_back(lastLineStart);
+        }
+    }
+
+    void scan(const char* data, std::uint64_t begin, std::uint64_t end)
+    {
+        std::uint64_t offset = begin;
+
+#if defined(__AVX2__)
+        const __m256i newline32 = _mm256_set1_epi8('\n');
+        for (; offset + 32 <= end; offset += 32)
+        {
+            __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + offset));
+            auto    mask  = static_cast<unsigned>(
+                _mm256_movemask_epi8(_mm256_cmpeq_epi8(block, newline32)));
+            if (mask != 0)
+            {
+                add_mask(offset, mask);
+            }
+        }
+#endif
+#if defined(__SSE2__)
+        const __m128i newline16 = _mm_set1_epi8('\n');
+        for (; offset + 16 <= end; offset += 16)
+        {
+            __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + offset));
+            auto    mask  = static_cast<unsigned>(
+                _mm_movemask_epi8(_mm_cmpeq_epi8(block, newline16)));
+            if (mask != 0)
+            {
+                add_mask(offset, mask);
+            }
+        }
+#endif
+
+        for (; offset < end; offset++)
+        {
+            if (data[offset] == '\n')
+            {
+                add(offset);
+            }
+        }
+    }
+};
+
+
+/** ===============================================================================================
+ *  MEMBER FUNCTIONS DEFINITIONS
+ */
+
+log_file::~log_file()
+{
+    close();
+}
+
+
+bool log_file::open(const std::string& filename, bool follow)
+{
+    close();
+
+    m_fd = ::open(filename.c_str(), O_RDONLY | O_CLOEXEC);
+    if (m_fd < 0)
+    {
+        return false;
+    }
+    install_bus_handler();
+
+    struct stat info{};
+    if (::fstat(m_fd, &info) != 0 || !remap(static_cast<std::uint64_t>(info.st_size)))
+    {
+        ::close(m_fd);
+        m_fd = -1;
+        return false;
+    }
+
+    m_filename = filename;
+    m_follow   = follow;
+    m_checkpoints.assign(1, 0);
+    m_newlines      = 0;
+    m_lastLineStart = 0;
+    m_size.store(static_cast<std::uint64_t>(info.st_size), std::memory_order_release);
+    m_indexedBytes.store(0, std::memory_order_release);
+
+    m_stopping.store(false);
+    m_thread = std::thread{&log_file::index_loop, this};
+    return true;
+}
+
+void log_file::close()
+{
+    if (m_thread.joinable())
+    {
+        m_stopping.store(true);
+        m_thread.join();
+    }
+
+    if (m_data != nullptr)
+    {
+        ::munmap(const_cast<char*>(m_data), m_capacity);
+        m_data     = nullptr;
+        m_capacity = 0;
+    }
+    if (m_fd >= 0)
+    {
+        ::close(m_fd);
+        m_fd = -1;
+    }
+}
+
+
+[[nodiscard]] std::uint64_t log_file::line_count() const
+{
+    std::shared_lock lock{m_mutex};
+    return m_newlines + (indexed_bytes() > m_lastLineStart ? 1 : 0);
+}
+
+[[nodiscard]] std::string log_file::line(std::uint64_t index, std::size_t maxBytes) const
+{
+    std::shared_lock lock{m_mutex};
+    if (index >= m_newlines + (indexed_bytes() > m_lastLineStart ? 1 : 0) || is_stale())
+    {
+        return {};
+    }
+
+    std::uint64_t indexed = indexed_bytes();
+    std::uint64_t begin   = 0;
+    std::uint64_t end     = indexed;
+    if (!mapped_read(
+          [&]
+          {
+              begin = line_offset(index);
+              if (const void* newline = std::memchr(m_data + begin, '\n', indexed - begin))
+              {
+                  end = static_cast<std::uint64_t>(static_cast<const char*>(newline) - m_data);
+              }
+          }))
+    {
+        return {};
+    }
+
+    std::string text(std::min<std::size_t>(end - begin, maxBytes), '\0');
+    if (!mapped_read(
+          [&]
+          {
+              std::memcpy(text.data(), m_data + begin, text.size());
+          }))
+    {
+        return {};
+    }
+    return text;
+}
+
+[[nodiscard]] std::optional<std::uint64_t> log_file::find(std::string_view pattern,
+                                                          std::uint64_t    from,
+                                                          bool             forward) const
+{
+    std::shared_lock lock{m_mutex};
+
+    std::uint64_t lines   = m_newlines + (indexed_bytes() > m_lastLineStart ? 1 : 0);
+    std::uint64_t indexed = indexed_bytes();
+    if (pattern.empty() || lines == 0 || (forward && from >= lines) || is_stale())
+    {
+        return std::nullopt;
+    }
+
+    std::string_view text{m_data, indexed};
+    bool             found = false;
+    std::uint64_t    line  = 0;
+    auto             search =
+      [&]
+      {
+          if (forward)
+          {
+              std::size_t match = text.find(pattern, line_offset(from));
+              if (match != std::string_view::npos)
+              {
+                  found = true;
+                  line  = line_at(match);
+              }
+              return;
+          }
+
+          // Backwards in chunks, overlapping by the pattern length so that no match is cut in two.
+          std::uint64_t end = line_offset(std::min(from, lines - 1));
+          while (end > 0)
+          {
+              std::uint64_t    begin = end > SEARCH_CHUNK ? end - SEARCH_CHUNK : 0;
+              std::uint64_t    stop  = std::min(indexed, end + pattern.size() - 1);
+              std::string_view chunk = text.substr(begin, stop - begin);
+
+              std::size_t match = chunk.rfind(pattern);
+              if (match != std::string_view::npos && begin + match < end)
+              {
+                  found = true;
+                  line  = line_at(begin + match);
+                  return;
+              }
+              end = begin;
+          }
+      };
+
+    if (!mapped_read(search) || !found)
+    {
+        return std::nullopt;
+    }
+    return line;
+}
+
+
+void log_file::index_loop()
+{
+    while (!m_stopping.load())
+    {
+        struct stat info{};
+        if (::fstat(m_fd, &info) != 0)
+        {
+            return;
+        }
+        auto size = static_cast<std::uint64_t>(info.st_size);
+
+        if (size < indexed_bytes())
+        {
+            // Truncated or rotated in place: nothing indexed so far can be trusted.
+            std::unique_lock lock{m_mutex};
+            m_checkpoints.assign(1, 0);
+            m_newlines      = 0;
+            m_lastLineStart = 0;
+            m_indexedBytes.store(0, std::memory_order_release);
+            m_generation.fetch_add(1, std::memory_order_release);
+        }
+        if (size > m_capacity && !remap(size))
+        {
+            return;
+        }
+        m_size.store(size, std::memory_order_release);
+
+        bool complete = true;
+        for (std::uint64_t begin = indexed_bytes(); begin < size && !m_stopping.load();)
+        {
+            std::uint64_t end = std::min(size, begin + INDEX_CHUNK);
+            if (!index_range(begin, end))
+            {
+                complete = false;
+                break;
+            }
+            begin = end;
+        }
+
+        // A file that shrank while it was scanned is indexed again, even when not followed.
+        if (!m_follow && complete)
+        {
+            return;
+        }
+        std::this_thread::sleep_for(FOLLOW_POLL);
+    }
+}
+
+bool log_file::remap(std::uint64_t size)
+{
+    auto          page     = static_cast<std::uint64_t>(::sysconf(_SC_PAGESIZE));
+    std::uint64_t capacity = (std::max(size * 2, MIN_MAPPING) + page - 1) / page * page;
+
+    void* memory = ::mmap(nullptr, capacity, PROT_READ, MAP_SHARED, m_fd, 0);
+    if (memory == MAP_FAILED)
+    {
+        return false;
+    }
+
+    std::unique_lock lock{m_mutex};
+    if (m_data != nullptr)
+    {
+        ::munmap(const_cast<char*>(m_data), m_capacity);
+    }
+    m_data     = static_cast<const char*>(memory);
+    m_capacity = capacity;
+    return true;
+}
+
+bool log_file::index_range(std::uint64_t begin, std::uint64_t end)
+{
+    // Only this thread changes the index, so it can read it without the lock.
+    newline_scan scan{m_newlines, m_lastLineStart, {}};
+    {
+        std::shared_lock lock{m_mutex};
+        // After a fault, the partial scan is dropped and the next pass starts over.
+        if (!mapped_read(
+              [&]
+              {
+                  scan.scan(m_data, begin, end);
+              }))
+        {
+            return false;
+        }
+    }
+
+    std::unique_lock lock{m_mutex};
+    m_checkpoints.insert(m_checkpoints.end(), scan.checkpoints.begin(), scan.checkpoints.end());
+    m_newlines      = scan.newlines;
+    m_lastLineStart = scan.lastLineStart;
+    m_indexedBytes.store(end, std::memory_order_release);
+    m_generation.fetch_add(1, std::memory_order_release);
+    return true;
+}
+
+
+[[nodiscard]] bool log_file::is_stale() const
+{
+    // The index thread only notices a truncation on its next poll; until it starts over, the
+    // indexed range may reach past the end of the file.
+    struct stat info{};
+    return ::fstat(m_fd, &info) != 0 || static_cast<std::uint64_t>(info.st_size) < indexed_bytes();
+}
+
+[[nodiscard]] std::uint64_t log_file::line_offset(std::uint64_t index) const
+{
+    std::uint64_t offset  = m_checkpoints[index / LINE_STRIDE];
+    std::uint64_t indexed = indexed_bytes();
+    for (std::uint64_t i = 0; i < index % LINE_STRIDE; i++)
+    {
+        // The last line need not end with a newline: past it is the end of the indexed bytes.
+        const void* newline = std::memchr(m_data + offset, '\n', indexed - offset);
+        if (newline == nullptr)
+        {
+            return indexed;
+        }
+        offset = static_cast<std::uint64_t>(static_cast<const char*>(newline) - m_data) + 1;
+    }
+    return offset;
+}
+
+[[nodiscard]] std::uint64_t log_file::line_at(std::uint64_t offset) const
+{
+    auto checkpoint = std::upper_bound(m_checkpoints.begin(), m_checkpoints.end(), offset) - 1;
+    auto line       = static_cast<std::uint64_t>(checkpoint - m_checkpoints.begin()) * LINE_STRIDE;
+
+    for (std::uint64_t at = *checkpoint; at < offset; line++)
+    {
+        const void* newline = std::memchr(m_data + at, '\n', offset - at);
+        if (newline == nullptr)
+        {
+            break;
+        }
+        at = static_cast<std::uint64_t>(static_cast<const char*>(newline) - m_data) + 1;
+    }
+    return line;
+}
+
+
+/**
+ * ------------------------------------------------------------------------------------------------
+ */
@@ -0,0 +1,162 @@
+/**
+ * ===============================================================================================
+ * @file    log-file.h
+ * @author  Pascal-Emmanuel Lachance
+ * @p       <a href="https://www.github.com/Raesangur">Raesangur</a>
+ * @p       <a href="https://www.raesangur.com/">https://www.raesangur.com/</a>
+ *
+ * @brief   Memory-mapped text file with an incremental, sparse line index.
+ *
+ * ------------------------------------------------------------------------------------------------
+ * @copyright Copyright (c) 2023 Pascal-Emmanuel Lachance | Raesangur
+ *
+ * @par License: <a href="https://opensource.org/license/mit/"> MIT </a>
+ *               This project is released under the MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ * BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NON INFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ * ------------------------------------------------------------------------------------------------
+ * @details
+ * A log_file maps the whole file read-only and never copies it. A background thread scans the
+ * mapping for newlines with SIMD, keeping only the offset of every LINE_STRIDE-th line. Any line is
+ * then found by jumping to the checkpoint before it and stepping over at most LINE_STRIDE - 1
+ * newlines, so the cost of reaching a line does not depend on the size of the file or its position.
+ *
+ * Lines can be read as soon as the part of the file holding them is indexed, so a large file shows
+ * up immediately and the index grows behind the viewer. In follow mode the thread keeps watching
+ * the file and indexes whatever is appended; a file that shrinks is indexed again from the start.
+ * Until it is, reads check the file's size and return nothing, and a read that faults because the
+ * file shrank under it gives up through a SIGBUS handler instead of ending the process.
+ * ===============================================================================================
+ */
+#ifndef LOG_FILE_H
+#define LOG_FILE_H
+
+
+/** ===============================================================================================
+ *  INCLUDES
+ */
+#include "memory-accounting.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+
+/** ===============================================================================================
+ *  CLASS DEFINITION
+ */
+
+class log_file
+{
+public:
+    log_file() = default;
+    ~log_file();
+
+    log_file(const log_file&)       = delete;
+    void operator=(const log_file&) = delete;
+
+    bool open(const std::string& filename, bool follow);
+    void close();
+
+    [[nodiscard]] bool is_open() const
+    {
+        return m_fd >= 0;
+    }
+    [[nodiscard]] const std::string& filename() const
+    {
+        return m_filename;
+    }
+
+    // Lines indexed so far, counting an unterminated last line.
+    [[nodiscard]] std::uint64_t line_count() const;
+    [[nodiscard]] std::uint64_t indexed_bytes() const
+    {
+        return m_indexedBytes.load(std::memory_order_acquire);
+    }
+    [[nodiscard]] std::uint64_t size() const
+    {
+        return m_size.load(std::memory_order_acquire);
+    }
+    [[nodiscard]] bool is_indexing() const
+    {
+        return indexed_bytes() < size();
+    }
+
+    // Changes whenever the index grows or is rebuilt.
+    [[nodiscard]] std::uint64_t generation() const
+    {
+        return m_generation.load(std::memory_order_acquire);
+    }
+
+    // Copies line `index` without its newline, cut to `maxBytes`.
+    [[nodiscard]] std::string line(std::uint64_t index, std::size_t maxBytes) const;
+
+    // First line from `from` onwards (or last line before it) containing `pattern`, within the
+    // indexed part.
+    [[nodiscard]] std::optional<std::uint64_t> find(std::string_view pattern,
+                                                    std::uint64_t    from,
+                                                    bool             forward) const;
+
+    static constexpr std::uint64_t LINE_STRIDE = 256;
+
+protected:
+    void index_loop();
+    bool remap(std::uint64_t size);
+    // Returns false when the file shrank during the scan, which is then dropped.
+    bool index_range(std::uint64_t begin, std::uint64_t end);
+
+    // Whether the file is now shorter than what was indexed; checked under the lock before reads.
+    [[nodiscard]] bool is_stale() const;
+
+    [[nodiscard]] std::uint64_t line_offset(std::uint64_t index) const;
+    [[nodiscard]] std::uint64_t line_at(std::uint64_t offset) const;
+
+protected:
+    using checkpoints_t =
+        std::vector<std::uint64_t, tracking_allocator<std::uint64_t, memory_category::log_index>>;
+
+    std::string m_filename{};
+    int         m_fd     = -1;
+    bool        m_follow = false;
+
+    // The mapping is larger than the file so that appends rarely need a new one; the index thread
+    // replaces it under the exclusive lock, readers hold the shared one.
+    mutable std::shared_mutex m_mutex{};
+    const char*               m_data     = nullptr;
+    std::uint64_t             m_capacity = 0;
+
+    checkpoints_t              m_checkpoints{};    //!< Offset of line k * LINE_STRIDE.
+    std::uint64_t              m_newlines      = 0;
+    std::uint64_t              m_lastLineStart = 0;
+    std::atomic<std::uint64_t> m_size{0};
+    std::atomic<std::uint64_t> m_indexedBytes{0};
+    std::atomic<std::uint64_t> m_generation{0};
+
+    std::atomic<bool> m_stopping{false};
+    std::thread       m_thread{};
+};
+
+
+#endif  // LOG_FILE_H
+/**
+ * ------------------------------------------------------------------------------------------------
+ */
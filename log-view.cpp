@@ -0,0 +1,256 @@
+/**
+ * ===============================================================================================
+ * @file    log-view.cpp
+ * @author  Pascal-Emmanuel Lachance
+ * @p       <a href="https://www.github.com/Raesangur">Raesangur</a>
+ * @p       <a href="https://www.raesangur.com/">https://www.raesangur.com/</a>
+ *
+ * @brief   Scrollable viewer for a log_file, with tail-follow and search.
+ *
+ * ------------------------------------------------------------------------------------------------
+ * @copyright Copyright (c) 2023 Pascal-Emmanuel Lachance | Raesangur
+ *
+ * @par License: <a href="https://opensource.org/license/mit/"> MIT </a>
+ *               This project is released under the MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ * BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NON INFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ * ===============================================================================================
+ */
+/** ===============================================================================================
+ *  INCLUDES
+ */
+#include "log-view.h"
+
+#include "display-width.h"
+#include "output-view.h"
+#include "theme.h"
+
+#include <ncurses.h>
+
+#include <algorithm>
+
+
+/** ===============================================================================================
+ *  MEMBER FUNCTIONS DEFINITIONS
+ */
+
+void log_view::render(const log_file& file)
+{
+    std::uint64_t lines = file.line_count();
+    std::uint64_t rows  = static_cast<std::uint64_t>(visible_rows());
+    if (m_follow)
+    {
+        m_top = lines > rows ? lines - rows : 0;
+    }
+
+    // New lines only matter if they land on screen; the title is refreshed with them.
+    bool visibleGrowth = lines != m_drawnLines && m_drawnLines < m_top + rows;
+    if (m_valid && m_top == m_drawnTop && !visibleGrowth && file.generation() == m_generation)
+    {
+        return;
+    }
+    if (m_valid && m_top == m_drawnTop && !visibleGrowth)
+    {
+        // Only the progress in the title changed.
+        m_generation = file.generation();
+        return draw_status(file);
+    }
+
+    m_win.set_style(theme::get()->get(style_id::menu));
+    m_win.erase();
+    m_win.box();
+
+    int           columns = m_win.width() - 2 * FIRST_COL;
+    std::uint64_t end     = std::min(lines, m_top + rows);
+    for (std::uint64_t i = m_top; i < end; i++)
+    {
+        bool matched = m_match.has_value() && *m_match == i;
+        m_win.set_style(theme::get()->get(matched ? style_id::highlight : style_id::menu));
+
+        std::string text = output_view::sanitize(file.line(i, MAX_LINE_BYTES));
+        int         y    = FIRST_ROW + static_cast<int>(i - m_top);
+        m_win.print(y, FIRST_COL, clip_to_width(text, columns));
+    }
+
+    m_valid      = true;
+    m_drawnTop   = m_top;
+    m_drawnLines = lines;
+    m_generation = file.generation();
+    draw_status(file);
+}
+
+void log_view::invalidate()
+{
+    m_valid = false;
+}
+
+
+bool log_view::handle_key(const log_file& file, int ch)
+{
+    constexpr int ESC = 0x1B;
+
+    if (m_prompting)
+    {
+        if (ch == '\n')
+        {
+            m_prompting = false;
+            search(file, m_forward);
+        }
+        else if (ch == ESC)
+        {
+            m_prompting = false;
+        }
+        else if (ch == KEY_BACKSPACE || ch == 0x7F || ch == '\b')
+        {
+            if (!m_query.empty())
+            {
+                m_query.pop_back();
+            }
+        }
+        else if (ch >= 0x20 && ch < 0x7F)
+        {
+            m_query += static_cast<char>(ch);
+        }
+        draw_status(file);
+        return true;
+    }
+
+    std::uint64_t rows = static_cast<std::uint64_t>(visible_rows());
+    switch (ch)
+    {
+        case KEY_UP:
+            scroll_to(file, m_top > 0 ? m_top - 1 : 0);
+            break;
+        case KEY_DOWN:
+            scroll_to(file, m_top + 1);
+            break;
+        case KEY_PPAGE:
+            scroll_to(file, m_top > rows ? m_top - rows : 0);
+            break;
+        case KEY_NPAGE:
+            scroll_to(file, m_top + rows);
+            break;
+        case KEY_HOME:
+        case 'g':
+            scroll_to(file, 0);
+            break;
+
+        case KEY_END:
+        case 'G':
+        case 'f':
+            // The end of a growing file is a moving target: jumping there follows it.
+            m_follow = ch != 'f' || !m_follow;
+            m_valid  = false;
+            break;
+
+        case '/':
+        case '?':
+            m_prompting = true;
+            m_forward   = ch == '/';
+            m_query.clear();
+            m_message.clear();
+            draw_status(file);
+            break;
+        case 'n':
+            search(file, m_forward);
+            break;
+        case 'N':
+            search(file, !m_forward);
+            break;
+
+        default:
+            return false;
+    }
+    return true;
+}
+
+
+[[nodiscard]] int log_view::visible_rows() const
+{
+    return std::max(0, m_win.height() - FIRST_ROW - 1);
+}
+
+
+void log_view::scroll_to(const log_file& file, std::uint64_t top)
+{
+    std::uint64_t lines = file.line_count();
+    std::uint64_t rows  = static_cast<std::uint64_t>(visible_rows());
+
+    m_follow = false;
+    m_top    = std::min(top, lines > rows ? lines - rows : 0);
+}
+
+void log_view::search(const log_file& file, bool forward)
+{
+    if (m_query.empty())
+    {
+        return;
+    }
+
+    // Start next to the previous match, or from the top of the screen.
+    std::uint64_t from = m_match.has_value() ? *m_match + (forward ? 1 : 0) : m_top;
+
+    std::optional<std::uint64_t> match = file.find(m_query, from, forward);
+    if (!match.has_value())
+    {
+        m_message = "Pattern not found: " + m_query;
+        m_valid   = false;
+        return;
+    }
+
+    m_message.clear();
+    m_match = match;
+
+    // Keep the match on screen, a few lines below the top when the view has to move.
+    std::uint64_t rows = static_cast<std::uint64_t>(visible_rows());
+    if (*match < m_top || *match >= m_top + rows)
+    {
+        scroll_to(file, *match > rows / 4 ? *match - rows / 4 : 0);
+    }
+    m_valid = false;
+}
+
+void log_view::draw_status(const log_file& file)
+{
+    m_win.set_style(theme::get()->get(style_id::menu));
+
+    std::string title = file.filename() + " - " + std::to_string(file.line_count()) + " lines";
+    if (file.is_indexing())
+    {
+        std::uint64_t percent = file.indexed_bytes() * 100 / std::max<std::uint64_t>(file.size(), 1);
+        title += ", indexing " + std::to_string(percent) + "%";
+    }
+    if (m_follow)
+    {
+        title += ", following";
+    }
+    m_win.move(0, 1);
+    m_win.line(m_win.width() - 2);
+    m_win.print(0, clip_to_width(" " + title + " ", m_win.width() - 2));
+
+    std::string footer = m_prompting ? std::string{m_forward ? "/" : "?"} + m_query : m_message;
+    m_win.move(m_win.height() - 1, 1);
+    m_win.line(m_win.width() - 2);
+    if (!footer.empty())
+    {
+        m_win.print(m_win.height() - 1, 2, clip_to_width(footer, m_win.width() - 4));
+    }
+}
+
+
+/**
+ * ------------------------------------------------------------------------------------------------
+ */
@@ -0,0 +1,103 @@
+/**
+ * ===============================================================================================
+ * @file    log-view.h
+ * @author  Pascal-Emmanuel Lachance
+ * @p       <a href="https://www.github.com/Raesangur">Raesangur</a>
+ * @p       <a href="https://www.raesangur.com/">https://www.raesangur.com/</a>
+ *
+ * @brief   Scrollable viewer for a log_file, with tail-follow and search.
+ *
+ * ------------------------------------------------------------------------------------------------
+ * @copyright Copyright (c) 2023 Pascal-Emmanuel Lachance | Raesangur
+ *
+ * @par License: <a href="https://opensource.org/license/mit/"> MIT </a>
+ *               This project is released under the MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ * BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NON INFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ * ===============================================================================================
+ */
+#ifndef LOG_VIEW_H
+#define LOG_VIEW_H
+
+
+/** ===============================================================================================
+ *  INCLUDES
+ */
+#include "log-file.h"
+#include "window.h"
+
+#include <cstdint>
+#include <optional>
+#include <string>
+
+
+/** ===============================================================================================
+ *  CLASS DEFINITION
+ */
+
+class log_view
+{
+public:
+    log_view(window& win) : m_win{win} {}
+
+    // Draws only the visible lines, and only when the position, the file or the prompt changed.
+    void render(const log_file& file);
+    void invalidate();
+
+    // Returns false for keys the view does not use, so that the caller can handle them.
+    bool handle_key(const log_file& file, int ch);
+
+    // True while the view needs a frame tick: the file is being indexed or followed.
+    [[nodiscard]] bool is_animated(const log_file& file) const
+    {
+        return m_follow || file.is_indexing();
+    }
+
+    [[nodiscard]] int visible_rows() const;
+
+protected:
+    void scroll_to(const log_file& file, std::uint64_t top);
+    void search(const log_file& file, bool forward);
+    void draw_status(const log_file& file);
+
+protected:
+    static constexpr int         FIRST_ROW      = 2;
+    static constexpr int         FIRST_COL      = 2;
+    static constexpr std::size_t MAX_LINE_BYTES = 1024;
+
+    window& m_win;
+
+    std::uint64_t                m_top    = 0;
+    bool                         m_follow = false;
+    std::optional<std::uint64_t> m_match{};
+
+    bool        m_prompting = false;
+    bool        m_forward   = true;
+    std::string m_query{};
+    std::string m_message{};
+
+    // What the window currently shows.
+    bool          m_valid      = false;
+    std::uint64_t m_drawnTop   = 0;
+    std::uint64_t m_drawnLines = 0;
+    std::uint64_t m_generation = 0;
+};
+
+
+#endif  // LOG_VIEW_H
+/**
+ * ------------------------------------------------------------------------------------------------
+ */
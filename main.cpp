@@ -38,18 +38,46 @@
 /** ===============================================================================================
  *  INCLUDES
  */
+#include "action.h"
+#include "batch-runner.h"
+#include "bracketed-paste.h"
 #include "colors.h"
+#include "dashboard.h"
+#include "entry-metadata.h"
+#include "entry-probes.h"
+#include "install-plan.h"
+#include "layout.h"
+#include "log-file.h"
+#include "memory-accounting.h"
 #include "menu.h"
 #include "menu-manager.h"
+#include "menu-parser.h"
+#include "menu-reload.h"
+#include "package-status.h"
+#include "selection-journal.h"
+#include "status-segment.h"
+#include "task-runner.h"
+#include "theme.h"
+#include "trace.h"
 #include "window.h"
 
 #include <ncurses.h>
 
 #include <menu.h>
 
+#include <algorithm>
+#include <chrono>
+#include <clocale>
+#include <csignal>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
 #include <stack>
+#include <string>
+#include <vector>
 #include <stdlib.h>
 #include <string.h>
+#include <unistd.h>
 
 
 /** ===============================================================================================
@@ -58,119 +86,354 @@
 
 void initialize_ncurses()
 {
+    setlocale(LC_ALL, "");
     initscr();
     cbreak();
     noecho();
     keypad(stdscr, TRUE);
+    enable_bracketed_paste();
 }
 
 void deinitialize_ncurses()
 {
+    disable_bracketed_paste();
     endwin();
 }
 
 
-void format_main(window& win)
+struct input_state
 {
-    attron(A_BOLD);
+    std::size_t pageRows = 1;
+    std::size_t count    = 0;    //!< Numeric prefix typed before a motion, 0 when none.
+    std::string status{};        //!< One-line message shown in the title bar, if any.
+    bool        resized = false;
+
+    main_pane* view      = nullptr;
+    bool       hasLog    = false;    //!< Set when a log was given on the command line.
+    bool       taskShown = false;    //!< Whether the layout has room for the task log pane.
+};
+
+constexpr int FRAME_MS = 33;
+// Otherwise, input still times out this often so that a package database update gets drawn.
+constexpr int IDLE_MS = 1000;
+
+// Runs each step as a task, one after the other, and stops at the first one that fails.
+action run_steps(std::string name, std::vector<std::string> steps)
+{
+    for (const std::string& step : steps)
+    {
+        task* t = task_runner::get()->start(name, step);
+        if (co_await task_finished{*t} != 0)
+        {
+            co_return;
+        }
+    }
+}
 
-    win.print(0, {"Bon matin"});
+// Installs the packages of `selection`, a snapshot held for the whole run. The batches are planned
+// from it on the thread pool, so that the input thread does not wait on a large selection; the
+// tasks' name tells what the plan came to.
+action install_packages(selection_set selection)
+{
+    install_plan plan =
+      co_await offload{[&selection] { return install_planner::get()->plan(selection); }};
 
-    wmove(win.win, 1, 1);
-    win.line(win.width() - 2);
-    attroff(A_BOLD);
+    std::string name = "Install " + std::to_string(plan.packages) + " packages";
+    if (plan.duplicates > 0)
+    {
+        name += " (" + std::to_string(plan.duplicates) + " duplicates skipped)";
+    }
 
-    win.print(win.height() - 3, {"Press 'q' to quit."});
-    win.print(win.height() - 2, {"Arrow keys to navigate the menu. Press 'ENTER' to enter submenu."});
-    win.print(win.height() - 1, {"Press 'ESC' to exit menu. Press 'SPACE' to select an option."});
+    std::vector<std::string> commands{};
+    for (install_batch& batch : plan.batches)
+    {
+        commands.push_back(std::move(batch.command));
+    }
+    co_await run_steps(std::move(name), std::move(commands));
 }
 
-void format_menu(window& win, const menu_top_entry* currentMenu)
+// Moves within the tree view and opens or closes its rows; returns false for other keys.
+bool handle_tree_key(menu_manager* menus, menu_tree& tree, int ch, std::size_t count,
+                     const input_state& state)
 {
-    win.scrollok();
+    constexpr int ESC = 0x1B;
+
+    std::size_t cursor = tree.cursor();
+    switch (ch)
+    {
+        case KEY_UP:
+            tree.move_by(-static_cast<std::ptrdiff_t>(std::max<std::size_t>(count, 1)));
+            break;
 
-    win.erase();
-    win.box();
+        case KEY_DOWN:
+            tree.move_by(static_cast<std::ptrdiff_t>(std::max<std::size_t>(count, 1)));
+            break;
 
-    auto [y, _] = win.get_max_yx();
-    int maxItems = std::max(0, y - 4);
+        case KEY_PPAGE:
+            tree.move_by(-static_cast<std::ptrdiff_t>(state.pageRows));
+            break;
 
-    int highlightedItem = 0;
-    for(int i = 0; currentMenu->begin() + i < currentMenu->end(); i++)
-    {
-        if (currentMenu->get(i)->is_highlighted())
-        {
-            highlightedItem = i;
+        case KEY_NPAGE:
+            tree.move_by(static_cast<std::ptrdiff_t>(state.pageRows));
             break;
-        }
-    }
 
-    int start = std::max(0, highlightedItem - maxItems + 4);
-    int end = std::min(static_cast<int>(currentMenu->size()), start + maxItems);
+        case KEY_HOME:
+            tree.move_to(0);
+            break;
 
-    win.print(0, currentMenu->get_name());
+        case KEY_END:
+        case 'G':
+            tree.move_to(tree.size() > 0 ? tree.size() - 1 : 0);
+            break;
 
-    for (int i = start; i < end; i++)
-    {
-        const menu_entry* displayedMenu = currentMenu->get(i);
-        if (displayedMenu->is_highlighted())
+        case 'g':
+            tree.move_to(count > 0 ? count - 1 : 0);
+            break;
+
+        case KEY_RIGHT:
+            // An open row steps into its first child instead.
+            if (!tree.expand(cursor) && tree.is_expanded(cursor))
+            {
+                tree.move_by(1);
+            }
+            break;
+
+        case KEY_LEFT:
+            if (!tree.collapse(cursor))
+            {
+                tree.move_to(tree.parent(cursor));
+            }
+            break;
+
+        case '\n':
         {
-            win.set_attribute(A_STANDOUT, true);
+            menu_entry* entry = tree.cursor_entry();
+            if (dynamic_cast<menu_top_entry*>(entry) != nullptr)
+            {
+                if (!tree.collapse(cursor))
+                {
+                    tree.expand(cursor);
+                }
+            }
+            else if (entry != nullptr && entry->can_enter())
+            {
+                // Text fields are still edited on their own.
+                menus->enter(entry);
+            }
+            break;
         }
-        win.print(i + 2 - start, 5, displayedMenu->display());
-        win.set_attribute(A_STANDOUT, false);
-    }
 
-    if (static_cast<int>(currentMenu->size()) >= maxItems)
-    {
-        win.print(win.height() - 3, 2, "|");
-        win.print(win.height() - 2, 2, "v");
+        case ESC:
+            state.view->toggle_tree();
+            break;
+
+        default:
+            return false;
     }
+    return true;
 }
 
-
-int handle_inputs(menu_manager* menus)
+int handle_inputs(menu_manager* menus, input_state& state)
 {
     constexpr int ESC = 0x1B;
 
     int ch = getch();
+    // Only the handling is traced, not the wait for a key.
+    trace_span span{"handle_inputs"};
     if (menus->size() < 1 || menus->top() == nullptr)
     {
         return -1;
     }
+    if (ch == ERR)
+    {
+        // Frame tick: nothing was typed, but task output may need drawing.
+        return 0;
+    }
+    if (ch == KEY_RESIZE)
+    {
+        state.resized = true;
+        return 0;
+    }
+    if (ch == KEY_PASTE_BEGIN)
+    {
+        // The whole paste is one edit and one frame; outside of a text field it is dropped.
+        std::string text = read_paste();
+        if (auto* input = dynamic_cast<menu_input_entry*>(menus->top()); input != nullptr)
+        {
+            input->input_text(text);
+            state.view->mark_dirty();
+        }
+        return 0;
+    }
+
+    if (state.view->handle_log_key(ch))
+    {
+        return 0;
+    }
+    view_mode view = state.view->view();
+    if (view != view_mode::menu)
+    {
+        if (ch == 'q')
+        {
+            return -1;
+        }
+        if (ch == ESC || (ch == 'o' && view == view_mode::output) ||
+            (ch == 'l' && view == view_mode::log))
+        {
+            state.view->show(view_mode::menu);
+        }
+        return 0;
+    }
+    // Anything typed from here on may move or select within the menu.
+    state.view->mark_dirty();
 
     menu_entry& currentMenu = *menus->top();
     bool inputRestriction = currentMenu.has_input_field();
 
     if (!inputRestriction)
     {
+        if (ch >= '0' && ch <= '9')
+        {
+            // Held to the rows there are, so that a long prefix can neither wrap around nor turn
+            // negative as a step.
+            const menu_tree* shown = state.view->tree();
+            auto*            menu  = dynamic_cast<const menu_top_entry*>(&currentMenu);
+            std::size_t      rows  = shown != nullptr  ? shown->size()
+                                     : menu != nullptr ? menu->size()
+                                                       : 0;
+            state.count = std::min(state.count * 10 + static_cast<std::size_t>(ch - '0'),
+                                   std::max<std::size_t>(rows, 1));
+            return 0;
+        }
+        std::size_t count = state.count;
+        state.count       = 0;
+
+        menu_tree*  tree        = state.view->tree();
+        menu_entry* highlighted = tree != nullptr ? tree->cursor_entry()
+                                                  : currentMenu.highlighted_entry();
+        if (tree != nullptr && handle_tree_key(menus, *tree, ch, count, state))
+        {
+            // ESC closes the tree, so it is looked up again.
+            if (menu_tree* shown = state.view->tree(); shown != nullptr)
+            {
+                menus->prefetch(shown->cursor_entry());
+            }
+            return 0;
+        }
+
         switch(ch)
         {
             case 'q':
                 return -1;
 
+            case 'm':
+                state.status = std::string{memory_accounting::dump_to_file()
+                                               ? "Memory report written to "
+                                               : "Cannot write "} +
+                               memory_accounting::report_path();
+                break;
+
+            case 'x':
+            {
+                auto* option = dynamic_cast<menu_option_entry*>(highlighted);
+                if (option != nullptr && option->get_action() != nullptr)
+                {
+                    event_loop::get()->spawn(option->get_action()(*option));
+                }
+                else if (option != nullptr && !option->command().empty())
+                {
+                    task_runner::get()->start(option->get_name(), option->command());
+                }
+                else
+                {
+                    if (highlighted != nullptr)
+                    {
+                        state.status = "'" + highlighted->get_name() + "' has no command to run";
+                    }
+                    break;
+                }
+
+                if (!state.taskShown)
+                {
+                    state.view->show(view_mode::output);
+                }
+                break;
+            }
+
+            case 'i':
+            {
+                selection_set selection = menu_option_entry::selection();
+                if (selection.count() == 0)
+                {
+                    state.status = "Nothing is selected";
+                    break;
+                }
+
+                event_loop::get()->spawn(install_packages(std::move(selection)));
+                state.status = "Installing the selected packages";
+                if (!state.taskShown)
+                {
+                    state.view->show(view_mode::output);
+                }
+                break;
+            }
+
+            case 't':
+                state.view->toggle_table();
+                break;
+
+            case 'v':
+                if (!state.view->toggle_tree())
+                {
+                    state.status = "Only a menu can be shown as a tree";
+                }
+                break;
+
+            case 's':
+                if (auto* menu = dynamic_cast<menu_top_entry*>(&currentMenu); menu != nullptr)
+                {
+                    state.status = "Sorted by " +
+                                   std::string{entry_metadata::get()->sort_next(menu)};
+                    if (tree != nullptr)
+                    {
+                        tree->rebuild();
+                    }
+                }
+                break;
+
+            case 'o':
+                state.view->show(view_mode::output);
+                break;
+
+            case 'l':
+                if (state.hasLog)
+                {
+                    state.view->show(view_mode::log);
+                }
+                else
+                {
+                    state.status = "No log file was given with --log";
+                }
+                break;
+
             case ' ':
-                if (currentMenu.highlighted_entry()->can_select())
+                if (highlighted != nullptr && highlighted->can_select())
                 {
-                    if (currentMenu.highlighted_entry()->is_selected())
+                    if (highlighted->is_selected())
                     {
-                        currentMenu.highlighted_entry()->deselect();
+                        highlighted->deselect();
                     }
                     else
                     {
-                        currentMenu.highlighted_entry()->select();
+                        highlighted->select();
                     }
                 }
                 break;
 
             case '\n':
-                if (currentMenu.highlighted_entry()->can_enter())
+                if (highlighted != nullptr && highlighted->can_enter())
                 {
-                    menu_entry* newMenu = currentMenu.highlighted_entry();
-                    if (newMenu != nullptr)
-                    {
-                        menus->set_top(newMenu);
-                    }
+                    menus->enter(highlighted);
                 }
                 break;
 
@@ -182,16 +445,41 @@ int handle_inputs(menu_manager* menus)
                 break;
 
             case KEY_UP:
-                currentMenu.move_up();
+                currentMenu.move_by(-static_cast<std::ptrdiff_t>(std::max<std::size_t>(count, 1)));
                 break;
                 
             case KEY_DOWN:
-                currentMenu.move_down();
+                currentMenu.move_by(static_cast<std::ptrdiff_t>(std::max<std::size_t>(count, 1)));
+                break;
+
+            case KEY_PPAGE:
+                currentMenu.page_up(state.pageRows);
+                break;
+
+            case KEY_NPAGE:
+                currentMenu.page_down(state.pageRows);
+                break;
+
+            case KEY_HOME:
+                currentMenu.move_home();
+                break;
+
+            case KEY_END:
+            case 'G':
+                currentMenu.move_end();
+                break;
+
+            case 'g':
+                // <n>g jumps to the n-th entry, counting from 1.
+                currentMenu.move_to(count > 0 ? count - 1 : 0);
                 break;
 
             default:
                 return 0;
         }
+
+        // Lazy submenus start reading their source as soon as they are highlighted.
+        menus->prefetch(currentMenu.highlighted_entry());
     }
     else
     {
@@ -208,28 +496,103 @@ int handle_inputs(menu_manager* menus)
 }
 
 
-/** ===============================================================================================
- *  FUNCTION DEFINITIONS
- */
+void publish_status(status_publisher&     publisher,
+                    const menu_manager*   mm,
+                    const menu_top_entry* menu)
+{
+    if (!publisher.is_open())
+    {
+        return;
+    }
 
-int main() {
-    initialize_ncurses();
+    status_snapshot snapshot{};
+    snapshot.menuDepth      = static_cast<std::uint32_t>(mm->size());
+    snapshot.selectionCount = static_cast<std::uint32_t>(menu_option_entry::selected_count());
+    if (menu != nullptr)
+    {
+        snapshot.highlighted = static_cast<std::uint32_t>(menu->current_index());
+        snapshot.menuSize    = static_cast<std::uint32_t>(menu->size());
+        status_publisher::set_text(snapshot.currentMenu, menu->get_name());
+        if (const menu_entry* entry = menu->highlighted_entry(); entry != nullptr)
+        {
+            status_publisher::set_text(snapshot.highlightedName, entry->get_name());
+        }
+    }
+    task_progress progress = task_runner::get()->progress();
+    snapshot.tasksRunning  = progress.running;
+    snapshot.tasksDone     = progress.done;
+    snapshot.tasksTotal    = progress.total;
 
-    window mainWin = window::create_centered(-1, -1);
-    window menuWin = window::create_centered();
+    publisher.publish(snapshot);
+}
 
-    if (enable_colors())
+
+action configure_signing_key(const menu_option_entry& option)
+{
+    // The key path is read now, on the input thread; the steps only get a copy of the command.
+    std::string key  = "\"$HOME\"/.ssh/id_ed25519";
+    auto*       path = dynamic_cast<menu_input_entry*>(menu_manager::get()->find("SSH key path"));
+    if (path != nullptr && !path->buffer().empty())
     {
-        configure_background_colors();
-        mainWin.set_color(1);
-        menuWin.set_color(2);
+        std::string value = path->value();
+        key = value.starts_with("~/") ? "\"$HOME\"/" + shell_quote(value.substr(2))
+                                      : shell_quote(value);
     }
 
-    format_main(mainWin);
+    return run_steps(option.get_name(),
+                     {"git config --global gpg.format ssh",
+                      "git config --global user.signingkey " + key + ".pub"});
+}
+
+
+// Reports whether `path`, under the home directory, exists.
+probe_function home_file_probe(std::string path, std::string present, std::string missing)
+{
+    const char* home = getenv("HOME");
+    path             = std::string{home != nullptr ? home : ""} + "/" + path;
+    return [path, present, missing]
+    {
+        return ::access(path.c_str(), F_OK) == 0 ? present : missing;
+    };
+}
+
+// Reports "installed" when `program` is found in the PATH.
+probe_function program_probe(std::string program)
+{
+    const char* path = getenv("PATH");
+    return [program, directories = std::string{path != nullptr ? path : ""}]
+    {
+        std::string_view rest = directories;
+        while (!rest.empty())
+        {
+            std::size_t colon = rest.find(':');
+            std::string file  = std::string{rest.substr(0, colon)} + "/" + program;
+            if (::access(file.c_str(), X_OK) == 0)
+            {
+                return std::string{"installed"};
+            }
+            rest.remove_prefix(colon == std::string_view::npos ? rest.size() : colon + 1);
+        }
+        return std::string{};
+    };
+}
+
+
+void print_usage(const char* program)
+{
+    std::fprintf(stderr,
+                 "usage: %s [--native] [--prefetch] [--log <file>] [--trace <file>]\n"
+                 "       [--package-status <file>] [--installer <name>=<command>]...\n"
+                 "       [--batch [--select <spec>]... [--profile <spec>]...] [menu file]\n",
+                 program);
+}
+
 
-    menu_manager* mm = menu_manager::get();
+void build_default_menu(menu_manager* mm)
+{
     mm->add<menu_top_entry>("Main Menu")
         ->add<menu_top_option_entry>("Setup git")
+            ->add<menu_input_entry>("SSH key path")
             ->add<menu_option_entry>("Configure ssh key for authentication")
             ->add<menu_option_entry>("Configure ssh key for signing")
             ->finish()
@@ -259,24 +622,277 @@ int main() {
             ->add<menu_option_entry>("Create alternative link to python3")
             ->finish()
         ->add<menu_top_entry>("Install packages")
-            ->add<menu_top_option_entry>("C++ development")
-                ->add_file<menu_option_entry>("packages/cpp-dev.txt")
-                ->finish()
+            ->add_lazy_file<menu_top_option_entry>("C++ development", "packages/cpp-dev.txt")
             ->finish()
         ;
 
+    if (auto* signing = dynamic_cast<menu_option_entry*>(mm->find("Configure ssh key for signing"));
+        signing != nullptr)
+    {
+        signing->set_action(configure_signing_key);
+    }
+
+    // Shown next to the entries while they are on screen; see entry-probes.h.
+    entry_probes* probes = entry_probes::get();
+    probes->attach(mm->find("Configure ssh key for authentication"),
+                   home_file_probe(".ssh/id_ed25519", "key found", "no key"));
+    probes->attach(mm->find("Download zsh configuration"),
+                   home_file_probe(".zshrc", "configured", "not configured"));
+    probes->attach(mm->find("Download micro configuration"),
+                   home_file_probe(".config/micro/settings.json", "configured", "not configured"));
+    for (auto [name, program] : {std::pair{"Install zsh", "zsh"},
+                                 std::pair{"Install neofetch", "neofetch"},
+                                 std::pair{"Install btop", "btop"},
+                                 std::pair{"Install micro", "micro"},
+                                 std::pair{"Install python", "python3"}})
+    {
+        probes->attach(mm->find(name), program_probe(program));
+    }
+}
+
+
+/** ===============================================================================================
+ *  FUNCTION DEFINITIONS
+ */
+
+int main(int argc, char* argv[]) {
+    auto started = batch_runner::clock::now();
+
+    menu_manager* mm             = menu_manager::get();
+    const char*   menuFile       = nullptr;
+    const char*   logFile        = nullptr;
+    const char*   traceFile      = nullptr;
+    const char*   packageStatus  = DPKG_STATUS_PATH.data();
+    bool          nativeRenderer = false;
+    bool          batch          = false;
+
+    // --select and --profile specs, in command line order; profiles are flagged.
+    std::vector<std::pair<const char*, bool>> batchSpecs{};
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--native") == 0)
+        {
+            nativeRenderer = true;
+        }
+        else if (strcmp(argv[i], "--batch") == 0)
+        {
+            batch = true;
+        }
+        else if (strcmp(argv[i], "--select") == 0 && i + 1 < argc)
+        {
+            batchSpecs.emplace_back(argv[++i], false);
+        }
+        else if (strcmp(argv[i], "--profile") == 0 && i + 1 < argc)
+        {
+            batchSpecs.emplace_back(argv[++i], true);
+        }
+        else if (strcmp(argv[i], "--prefetch") == 0)
+        {
+            mm->set_prefetch(true);
+        }
+        else if (strcmp(argv[i], "--log") == 0 && i + 1 < argc)
+        {
+            logFile = argv[++i];
+        }
+        else if (strcmp(argv[i], "--trace") == 0 && i + 1 < argc)
+        {
+            traceFile = argv[++i];
+        }
+        else if (strcmp(argv[i], "--package-status") == 0 && i + 1 < argc)
+        {
+            packageStatus = argv[++i];
+        }
+        else if (strcmp(argv[i], "--installer") == 0 && i + 1 < argc)
+        {
+            if (!install_planner::get()->set_installer(argv[++i]))
+            {
+                std::fprintf(stderr, "--installer expects <name>=<command>, not '%s'\n", argv[i]);
+                return 1;
+            }
+        }
+        else if (argv[i][0] == '-')
+        {
+            // An option given last, without its value, ends up here too.
+            std::fprintf(stderr, "'%s' is not an option or is missing its value\n", argv[i]);
+            print_usage(argv[0]);
+            return 1;
+        }
+        else
+        {
+            menuFile = argv[i];
+        }
+    }
+    if (!batch && !batchSpecs.empty())
+    {
+        std::fprintf(stderr, "--select and --profile are only used with --batch\n");
+        return 1;
+    }
+
+    // Started before the tree is built, so that reading its files shows on the timeline.
+    trace::set_thread_name(batch ? "batch" : "input");
+    if (traceFile != nullptr)
+    {
+        trace::start(traceFile);
+    }
+
+    if (menuFile != nullptr)
+    {
+        menu_parse_result result = menu_parser::parse_file(menuFile, mm);
+        if (!result.ok)
+        {
+            std::fprintf(stderr, "%s:%zu: %s\n", menuFile, result.line, result.error.c_str());
+            return 1;
+        }
+    }
+    else
+    {
+        build_default_menu(mm);
+    }
+
+    const char* reportPath = getenv("NCURSES_TEST_MEMORY_REPORT");
+    memory_accounting::install_signal_handler(reportPath != nullptr ? reportPath : "memory.report",
+                                              SIGUSR1);
+
+    if (batch)
+    {
+        // A batch run needs none of what follows: no terminal, log, package database or journal.
+        batch_runner runner{mm, started};
+        for (auto [spec, profile] : batchSpecs)
+        {
+            if (profile)
+            {
+                runner.apply_profile(spec);
+            }
+            else
+            {
+                runner.apply(spec);
+            }
+        }
+        int status = runner.run();
+
+        event_loop::get()->stop();
+        task_runner::get()->stop();
+        if (!trace::stop())
+        {
+            std::fprintf(stderr, "%s: cannot write trace\n", traceFile);
+        }
+        return status;
+    }
+
+    if (!load_environment_theme())
+    {
+        return 1;
+    }
+
+    // Opening only maps the file; it is indexed in the background while the interface starts.
+    log_file log{};
+    if (logFile != nullptr && !log.open(logFile, true))
+    {
+        std::fprintf(stderr, "%s: cannot open log file\n", logFile);
+        return 1;
+    }
+
+    // Like the log, the package database is read in the background; rows are tagged once it is.
+    package_status::get()->start(packageStatus);
+
+    selection_journal journal{"selection"};
+    journal.restore(mm);
+    journal.start();
+
+    initialize_ncurses();
+    if (nativeRenderer)
+    {
+        window::enable_native_renderer();
+    }
+
+    // Without colors, the styles still resolve to their attributes.
+    enable_colors();
+    configure_background_colors();
+
+    header_pane  header{};
+    help_pane    help{};
+    main_pane    mainPane{mm, log.is_open() ? &log : nullptr};
+    details_pane details{mm, &mainPane};
+    task_pane    tasks{};
+    stats_pane   stats{};
+
+    using split = layout_node::split;
+    layout screen{layout_node{
+      split::rows,
+      {},
+      layout_node{&header, size_constraint{.fixed = 2}},
+      layout_node{split::columns,
+                  size_constraint{.min = 6},
+                  layout_node{&mainPane, size_constraint{.min = 30, .weight = 3}},
+                  layout_node{split::rows,
+                              size_constraint{.min = 30, .weight = 2},
+                              layout_node{&details, size_constraint{.fixed = 6}},
+                              layout_node{&tasks, size_constraint{.min = 4}},
+                              layout_node{&stats, size_constraint{.fixed = 6}}}},
+      layout_node{&help, size_constraint{.fixed = 3}}}};
+    screen.resize(LINES, COLS);
+
+    input_state inputState{};
+    inputState.view   = &mainPane;
+    inputState.hasLog = log.is_open();
+    if (log.is_open())
+    {
+        mainPane.show(view_mode::log);
+    }
+
+    status_publisher publisher{};
+    publisher.open();
     while(true)
     {
-        menu_top_entry* currentMenu = dynamic_cast<menu_top_entry*>(mm->top());
-        format_menu(menuWin, currentMenu);
+        // List files edited since the previous frame are applied before it is drawn.
+        if (reload_summary reload = menu_reloader::get()->apply(); reload.files > 0)
+        {
+            header.set_status("Reloaded " + std::to_string(reload.files) + " files, +" +
+                              std::to_string(reload.inserted) + " -" +
+                              std::to_string(reload.removed) + " entries");
+        }
 
-        if (handle_inputs(mm) == -1)
+        // Only the panes that changed since the previous frame draw anything.
+        {
+            trace_span frame{"frame"};
+            screen.render();
+            window::flush();
+        }
+        publish_status(publisher, mm, dynamic_cast<menu_top_entry*>(mm->top()));
+
+        // Input only waits for a frame while task output or the log can still change.
+        bool animated = task_runner::get()->has_running() || mainPane.is_animated() ||
+                        event_loop::get()->active() > 0;
+        timeout(animated ? FRAME_MS : IDLE_MS);
+
+        inputState.pageRows  = static_cast<std::size_t>(mainPane.visible_rows());
+        inputState.taskShown = screen.is_shown(&tasks);
+        if (handle_inputs(mm, inputState) == -1)
         {
             break;
         }
+        if (!inputState.status.empty())
+        {
+            header.set_status(std::move(inputState.status));
+            inputState.status.clear();
+        }
+        if (inputState.resized)
+        {
+            // Geometry is only ever computed here; every pane then redraws once in full.
+            window::resize_screen(LINES, COLS);
+            screen.resize(LINES, COLS);
+            inputState.resized = false;
+        }
     }
 
+    event_loop::get()->stop();
+    task_runner::get()->stop();
     deinitialize_ncurses();
+    if (!trace::stop())
+    {
+        std::fprintf(stderr, "%s: cannot write trace\n", traceFile);
+        return 1;
+    }
     return 0;
 }
 
@@ -0,0 +1,339 @@
+/**
+ * ===============================================================================================
+ * @file    memory-accounting.cpp
+ * @author  Pascal-Emmanuel Lachance
+ * @p       <a href="https://www.github.com/Raesangur">Raesangur</a>
+ * @p       <a href="https://www.raesangur.com/">https://www.raesangur.com/</a>
+ *
+ * @brief   Per-subsystem memory counters and the memory report.
+ *
+ * ------------------------------------------------------------------------------------------------
+ * @copyright Copyright (c) 2023 Pascal-Emmanuel Lachance | Raesangur
+ *
+ * @par License: <a href="https://opensource.org/license/mit/"> MIT </a>
+ *               This project is released under the MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ * BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NON INFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ * ===============================================================================================
+ */
+/** ===============================================================================================
+ *  INCLUDES
+ */
+#include "memory-accounting.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+
+
+/** ===============================================================================================
+ *  CONSTANTS
+ */
+
+constexpr std::array<const char*, static_cast<std::size_t>(memory_category::count)> CATEGORY_NAMES
+{
+    "menu map",
+    "menu entries",
+    "entry names",
+    "submenu lists",
+    "submenu chain",
+    "string vectors",
+    "windows",
+    "task output",
+    "log index",
+    "action frames",
+    "installed packages",
+    "entry metadata",
+    "watched files",
+    "trace buffers",
+    "tree rows",
+    "selection chunks",
+};
+
+constexpr std::size_t NAME_COLUMN   = 16;
+constexpr std::size_t NUMBER_COLUMN = 14;
+
+
+/** ===============================================================================================
+ *  STATIC MEMBERS
+ */
+
+std::array<memory_accounting::counters, memory_accounting::CATEGORY_COUNT>
+                      memory_accounting::s_counters{};
+std::array<char, 256> memory_accounting::s_path{"memory.report"};
+
+
+/** ===============================================================================================
+ *  LOCAL FUNCTIONS
+ */
+
+// Fixed-size output buffer; nothing here may allocate since it runs inside a signal handler.
+struct report_buffer
+{
+    std::array<char, 2048> data{};
+    std::size_t            size = 0;
+
+    void append(const char* text)
+    {
+        std::size_t length = std::min(std::strlen(text), data.size() - size);
+        std::memcpy(data.data() + size, text, length);
+        size += length;
+    }
+
+    void pad_to(std::size_t column, std::size_t lineStart)
+    {
+        while (size - lineStart < column && size < data.size())
+        {
+            data[size++] = ' ';
+        }
+    }
+
+    void append_right(const char* text, std::size_t width)
+    {
+        for (std::size_t i = std::strlen(text); i < width && size < data.size(); i++)
+        {
+            data[size++] = ' ';
+        }
+        append(text);
+    }
+
+    void append_number(std::int64_t value, std::size_t width)
+    {
+        std::array<char, 24> digits{};
+        std::size_t          count    = 0;
+        bool                 negative = value < 0;
+        std::uint64_t        magnitude =
+            negative ? 0 - static_cast<std::uint64_t>(value) : static_cast<std::uint64_t>(value);
+        do
+        {
+            digits[count++] = static_cast<char>('0' + magnitude % 10);
+            magnitude /= 10;
+        } while (magnitude != 0);
+        if (negative)
+        {
+            digits[count++] = '-';
+        }
+
+        for (std::size_t i = count; i < width && size < data.size(); i++)
+        {
+            data[size++] = ' ';
+        }
+        while (count > 0 && size < data.size())
+        {
+            data[size++] = digits[--count];
+        }
+    }
+
+    void append_row(const char* name, std::int64_t bytes, std::int64_t objects, std::int64_t peak)
+    {
+        std::size_t lineStart = size;
+        append(name);
+        pad_to(NAME_COLUMN, lineStart);
+        append_number(bytes, NUMBER_COLUMN);
+        append_number(objects, NUMBER_COLUMN);
+        append_number(peak, NUMBER_COLUMN);
+        append("\n");
+    }
+};
+
+static void write_all(int fd, const char* data, std::size_t size)
+{
+    while (size > 0)
+    {
+        ssize_t written = ::write(fd, data, size);
+        if (written < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (written <= 0)
+        {
+            return;
+        }
+        data += written;
+        size -= static_cast<std::size_t>(written);
+    }
+}
+
+static void on_report_signal(int)
+{
+    int savedErrno = errno;
+    memory_accounting::dump_to_file();
+    errno = savedErrno;
+}
+
+
+/** ===============================================================================================
+ *  MEMBER FUNCTIONS DEFINITIONS
+ */
+
+void memory_accounting::allocate(memory_category category, std::size_t bytes, std::size_t objects)
+{
+    counters& c = s_counters[static_cast<std::size_t>(category)];
+
+    std::int64_t current = c.bytes.fetch_add(static_cast<std::int64_t>(bytes),
+                                             std::memory_order_relaxed) +
+                           static_cast<std::int64_t>(bytes);
+    c.objects.fetch_add(static_cast<std::int64_t>(objects), std::memory_order_relaxed);
+
+    std::int64_t peak = c.peakBytes.load(std::memory_order_relaxed);
+    while (current > peak &&
+           !c.peakBytes.compare_exchange_weak(peak, current, std::memory_order_relaxed))
+    {
+    }
+}
+
+void memory_accounting::release(memory_category category, std::size_t bytes, std::size_t objects)
+{
+    counters& c = s_counters[static_cast<std::size_t>(category)];
+    c.bytes.fetch_sub(static_cast<std::int64_t>(bytes), std::memory_order_relaxed);
+    c.objects.fetch_sub(static_cast<std::int64_t>(objects), std::memory_order_relaxed);
+}
+
+
+[[nodiscard]] memory_usage memory_accounting::usage(memory_category category)
+{
+    const counters& c = s_counters[static_cast<std::size_t>(category)];
+    return memory_usage{CATEGORY_NAMES[static_cast<std::size_t>(category)],
+                        c.bytes.load(std::memory_order_relaxed),
+                        c.objects.load(std::memory_order_relaxed),
+                        c.peakBytes.load(std::memory_order_relaxed)};
+}
+
+[[nodiscard]] std::vector<memory_usage> memory_accounting::report()
+{
+    std::vector<memory_usage> rows{};
+    rows.reserve(s_counters.size());
+    for (std::size_t i = 0; i < s_counters.size(); i++)
+    {
+        rows.push_back(usage(static_cast<memory_category>(i)));
+    }
+    return rows;
+}
+
+[[nodiscard]] std::int64_t memory_accounting::resident_bytes()
+{
+    int fd = ::open("/proc/self/statm", O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+    {
+        return 0;
+    }
+
+    std::array<char, 128> text{};
+    ssize_t               count = ::read(fd, text.data(), text.size() - 1);
+    ::close(fd);
+    if (count <= 0)
+    {
+        return 0;
+    }
+
+    // The second field is the resident page count.
+    const char* p = text.data();
+    while (*p != '\0' && *p != ' ')
+    {
+        p++;
+    }
+    std::int64_t pages = 0;
+    for (p++; *p >= '0' && *p <= '9'; p++)
+    {
+        pages = pages * 10 + (*p - '0');
+    }
+    return pages * static_cast<std::int64_t>(::sysconf(_SC_PAGESIZE));
+}
+
+
+void memory_accounting::dump(int fd)
+{
+    report_buffer out{};
+
+    std::size_t lineStart = out.size;
+    out.append("category");
+    out.pad_to(NAME_COLUMN, lineStart);
+    out.append_right("bytes", NUMBER_COLUMN);
+    out.append_right("objects", NUMBER_COLUMN);
+    out.append_right("peak bytes", NUMBER_COLUMN);
+    out.append("\n");
+
+    std::int64_t totalBytes   = 0;
+    std::int64_t totalObjects = 0;
+    std::int64_t totalPeak    = 0;
+    for (std::size_t i = 0; i < s_counters.size(); i++)
+    {
+        memory_usage row = usage(static_cast<memory_category>(i));
+        out.append_row(row.name, row.bytes, row.objects, row.peakBytes);
+        totalBytes += row.bytes;
+        totalObjects += row.objects;
+        totalPeak += row.peakBytes;
+    }
+    out.append_row("total", totalBytes, totalObjects, totalPeak);
+
+    lineStart = out.size;
+    out.append("resident");
+    out.pad_to(NAME_COLUMN, lineStart);
+    out.append_number(resident_bytes(), NUMBER_COLUMN);
+    out.append("\n");
+
+    write_all(fd, out.data.data(), out.size);
+}
+
+bool memory_accounting::dump_to_file()
+{
+    int fd = ::open(s_path.data(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0)
+    {
+        return false;
+    }
+    dump(fd);
+    ::close(fd);
+    return true;
+}
+
+
+void memory_accounting::install_signal_handler(const std::string& path, int signal)
+{
+    std::size_t length = std::min(path.size(), s_path.size() - 1);
+    std::memcpy(s_path.data(), path.data(), length);
+    s_path[length] = '\0';
+
+    struct sigaction action{};
+    action.sa_handler = on_report_signal;
+    action.sa_flags   = SA_RESTART;
+    sigemptyset(&action.sa_mask);
+    ::sigaction(signal, &action, nullptr);
+}
+
+
+/** ===============================================================================================
+ *  FUNCTION DEFINITIONS
+ */
+
+[[nodiscard]] std::size_t heap_bytes(const std::string& str)
+{
+    const char* data  = str.data();
+    const char* begin = reinterpret_cast<const char*>(&str);
+    if (data >= begin && data < begin + sizeof(std::string))
+    {
+        return 0;
+    }
+    return str.capacity() + 1;
+}
+
+
+/**
+ * ------------------------------------------------------------------------------------------------
+ */
@@ -0,0 +1,221 @@
+/**
+ * ===============================================================================================
+ * @file    memory-accounting.h
+ * @author  Pascal-Emmanuel Lachance
+ * @p       <a href="https://www.github.com/Raesangur">Raesangur</a>
+ * @p       <a href="https://www.raesangur.com/">https://www.raesangur.com/</a>
+ *
+ * @brief   Per-subsystem memory counters and the memory report.
+ *
+ * ------------------------------------------------------------------------------------------------
+ * @copyright Copyright (c) 2023 Pascal-Emmanuel Lachance | Raesangur
+ *
+ * @par License: <a href="https://opensource.org/license/mit/"> MIT </a>
+ *               This project is released under the MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ * BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NON INFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ * ------------------------------------------------------------------------------------------------
+ * @details
+ * Each subsystem that owns a significant amount of memory charges it to a memory_category, either
+ * through tracking_allocator for standard containers, through class-level operator new/delete, or
+ * explicitly with memory_accounting::allocate/release when the storage belongs to a library.
+ *
+ * The counters are lock-free atomics, so the report can be produced from a signal handler:
+ * memory_accounting::dump() only uses open/read/write and formats numbers by hand.
+ * ===============================================================================================
+ */
+#ifndef MEMORY_ACCOUNTING_H
+#define MEMORY_ACCOUNTING_H
+
+
+/** ===============================================================================================
+ *  INCLUDES
+ */
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <string>
+#include <vector>
+
+
+/** ===============================================================================================
+ *  TYPES
+ */
+
+enum class memory_category
+{
+    menu_map,
+    menu_entries,
+    entry_names,
+    submenu_lists,
+    submenu_chain,
+    string_vectors,
+    windows,
+    task_output,
+    log_index,
+    action_frames,
+    installed_packages,
+    entry_metadata,
+    watched_files,
+    trace_buffers,
+    tree_rows,
+    selection_chunks,
+    count
+};
+
+struct memory_usage
+{
+    const char*  name      = "";
+    std::int64_t bytes     = 0;
+    std::int64_t objects   = 0;
+    std::int64_t peakBytes = 0;
+};
+
+
+/** ===============================================================================================
+ *  CLASS DEFINITION
+ */
+
+class memory_accounting
+{
+public:
+    memory_accounting() = delete;
+
+    static void allocate(memory_category category, std::size_t bytes, std::size_t objects = 1);
+    static void release(memory_category category, std::size_t bytes, std::size_t objects = 1);
+
+    [[nodiscard]] static memory_usage              usage(memory_category category);
+    [[nodiscard]] static std::vector<memory_usage> report();
+
+    // Resident set size of the whole process, from /proc/self/statm; 0 when unavailable.
+    [[nodiscard]] static std::int64_t resident_bytes();
+
+    // Writes the report as a text table; async-signal-safe.
+    static void dump(int fd);
+    // Writes the report to the configured file, replacing it; async-signal-safe.
+    static bool dump_to_file();
+
+    // Dumps the report to `path` every time `signal` is received.
+    static void install_signal_handler(const std::string& path, int signal);
+
+    [[nodiscard]] static const char* report_path()
+    {
+        return s_path.data();
+    }
+
+protected:
+    struct counters
+    {
+        std::atomic<std::int64_t> bytes{0};
+        std::atomic<std::int64_t> objects{0};
+        std::atomic<std::int64_t> peakBytes{0};
+    };
+
+    static constexpr std::size_t CATEGORY_COUNT = static_cast<std::size_t>(memory_category::count);
+
+    static std::array<counters, CATEGORY_COUNT> s_counters;
+    static std::array<char, 256>                s_path;
+};
+
+
+// Charges every allocation made by a standard container to a memory_category, one object per
+// element allocated (a map node, a vector slot).
+template<typename T, memory_category category>
+class tracking_allocator
+{
+public:
+    using value_type = T;
+
+    template<typename U>
+    struct rebind
+    {
+        using other = tracking_allocator<U, category>;
+    };
+
+    tracking_allocator() noexcept = default;
+    template<typename U>
+    tracking_allocator(const tracking_allocator<U, category>&) noexcept {}
+
+    [[nodiscard]] T* allocate(std::size_t n)
+    {
+        T* p = static_cast<T*>(::operator new(n * sizeof(T)));
+        memory_accounting::allocate(category, n * sizeof(T), n);
+        return p;
+    }
+
+    void deallocate(T* p, std::size_t n) noexcept
+    {
+        memory_accounting::release(category, n * sizeof(T), n);
+        ::operator delete(p, n * sizeof(T));
+    }
+
+    template<typename U>
+    bool operator==(const tracking_allocator<U, category>&) const noexcept
+    {
+        return true;
+    }
+};
+
+
+// Charges a buffer that lives for the duration of a scope, such as a file read into a stringvec.
+class scoped_allocation
+{
+public:
+    scoped_allocation(memory_category category, std::size_t bytes, std::size_t objects = 1) :
+        m_category{category}, m_bytes{bytes}, m_objects{objects}
+    {
+        memory_accounting::allocate(m_category, m_bytes, m_objects);
+    }
+    ~scoped_allocation()
+    {
+        memory_accounting::release(m_category, m_bytes, m_objects);
+    }
+
+    scoped_allocation(const scoped_allocation&) = delete;
+    void operator=(const scoped_allocation&) = delete;
+
+protected:
+    memory_category m_category;
+    std::size_t     m_bytes;
+    std::size_t     m_objects;
+};
+
+
+/** ===============================================================================================
+ *  FUNCTION DECLARATIONS
+ */
+
+// Heap bytes owned by a string, 0 when it fits in the small-string buffer.
+[[nodiscard]] std::size_t heap_bytes(const std::string& str);
+
+template<typename Container>
+[[nodiscard]] std::size_t heap_bytes_of_strings(const Container& strings)
+{
+    std::size_t bytes = strings.capacity() * sizeof(typename Container::value_type);
+    for (const std::string& str : strings)
+    {
+        bytes += heap_bytes(str);
+    }
+    return bytes;
+}
+
+
+#endif  // MEMORY_ACCOUNTING_H
+/**
+ * ------------------------------------------------------------------------------------------------
+ */
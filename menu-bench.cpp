@@ -0,0 +1,284 @@
+/**
+ * ===============================================================================================
+ * @file    menu-bench.cpp
+ * @author  Pascal-Emmanuel Lachance
+ * @p       <a href="https://www.github.com/Raesangur">Raesangur</a>
+ * @p       <a href="https://www.raesangur.com/">https://www.raesangur.com/</a>
+ *
+ * @brief   Compares adding menu entries one at a time and in bulk.
+ *
+ * ------------------------------------------------------------------------------------------------
+ * @copyright Copyright (c) 2023 Pascal-Emmanuel Lachance | Raesangur
+ *
+ * @par License: <a href="https://opensource.org/license/mit/"> MIT </a>
+ *               This project is released under the MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ * BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NON INFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ * ------------------------------------------------------------------------------------------------
+ * @details
+ * Usage: menu_bench [entries]
+ *
+ * Builds a menu of `entries` options in a fresh menu_manager, through submenu_manager::add(), one
+ * entry at a time, and through menu_manager::add_all(). Both are measured with the names sorted,
+ * as package lists usually are, and shuffled. Prints the best time per entry of a few runs, and
+ * the matching throughput.
+ *
+ * A menu file of PARSE_LINES lines, nested menus and groups of options with commands, is then
+ * parsed from memory with menu_parser::parse(), and its best throughput printed in MB/s.
+ *
+ * It then selects every entry and times snapshots of the selection (see selection-set.h), alone and
+ * each followed by a change to the live selection, with the memory the changes copied.
+ * ===============================================================================================
+ */
+/** ===============================================================================================
+ *  INCLUDES
+ */
+#include "menu-manager.h"
+#include "menu-parser.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+
+
+/** ===============================================================================================
+ *  CONSTANTS
+ */
+
+constexpr std::size_t DEFAULT_ENTRIES = 1'000'000;
+constexpr int         ROUNDS          = 3;
+constexpr std::size_t SNAPSHOTS       = 1000;
+constexpr std::size_t PARSE_LINES     = 400'000;
+constexpr std::size_t GROUP_OPTIONS   = 20;     //!< Options per group in the parsed file.
+constexpr std::size_t MENU_GROUPS     = 50;     //!< Groups per submenu in the parsed file.
+
+
+/** ===============================================================================================
+ *  CLASS DEFINITION
+ */
+
+// The menu_manager singleton cannot be reset, so every run gets an instance of its own.
+class bench_manager : public menu_manager
+{
+public:
+    bench_manager() = default;
+};
+
+
+/** ===============================================================================================
+ *  LOCAL FUNCTIONS
+ */
+
+// Seconds taken by `build` to fill a fresh manager's root menu with `names`.
+template<typename Build>
+static double time_build(const std::vector<std::string>& names, Build build)
+{
+    bench_manager mm{};
+    mm.add<menu_top_entry>("Packages");
+
+    auto start = std::chrono::steady_clock::now();
+    build(mm, names);
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+static void one_by_one(bench_manager& mm, const std::vector<std::string>& names)
+{
+    // add() goes through the manager of the menu being built, as menu files do.
+    submenu_manager menu{&mm};
+    for (const std::string& name : names)
+    {
+        menu.add<menu_option_entry>(name);
+    }
+}
+
+static void bulk(bench_manager& mm, const std::vector<std::string>& names)
+{
+    mm.add_all<menu_option_entry>(names);
+}
+
+// The paths take turns, and the best of each is kept: the first run pays for the process' heap to
+// grow, the others reuse what the previous one freed.
+static void compare(const char* order, const std::vector<std::string>& names)
+{
+    double bestAdd  = std::numeric_limits<double>::max();
+    double bestBulk = std::numeric_limits<double>::max();
+    for (int i = 0; i < ROUNDS; i++)
+    {
+        bestAdd  = std::min(bestAdd, time_build(names, one_by_one));
+        bestBulk = std::min(bestBulk, time_build(names, bulk));
+    }
+
+    double entries = static_cast<double>(names.size());
+    std::printf("%-8s add     %8.1f ns per entry, %6.2f M entries/s\n",
+                order,
+                bestAdd * 1e9 / entries,
+                entries / bestAdd / 1e6);
+    std::printf("%-8s add_all %8.1f ns per entry, %6.2f M entries/s\n",
+                order,
+                bestBulk * 1e9 / entries,
+                entries / bestBulk / 1e6);
+}
+
+
+// A menu file of about `lines` lines: submenus of groups of options, a third of them with a
+// command, and a comment line per group.
+static std::string menu_text(std::size_t lines)
+{
+    std::string text = "menu Main Menu\n";
+    for (std::size_t count = 1, menu = 0; count < lines; menu++)
+    {
+        text += "    menu Submenu " + std::to_string(menu) + "\n";
+        count++;
+        for (std::size_t group = 0; group < MENU_GROUPS && count < lines; group++)
+        {
+            // Names are unique across the tree, as a repeated one would add to the same entry.
+            std::string name = std::to_string(menu) + "-" + std::to_string(group);
+            text += "        # Group " + name + "\n";
+            text += "        group:selected Group " + name + "\n";
+            count += 2;
+            for (std::size_t option = 0; option < GROUP_OPTIONS && count < lines; option++)
+            {
+                std::string optionName = "option-" + name + "-" + std::to_string(option);
+                text += "            option " + optionName;
+                text += option % 3 == 0 ? " => echo " + optionName + "\n" : "\n";
+                count++;
+            }
+        }
+    }
+    return text;
+}
+
+static void parse(std::size_t lines)
+{
+    std::string text = menu_text(lines);
+
+    double best = std::numeric_limits<double>::max();
+    for (int i = 0; i < ROUNDS; i++)
+    {
+        bench_manager mm{};
+
+        auto              start  = std::chrono::steady_clock::now();
+        menu_parse_result result = menu_parser::parse(text, &mm);
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+        if (!result.ok)
+        {
+            std::fprintf(stderr, "line %zu: %s\n", result.line, result.error.c_str());
+            return;
+        }
+        best = std::min(best, elapsed.count());
+    }
+
+    double megabytes = static_cast<double>(text.size()) / 1e6;
+    std::printf("parse   %8.1f MB/s, %zu lines (%.1f MB) in %.1f ms\n",
+                megabytes / best,
+                lines,
+                megabytes,
+                best * 1e3);
+}
+
+// Snapshots are kept alive, as a run would keep its own, so that every change has to copy.
+static void snapshots(const std::vector<std::string>& names)
+{
+    bench_manager mm{};
+    mm.add<menu_top_entry>("Packages");
+    mm.add_all<menu_option_entry>(names);
+
+    auto* menu = dynamic_cast<menu_top_entry*>(mm.top());
+    if (menu == nullptr)
+    {
+        return;
+    }
+
+    std::vector<menu_entry*> entries{};
+    for (menu_entry* entry : *menu)
+    {
+        entry->select();
+        entries.push_back(entry);
+    }
+
+    std::vector<selection_set> taken{};
+    taken.reserve(2 * SNAPSHOTS);
+
+    auto start = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < SNAPSHOTS; i++)
+    {
+        taken.push_back(menu_option_entry::selection());
+    }
+    std::chrono::duration<double> snapshot = std::chrono::steady_clock::now() - start;
+
+    std::int64_t shared = memory_accounting::usage(memory_category::selection_chunks).bytes;
+    start               = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < SNAPSHOTS; i++)
+    {
+        taken.push_back(menu_option_entry::selection());
+        entries[i * entries.size() / SNAPSHOTS]->deselect();
+    }
+    std::chrono::duration<double> edit = std::chrono::steady_clock::now() - start;
+
+    std::int64_t copied =
+        memory_accounting::usage(memory_category::selection_chunks).bytes - shared;
+
+    std::printf("snapshot        %8.1f ns, %zu selected, %.1f KiB shared\n",
+                snapshot.count() * 1e9 / SNAPSHOTS,
+                entries.size(),
+                static_cast<double>(shared) / 1024.0);
+    std::printf("snapshot + edit %8.1f ns, %.1f KiB copied per edit\n",
+                edit.count() * 1e9 / SNAPSHOTS,
+                static_cast<double>(copied) / SNAPSHOTS / 1024.0);
+}
+
+
+/** ===============================================================================================
+ *  FUNCTION DEFINITIONS
+ */
+
+int main(int argc, char* argv[])
+{
+    std::size_t entries = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : DEFAULT_ENTRIES;
+    if (entries == 0)
+    {
+        std::fprintf(stderr, "usage: %s [entries]\n", argv[0]);
+        return 1;
+    }
+
+    std::vector<std::string> names{};
+    names.reserve(entries);
+    for (std::size_t i = 0; i < entries; i++)
+    {
+        std::string number = std::to_string(i);
+        names.push_back("package-" + std::string(10 - std::min(number.size(), 10ul), '0') + number);
+    }
+
+    compare("sorted", names);
+
+    std::shuffle(names.begin(), names.end(), std::mt19937{42});
+    compare("shuffled", names);
+
+    parse(PARSE_LINES);
+    snapshots(names);
+    return 0;
+}
+
+
+/**
+ * ------------------------------------------------------------------------------------------------
+ */
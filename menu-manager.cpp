@@ -43,6 +43,99 @@
 menu_manager* menu_manager::m_instance = nullptr;
 
 
+/** ===============================================================================================
+ *  MEMBER FUNCTIONS DEFINITIONS
+ */
+
+void menu_manager::enter(menu_entry* entry)
+{
+    if (auto* submenu = dynamic_cast<menu_top_entry*>(entry); submenu != nullptr)
+    {
+        submenu->materialize();
+    }
+    set_top(entry);
+}
+
+void menu_manager::prefetch(menu_entry* entry)
+{
+    if (!m_prefetch)
+    {
+        return;
+    }
+    if (auto* submenu = dynamic_cast<menu_top_entry*>(entry); submenu != nullptr)
+    {
+        submenu->prefetch();
+    }
+}
+
+
+bool menu_manager::defer_selection(std::string_view name, bool selected)
+{
+    // With every lazy source built, nothing could ever add the entry.
+    if (m_pendingSources == 0)
+    {
+        return false;
+    }
+    m_deferredSelections.insert_or_assign(std::string{name}, selected);
+    return true;
+}
+
+void menu_manager::source_released()
+{
+    // Sources are released after their build, so the entries they added have had their state.
+    if (m_pendingSources > 0 && --m_pendingSources == 0)
+    {
+        m_deferredSelections.clear();
+    }
+}
+
+void menu_manager::apply_deferred_selection(menu_entry* entry)
+{
+    auto it = m_deferredSelections.find(entry->get_name());
+    if (it == m_deferredSelections.end())
+    {
+        return;
+    }
+
+    if (auto* option = dynamic_cast<menu_option_entry*>(entry); option != nullptr)
+    {
+        option->set_selected(it->second);
+    }
+    m_deferredSelections.erase(it);
+}
+
+
+void submenu_manager::describe(package_list* packages, std::span<menu_entry* const> entries)
+{
+    if (packages == nullptr)
+    {
+        return;
+    }
+
+    for (menu_entry* entry : entries)
+    {
+        // The entry may already exist with another type when a name is reused.
+        auto* option = dynamic_cast<menu_option_entry*>(entry);
+        if (option != nullptr)
+        {
+            install_planner::get()->add_package(packages, option);
+        }
+    }
+    entry_metadata::get()->load(entry_metadata::side_file(packages->filename), entries);
+}
+
+stringvec submenu_manager::read_menu_lines(std::string_view filename)
+{
+    trace_span span{"read_menu_lines", filename};
+
+    stringvec lines{};
+    lines.read_file(filename);
+
+    lines.filter_empty();
+    return lines;
+}
+
+
 template<>
 submenu_manager* submenu_manager::add<menu_top_entry>(const std::string_view name)
 {
@@ -36,15 +36,26 @@
 /** ===============================================================================================
  *  INCLUDES
  */
+#include "entry-metadata.h"
+#include "install-plan.h"
+#include "memory-accounting.h"
 #include "menu.h"
+#include "menu-reload.h"
+#include "trace.h"
 
 #include "string-vector/stringvec.h"
 
+#include <functional>
+#include <future>
 #include <map>
 #include <memory>
+#include <numeric>
+#include <ranges>
+#include <span>
 #include <stack>
 #include <string>
 #include <string_view>
+#include <type_traits>
 #include <vector>
 
 
@@ -61,6 +72,10 @@ class menu_manager
 {
 public:
     using menuptr_t = std::unique_ptr<menu_entry>;
+    using menumap_t =
+        std::map<std::string, menuptr_t, std::less<>,
+                 tracking_allocator<std::pair<const std::string, menuptr_t>,
+                                    memory_category::menu_map>>;
 protected:
     menu_manager() {};
 
@@ -69,6 +84,12 @@ public:
     menu_manager(const menu_manager&&) = delete;
     void operator=(const menu_manager&) = delete;
 
+    // The entries go first, as the sources of unbuilt submenus still report to the manager.
+    ~menu_manager()
+    {
+        m_menuMap.clear();
+    }
+
     [[nodiscard]] static menu_manager* get()
     {
         if (m_instance == nullptr)
@@ -89,6 +110,17 @@ public:
         return m_menuStack.size();
     }
 
+    [[nodiscard]] menu_entry* last() const
+    {
+        return m_last;
+    }
+
+    [[nodiscard]] menu_entry* find(const std::string_view name) const
+    {
+        auto it = m_menuMap.find(name);
+        return it == m_menuMap.end() ? nullptr : it->second.get();
+    }
+
     void pop()
     {
         m_menuStack.pop();
@@ -99,20 +131,44 @@ public:
         m_menuStack.push(newTopEntry);
     }
 
+    // Opens a submenu, building its children first if it is lazy.
+    void enter(menu_entry* entry);
+    // Starts loading a lazy submenu's source in the background, if prefetching is enabled.
+    void prefetch(menu_entry* entry);
+    void set_prefetch(bool enabled)
+    {
+        m_prefetch = enabled;
+    }
+
+    // Selection state for entries that do not exist yet; applied when they are added. Only kept,
+    // and true, while a lazy source may still add them; see menu_manager_source.
+    bool defer_selection(std::string_view name, bool selected);
+
+    // Lazy sources not built yet; the deferred selections are dropped when none is left.
+    void source_added()
+    {
+        m_pendingSources++;
+    }
+    void source_released();
+
     template<typename T, bool replace = false>
     submenu_manager* add(const std::string_view name, submenu_manager* manager)
     {
-        auto [it, _] = m_menuMap.emplace(name, std::make_unique<T>(name));
-        auto entry = std::get<menuptr_t>(*it).get();
+        menu_entry* entry = insert<T>(name);
 
         if(!m_menuStack.empty())
         {
             menu_top_entry* currentMenu = dynamic_cast<menu_top_entry*>(m_menuStack.top());
-            currentMenu->add(entry);
+            if (currentMenu != nullptr)
+            {
+                currentMenu->add(entry);
+            }
         }
 
         if constexpr (replace)
         {
+            // Pushed even when the name belongs to an entry that is not a menu, so that finish()
+            // still pops it; nothing gets added under such an entry.
             m_menuStack.push(entry);
         }
 
@@ -126,11 +182,107 @@ public:
         return add<T, true>(name, m_submenuManager.get());
     }
 
+    // Finds or creates the entry named `name` without adding it to a menu, for a caller that places
+    // it itself.
+    template<typename T>
+    menu_entry* make(const std::string_view name)
+    {
+        return insert<T>(name);
+    }
+
+    // Adds a T per name to the top menu, in one pass. Names that are not sorted already, as package
+    // lists usually are, go into the index in sorted order through a permutation, so that each one
+    // lands right after the previous one without a search. The menu keeps the names' order, makes
+    // room once and has its first entry highlighted once. Entries cannot be submenus, which would
+    // need a manager each. As with add(), nothing is added when the top of the stack is not a menu.
+    template<typename T, std::ranges::random_access_range Range>
+        requires std::ranges::sized_range<Range>
+    void add_all(const Range& names)
+    {
+        static_assert(!std::is_base_of_v<menu_top_entry, T>, "submenus are added one at a time");
+
+        auto* currentMenu = dynamic_cast<menu_top_entry*>(top());
+        if (currentMenu == nullptr)
+        {
+            return;
+        }
+
+        std::size_t count  = std::ranges::size(names);
+        auto        nameAt = [&](std::size_t i) -> std::string_view
+        {
+            return std::ranges::begin(names)[static_cast<std::ptrdiff_t>(i)];
+        };
+
+        if (std::ranges::is_sorted(names, std::less<std::string_view>{}))
+        {
+            std::size_t i = 0;
+            currentMenu->add_all(count,
+                                 [&]
+                                 {
+                                     return insert<T>(nameAt(i++));
+                                 });
+        }
+        else
+        {
+            std::vector<std::size_t> order(count);
+            std::iota(order.begin(), order.end(), std::size_t{0});
+            std::ranges::stable_sort(order, {}, nameAt);
+
+            std::vector<menu_entry*> entries(count);
+            for (std::size_t i : order)
+            {
+                entries[i] = insert<T>(nameAt(i));
+            }
+
+            auto entry = entries.begin();
+            currentMenu->add_all(count,
+                                 [&]
+                                 {
+                                     return *entry++;
+                                 });
+        }
+
+        if (count > 0)
+        {
+            // The last name given, as after the same add() calls.
+            m_last = currentMenu->m_submenus.back();
+        }
+    }
+
+protected:
+    // Finds or creates the entry named `name`; a name already in use keeps its existing entry.
+    // Names coming in increasing order, as from a sorted list, are appended to the index without a
+    // search.
+    template<typename T>
+    menu_entry* insert(const std::string_view name)
+    {
+        std::size_t size = m_menuMap.size();
+        auto        it   = m_menuMap.try_emplace(m_menuMap.end(), std::string{name});
+        if (m_menuMap.size() != size)
+        {
+            it->second = std::make_unique<T>(name);
+        }
+        m_last = it->second.get();
+
+        if (!m_deferredSelections.empty())
+        {
+            apply_deferred_selection(m_last);
+        }
+        return m_last;
+    }
+
+    void apply_deferred_selection(menu_entry* entry);
+
 protected:
     static menu_manager* m_instance;
     std::stack<menu_entry*> m_menuStack{};
-    std::map<std::string, menuptr_t> m_menuMap{};
+    menumap_t m_menuMap{};
     std::unique_ptr<submenu_manager> m_submenuManager{};
+    menu_entry* m_last = nullptr;
+
+    std::map<std::string, bool, std::less<>> m_deferredSelections{};
+    std::size_t                              m_pendingSources = 0;
+    bool                                     m_prefetch       = false;
 };
 
 
@@ -140,28 +292,93 @@ public:
     submenu_manager(menu_manager* mm) : m_mm{mm} {}
     submenu_manager(menu_manager* mm, submenu_manager* parent) : m_mm{mm}, m_parent{parent} {}
 
+    static void* operator new(std::size_t size)
+    {
+        void* p = ::operator new(size);
+        memory_accounting::allocate(memory_category::submenu_chain, size);
+        return p;
+    }
+    static void operator delete(void* p, std::size_t size)
+    {
+        memory_accounting::release(memory_category::submenu_chain, size);
+        ::operator delete(p, size);
+    }
+
     template<typename T>
     submenu_manager* add(const std::string_view name)
     {
         return m_mm->add<T>(name, this);
     }
 
+    // Every line of `filename` becomes a T; options are also packages of the file's package_list,
+    // described by the file's metadata side file when it has one. The menu follows later changes to
+    // the file.
     template<typename T>
     submenu_manager* add_file(const std::string_view filename)
     {
-        stringvec lines{};
-        lines.read_file(filename);
+        return add_file_lines<T>(filename, read_menu_lines(filename));
+    }
 
-        lines.filter_empty();
+    // Same, with the lines of `filename` already read.
+    template<typename T>
+    submenu_manager* add_file_lines(const std::string_view filename, const stringvec& lines)
+    {
+        trace_span span{"add_file", filename};
 
-        for (const std::string_view line : lines)
+        auto* menu = dynamic_cast<menu_top_entry*>(m_mm->top());
+        if (menu == nullptr)
         {
-            m_mm->add<T>(line, this);
+            return this;
         }
 
+        std::size_t   first    = menu->size();
+        package_list* packages = install_planner::get()->list(filename);
+        add_lines<T>(lines, packages);
+
+        menu_reloader::get()->watch(filename, menu,
+                                    std::span<menu_entry* const>{menu->m_submenus}.subspan(first),
+                                    packages,
+                                    [mm = m_mm](std::string_view name)
+                                    {
+                                        return mm->make<T>(name);
+                                    });
         return this;
     }
 
+    template<typename T>
+    submenu_manager* add_lines(const stringvec& lines, package_list* packages = nullptr)
+    {
+        scoped_allocation linesMemory{memory_category::string_vectors,
+                                      heap_bytes_of_strings(lines), lines.size()};
+
+        auto* menu = dynamic_cast<menu_top_entry*>(m_mm->top());
+        if (menu == nullptr)
+        {
+            return this;
+        }
+
+        std::size_t first = menu->size();
+        m_mm->add_all<T>(lines);
+
+        describe(packages, std::span<menu_entry* const>{menu->m_submenus}.subspan(first));
+        return this;
+    }
+
+    // Makes the options among `entries` packages of `packages`, and loads the metadata its file's
+    // side file has for them.
+    static void describe(package_list* packages, std::span<menu_entry* const> entries);
+
+    // Adds a submenu whose children are only built, by `builder`, when it is first entered.
+    template<typename T = menu_top_entry>
+    submenu_manager* add_lazy(const std::string_view name,
+                              std::function<void(submenu_manager*)> builder);
+
+    // Adds a submenu holding one E per line of `filename`, read when it is first entered.
+    template<typename T = menu_top_entry, typename E = menu_option_entry>
+    submenu_manager* add_lazy_file(const std::string_view name, const std::string_view filename);
+
+    static stringvec read_menu_lines(std::string_view filename);
+
     void clean()
     {
         m_child.reset();
@@ -181,6 +398,114 @@ protected:
     std::unique_ptr<submenu_manager> m_child{};
 };
 
+// A source adding entries through a menu_manager, counted by it from creation until it is built or
+// its entry is destroyed.
+class menu_manager_source : public menu_entry_source
+{
+public:
+    explicit menu_manager_source(menu_manager* mm) : m_mm{mm}
+    {
+        m_mm->source_added();
+    }
+    ~menu_manager_source() override
+    {
+        m_mm->source_released();
+    }
+
+    menu_manager_source(const menu_manager_source&) = delete;
+    void operator=(const menu_manager_source&)      = delete;
+
+protected:
+    menu_manager* m_mm;
+};
+
+class menu_builder_source : public menu_manager_source
+{
+public:
+    menu_builder_source(menu_manager* mm, std::function<void(submenu_manager*)> builder) :
+        menu_manager_source{mm}, m_builder{std::move(builder)}
+    {
+    }
+
+    void build(menu_top_entry& parent) override
+    {
+        m_mm->set_top(&parent);
+        submenu_manager manager{m_mm};
+        m_builder(&manager);
+        m_mm->pop();
+    }
+
+protected:
+    std::function<void(submenu_manager*)> m_builder;
+};
+
+
+template<typename E>
+class menu_file_source : public menu_manager_source
+{
+public:
+    menu_file_source(menu_manager* mm, std::string_view filename) :
+        menu_manager_source{mm}, m_filename{filename}
+    {
+    }
+
+    void prefetch() override
+    {
+        if (!m_lines.valid())
+        {
+            m_lines = std::async(std::launch::async, &submenu_manager::read_menu_lines, m_filename);
+        }
+    }
+
+    void build(menu_top_entry& parent) override
+    {
+        stringvec lines =
+            m_lines.valid() ? m_lines.get() : submenu_manager::read_menu_lines(m_filename);
+
+        m_mm->set_top(&parent);
+        submenu_manager manager{m_mm};
+        manager.add_file_lines<E>(m_filename, lines);
+        m_mm->pop();
+    }
+
+protected:
+    std::string            m_filename;
+    std::future<stringvec> m_lines{};
+};
+
+
+template<typename T>
+submenu_manager* submenu_manager::add_lazy(const std::string_view name,
+                                           std::function<void(submenu_manager*)> builder)
+{
+    m_mm->add<T>(name, this);
+    // A name already used by an entry that is not a menu keeps that entry, which gets no source.
+    if (auto* menu = dynamic_cast<menu_top_entry*>(m_mm->last()); menu != nullptr)
+    {
+        menu->set_source(std::make_unique<menu_builder_source>(m_mm, std::move(builder)));
+    }
+    return this;
+}
+
+template<typename T, typename E>
+submenu_manager* submenu_manager::add_lazy_file(const std::string_view name,
+                                                const std::string_view filename)
+{
+    m_mm->add<T>(name, this);
+    if (auto* menu = dynamic_cast<menu_top_entry*>(m_mm->last()); menu != nullptr)
+    {
+        menu->set_source(std::make_unique<menu_file_source<E>>(m_mm, filename));
+    }
+    return this;
+}
+
+
+// Submenus open a child manager; these must be visible before any translation unit instantiates add.
+template<>
+submenu_manager* submenu_manager::add<menu_top_entry>(const std::string_view name);
+template<>
+submenu_manager* submenu_manager::add<menu_top_option_entry>(const std::string_view name);
+
 
 #endif  // MENU_MANAGER_H
 /**
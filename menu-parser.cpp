@@ -0,0 +1,404 @@
+/**
+ * ===============================================================================================
+ * @file    menu-parser.cpp
+ * @author  Pascal-Emmanuel Lachance
+ * @p       <a href="https://www.github.com/Raesangur">Raesangur</a>
+ * @p       <a href="https://www.raesangur.com/">https://www.raesangur.com/</a>
+ *
+ * @brief   Streaming parser for nested menu description files.
+ *
+ * ------------------------------------------------------------------------------------------------
+ * @copyright Copyright (c) 2023 Pascal-Emmanuel Lachance | Raesangur
+ *
+ * @par License: <a href="https://opensource.org/license/mit/"> MIT </a>
+ *               This project is released under the MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ * BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NON INFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ * ===============================================================================================
+ */
+
+/** ===============================================================================================
+ *  INCLUDES
+ */
+#include "menu-parser.h"
+
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+
+
+/** ===============================================================================================
+ *  CONSTANTS
+ */
+
+constexpr int         TAB_WIDTH       = 4;
+constexpr std::size_t READ_CHUNK_SIZE = 64 * 1024;
+
+constexpr std::string_view COMMAND_SEPARATOR   = " => ";
+constexpr std::string_view INSTALLER_ATTRIBUTE = "installer=";
+
+
+/** ===============================================================================================
+ *  LOCAL FUNCTIONS
+ */
+
+static std::string_view trim_right(std::string_view str)
+{
+    while (!str.empty() && (str.back() == ' ' || str.back() == '\t' || str.back() == '\r'))
+    {
+        str.remove_suffix(1);
+    }
+    return str;
+}
+
+// Names are unique: a submenu can only be added under a name that is free or already a menu's.
+static bool can_be_menu(const menu_manager* mm, std::string_view name)
+{
+    menu_entry* entry = mm->find(name);
+    return entry == nullptr || dynamic_cast<menu_top_entry*>(entry) != nullptr;
+}
+
+
+/** ===============================================================================================
+ *  MEMBER FUNCTIONS DEFINITIONS
+ */
+
+void menu_parser::feed(std::string_view chunk)
+{
+    if (!m_carry.empty())
+    {
+        const char* newline = static_cast<const char*>(std::memchr(chunk.data(), '\n', chunk.size()));
+        if (newline == nullptr)
+        {
+            m_carry.append(chunk);
+            return;
+        }
+
+        std::size_t length = static_cast<std::size_t>(newline - chunk.data());
+        m_carry.append(chunk.substr(0, length));
+        parse_line(m_carry);
+        m_carry.clear();
+        chunk.remove_prefix(length + 1);
+    }
+
+    while (!chunk.empty())
+    {
+        const char* newline = static_cast<const char*>(std::memchr(chunk.data(), '\n', chunk.size()));
+        if (newline == nullptr)
+        {
+            // Keep the incomplete line until the next chunk completes it.
+            m_carry.assign(chunk);
+            return;
+        }
+
+        std::size_t length = static_cast<std::size_t>(newline - chunk.data());
+        parse_line(chunk.substr(0, length));
+        chunk.remove_prefix(length + 1);
+    }
+}
+
+[[nodiscard]] menu_parse_result menu_parser::finish()
+{
+    if (!m_carry.empty())
+    {
+        parse_line(m_carry);
+        m_carry.clear();
+    }
+
+    if (m_result.ok && m_frames.empty())
+    {
+        fail("no root menu found");
+    }
+
+    // Close every open submenu except the root, which stays on top of the menu stack.
+    while (m_result.ok && m_frames.size() > 1)
+    {
+        close_submenu();
+    }
+
+    return m_result;
+}
+
+
+void menu_parser::parse_line(std::string_view line)
+{
+    if (!m_result.ok)
+    {
+        return;
+    }
+    m_result.line++;
+
+    int         indent = 0;
+    std::size_t pos    = 0;
+    for (; pos < line.size() && (line[pos] == ' ' || line[pos] == '\t'); pos++)
+    {
+        indent += line[pos] == '\t' ? TAB_WIDTH : 1;
+    }
+
+    line = trim_right(line.substr(pos));
+    if (line.empty() || line.front() == '#')
+    {
+        return;
+    }
+
+    std::size_t      split = line.find_first_of(" \t");
+    std::string_view kind  = line.substr(0, split);
+    std::string_view name  = split == std::string_view::npos ? std::string_view{} : line.substr(split);
+    name.remove_prefix(std::min(name.find_first_not_of(" \t"), name.size()));
+
+    bool             selected = false;
+    bool             lazy     = false;
+    std::string_view installer{};
+    std::size_t      colon = kind.find(':');
+    if (colon != std::string_view::npos)
+    {
+        std::string_view attributes = kind.substr(colon + 1);
+        kind                        = kind.substr(0, colon);
+
+        while (!attributes.empty())
+        {
+            std::size_t      comma     = attributes.find(',');
+            std::string_view attribute = attributes.substr(0, comma);
+            if (attribute == "selected")
+            {
+                selected = true;
+            }
+            else if (attribute == "lazy")
+            {
+                lazy = true;
+            }
+            else if (attribute.starts_with(INSTALLER_ATTRIBUTE))
+            {
+                installer = attribute.substr(INSTALLER_ATTRIBUTE.size());
+            }
+            else
+            {
+                return fail("unknown attribute '" + std::string{attribute} + "'");
+            }
+            attributes.remove_prefix(comma == std::string_view::npos ? attributes.size() : comma + 1);
+        }
+    }
+
+    std::string_view command{};
+    std::size_t      arrow = name.find(COMMAND_SEPARATOR);
+    if (arrow != std::string_view::npos)
+    {
+        if (kind != "option")
+        {
+            return fail("only 'option' entries can run a command");
+        }
+        command = name.substr(arrow + COMMAND_SEPARATOR.size());
+        command.remove_prefix(std::min(command.find_first_not_of(" \t"), command.size()));
+        name = trim_right(name.substr(0, arrow));
+    }
+
+    if (name.empty())
+    {
+        return fail("missing name after '" + std::string{kind} + "'");
+    }
+
+    if (m_frames.empty())
+    {
+        if (kind != "menu" || selected || lazy || !installer.empty())
+        {
+            return fail("the first entry must be a plain 'menu'");
+        }
+        if (!can_be_menu(m_mm, name))
+        {
+            return fail("'" + std::string{name} + "' is already an entry that is not a menu");
+        }
+        m_current = m_mm->add<menu_top_entry>(name);
+        m_frames.push_back(frame{indent, m_mm->last(), false});
+        m_entries++;
+        return;
+    }
+
+    if (m_leafIndent >= 0 && indent > m_leafIndent)
+    {
+        return fail("only 'menu' and 'group' entries can have children");
+    }
+
+    while (m_frames.size() > 1 && indent <= m_frames.back().indent)
+    {
+        close_submenu();
+    }
+    if (indent <= m_frames.front().indent)
+    {
+        return fail("only one root menu is allowed");
+    }
+    // A dedent must line up with the entries of a menu still open.
+    if (int& children = m_frames.back().children; children < 0)
+    {
+        children = indent;
+    }
+    else if (indent != children)
+    {
+        return fail("the indentation matches no open menu");
+    }
+
+    m_leafIndent = indent;
+    if (lazy && kind != "file")
+    {
+        return fail("only 'file' entries can be lazy");
+    }
+    if (!installer.empty() && kind != "file")
+    {
+        return fail("only 'file' entries can have an installer");
+    }
+
+    if (kind == "menu" || kind == "group")
+    {
+        if (selected && kind == "menu")
+        {
+            return fail("'menu' entries cannot be selected");
+        }
+        if (!can_be_menu(m_mm, name))
+        {
+            return fail("'" + std::string{name} + "' is already an entry that is not a menu");
+        }
+        for (const frame& open : m_frames)
+        {
+            if (open.entry->get_name() == name)
+            {
+                return fail("'" + std::string{name} + "' cannot be inside itself");
+            }
+        }
+        m_current = kind == "menu" ? m_current->add<menu_top_entry>(name)
+                                   : m_current->add<menu_top_option_entry>(name);
+        m_frames.push_back(frame{indent, m_mm->last(), selected});
+        m_leafIndent = -1;
+        m_entries++;
+        return;
+    }
+    else if (kind == "option")
+    {
+        m_current->add<menu_option_entry>(name);
+        if (!command.empty())
+        {
+            // Names are unique, so an earlier entry of another kind may be what was added.
+            auto* option = dynamic_cast<menu_option_entry*>(m_mm->last());
+            if (option == nullptr)
+            {
+                return fail("'" + std::string{name} + "' is already an entry without a command");
+            }
+            option->set_command(command);
+        }
+    }
+    else if (kind == "text")
+    {
+        m_current->add<menu_text_entry>(name);
+    }
+    else if (kind == "input")
+    {
+        m_current->add<menu_input_entry>(name);
+    }
+    else if (kind == "file")
+    {
+        if (selected)
+        {
+            return fail("'file' entries cannot be selected");
+        }
+        if (!installer.empty() && !install_planner::get()->set_list_installer(name, installer))
+        {
+            return fail("unknown installer '" + std::string{installer} + "'");
+        }
+        if (lazy)
+        {
+            auto* parent = dynamic_cast<menu_top_entry*>(m_frames.back().entry);
+            if (parent == nullptr || !parent->is_materialized())
+            {
+                return fail("a menu can only have one lazy 'file'");
+            }
+            parent->set_source(std::make_unique<menu_file_source<menu_option_entry>>(m_mm, name));
+        }
+        else
+        {
+            m_current->add_file<menu_option_entry>(name);
+        }
+        m_entries++;
+        return;
+    }
+    else
+    {
+        return fail("unknown entry kind '" + std::string{kind} + "'");
+    }
+    m_entries++;
+
+    if (selected)
+    {
+        menu_entry* entry = m_mm->last();
+        if (!entry->can_select())
+        {
+            return fail("'" + std::string{kind} + "' entries cannot be selected");
+        }
+        entry->select();
+    }
+}
+
+void menu_parser::close_submenu()
+{
+    // A group's children are added after the group itself, so its selection is applied on close.
+    if (m_frames.back().selected)
+    {
+        m_frames.back().entry->select();
+    }
+    m_frames.pop_back();
+    m_current = m_current->finish();
+}
+
+void menu_parser::fail(const std::string& message)
+{
+    m_result.ok    = false;
+    m_result.error = message;
+}
+
+
+menu_parse_result menu_parser::parse(std::string_view text, menu_manager* mm)
+{
+    menu_parser parser{mm};
+    parser.feed(text);
+    return parser.finish();
+}
+
+menu_parse_result menu_parser::parse_file(const std::string& filename, menu_manager* mm)
+{
+    int fd = ::open(filename.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+    {
+        return menu_parse_result{false, 0, "cannot open '" + filename + "'"};
+    }
+
+    menu_parser       parser{mm};
+    std::vector<char> buffer(READ_CHUNK_SIZE);
+
+    ssize_t count = 0;
+    while ((count = ::read(fd, buffer.data(), buffer.size())) > 0)
+    {
+        parser.feed(std::string_view{buffer.data(), static_cast<std::size_t>(count)});
+    }
+    ::close(fd);
+
+    if (count < 0)
+    {
+        return menu_parse_result{false, parser.m_result.line, "error reading '" + filename + "'"};
+    }
+    return parser.finish();
+}
+
+
+/**
+ * ------------------------------------------------------------------------------------------------
+ */
@@ -0,0 +1,132 @@
+/**
+ * ===============================================================================================
+ * @file    menu-parser.h
+ * @author  Pascal-Emmanuel Lachance
+ * @p       <a href="https://www.github.com/Raesangur">Raesangur</a>
+ * @p       <a href="https://www.raesangur.com/">https://www.raesangur.com/</a>
+ *
+ * @brief   Streaming parser for nested menu description files.
+ *
+ * ------------------------------------------------------------------------------------------------
+ * @copyright Copyright (c) 2023 Pascal-Emmanuel Lachance | Raesangur
+ *
+ * @par License: <a href="https://opensource.org/license/mit/"> MIT </a>
+ *               This project is released under the MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ * BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NON INFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ * ------------------------------------------------------------------------------------------------
+ * @details
+ * A menu file describes one entry per line, nested by indentation:
+ *
+ *      # Comments and blank lines are ignored
+ *      menu Main Menu
+ *          group:selected Setup git
+ *              option Configure ssh key for authentication
+ *          menu Install packages
+ *              group C++ development
+ *                  file packages/cpp-dev.txt
+ *
+ * Each line is `<kind>[:<attribute>,...] <name>`. The kinds are:
+ *  - `menu`    a menu_top_entry, which can be entered;
+ *  - `group`   a menu_top_option_entry, which can be entered and selected as a whole;
+ *  - `option`  a menu_option_entry; `option <name> => <command>` also gives it a shell command;
+ *  - `text`    a menu_text_entry;
+ *  - `input`   a menu_input_entry, a free-text field edited by entering it;
+ *  - `file`    every non-empty line of the named file becomes a menu_option_entry, with the columns
+ *              of the file's `.meta` side file when it has one (see entry-metadata.h).
+ *
+ * Three attributes are understood: `selected` selects the entry once it is built and, only on
+ * `file` entries, `lazy` defers reading the file until the enclosing menu or group is first used and
+ * `installer=<name>` names the installer of the file's packages (see install-plan.h).
+ * The file must contain a single `menu` at indentation 0, the root of the tree.
+ *
+ * The parser is fed in chunks and builds the tree through the submenu_manager chain as it goes:
+ * no intermediate representation is kept, and a line is only copied when it straddles two chunks.
+ * ===============================================================================================
+ */
+#ifndef MENU_PARSER_H
+#define MENU_PARSER_H
+
+
+/** ===============================================================================================
+ *  INCLUDES
+ */
+#include "menu-manager.h"
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+
+
+/** ===============================================================================================
+ *  CLASS DEFINITION
+ */
+
+struct menu_parse_result
+{
+    bool        ok   = true;
+    std::size_t line = 0;
+    std::string error{};
+};
+
+
+class menu_parser
+{
+public:
+    menu_parser(menu_manager* mm) : m_mm{mm} {}
+
+    void feed(std::string_view chunk);
+    [[nodiscard]] menu_parse_result finish();
+
+    [[nodiscard]] std::size_t entries() const
+    {
+        return m_entries;
+    }
+
+    static menu_parse_result parse(std::string_view text, menu_manager* mm);
+    static menu_parse_result parse_file(const std::string& filename, menu_manager* mm);
+
+protected:
+    struct frame
+    {
+        int         indent   = 0;
+        menu_entry* entry    = nullptr;
+        bool        selected = false;
+        int         children = -1;    //!< Indentation of its entries, once the first one is read.
+    };
+
+    void parse_line(std::string_view line);
+    void close_submenu();
+    void fail(const std::string& message);
+
+protected:
+    menu_manager*    m_mm      = nullptr;
+    submenu_manager* m_current = nullptr;
+
+    std::vector<frame> m_frames{};
+    int                m_leafIndent = -1;
+    std::string        m_carry{};
+
+    std::size_t       m_entries = 0;
+    menu_parse_result m_result{};
+};
+
+
+#endif  // MENU_PARSER_H
+/**
+ * ------------------------------------------------------------------------------------------------
+ */
@@ -0,0 +1,464 @@
+/**
+ * ===============================================================================================
+ * @file    menu-reload.cpp
+ * @author  Pascal-Emmanuel Lachance
+ * @p       <a href="https://www.github.com/Raesangur">Raesangur</a>
+ * @p       <a href="https://www.raesangur.com/">https://www.raesangur.com/</a>
+ *
+ * @brief   Keeps menus built from list files in step with the files.
+ *
+ * ------------------------------------------------------------------------------------------------
+ * @copyright Copyright (c) 2023 Pascal-Emmanuel Lachance | Raesangur
+ *
+ * @par License: <a href="https://opensource.org/license/mit/"> MIT </a>
+ *               This project is released under the MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ * BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NON INFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ * ===============================================================================================
+ */
+/** ===============================================================================================
+ *  INCLUDES
+ */
+#include "menu-reload.h"
+
+#include "entry-metadata.h"
+#include "menu-manager.h"
+
+#include <algorithm>
+#include <chrono>
+#include <optional>
+#include <unistd.h>
+#include <unordered_set>
+
+
+/** ===============================================================================================
+ *  CONSTANTS
+ */
+
+// Editors write a file in several steps, or through a temporary file; read it once they are done.
+constexpr auto SETTLE_DELAY = std::chrono::milliseconds{100};
+
+
+/** ===============================================================================================
+ *  LOCAL FUNCTIONS
+ */
+
+// `length` equal lines, from line x of the old text and line y of the new one.
+struct common_run
+{
+    std::ptrdiff_t x      = 0;
+    std::ptrdiff_t y      = 0;
+    std::ptrdiff_t length = 0;
+};
+
+// Myers' shortest edit script between `a` and `b`, as the runs of lines they share, in order.
+// Returns false when more than `maxEdits` edits are needed.
+static bool shortest_edit(std::span<const std::uint64_t> a,
+                          std::span<const std::uint64_t> b,
+                          std::size_t                    maxEdits,
+                          std::vector<common_run>&       runs)
+{
+    const auto n     = static_cast<std::ptrdiff_t>(a.size());
+    const auto m     = static_cast<std::ptrdiff_t>(b.size());
+    const auto limit = std::min(n + m, static_cast<std::ptrdiff_t>(maxEdits));
+
+    // v[offset + k] is the furthest x reached on the diagonal k = x - y. trace[d] keeps v[-d..d] as
+    // it was after d edits, to walk the path back once the end is reached.
+    const std::ptrdiff_t                     offset = limit + 1;
+    std::vector<std::ptrdiff_t>              v(static_cast<std::size_t>(2 * limit + 3), 0);
+    std::vector<std::vector<std::ptrdiff_t>> trace{};
+
+    auto furthest = [&](std::ptrdiff_t d, std::ptrdiff_t k)
+    {
+        return trace[static_cast<std::size_t>(d)][static_cast<std::size_t>(k + d)];
+    };
+    // Whether the best path to diagonal k comes from k + 1, inserting a line, or from k - 1.
+    auto goes_down = [](std::ptrdiff_t d, std::ptrdiff_t k, std::ptrdiff_t left,
+                        std::ptrdiff_t right)
+    {
+        return k == -d || (k != d && left < right);
+    };
+
+    for (std::ptrdiff_t d = 0; d <= limit; d++)
+    {
+        bool done = false;
+        for (std::ptrdiff_t k = -d; k <= d && !done; k += 2)
+        {
+            std::ptrdiff_t left  = v[static_cast<std::size_t>(offset + k - 1)];
+            std::ptrdiff_t right = v[static_cast<std::size_t>(offset + k + 1)];
+            std::ptrdiff_t x     = goes_down(d, k, left, right) ? right : left + 1;
+            std::ptrdiff_t y     = x - k;
+            while (x < n && y < m &&
+                   a[static_cast<std::size_t>(x)] == b[static_cast<std::size_t>(y)])
+            {
+                x++;
+                y++;
+            }
+            v[static_cast<std::size_t>(offset + k)] = x;
+            done                                    = x >= n && y >= m;
+        }
+        trace.emplace_back(v.begin() + offset - d, v.begin() + offset + d + 1);
+        if (!done)
+        {
+            continue;
+        }
+
+        std::ptrdiff_t x = n;
+        std::ptrdiff_t y = m;
+        for (; d > 0; d--)
+        {
+            std::ptrdiff_t k     = x - y;
+            bool           down  = goes_down(d, k, k - 1 >= -(d - 1) ? furthest(d - 1, k - 1) : 0,
+                                             k + 1 <= d - 1 ? furthest(d - 1, k + 1) : 0);
+            std::ptrdiff_t prevK = down ? k + 1 : k - 1;
+            std::ptrdiff_t prevX = furthest(d - 1, prevK);
+
+            // The edit leads from the previous point to `start`, then equal lines lead to (x, y).
+            std::ptrdiff_t startX = down ? prevX : prevX + 1;
+            if (x > startX)
+            {
+                runs.push_back(common_run{startX, startX - k, x - startX});
+            }
+            x = prevX;
+            y = prevX - prevK;
+        }
+        if (x > 0)
+        {
+            runs.push_back(common_run{0, 0, x});
+        }
+        std::reverse(runs.begin(), runs.end());
+        return true;
+    }
+    return false;
+}
+
+
+/** ===============================================================================================
+ *  SINGLETON INSTANCE
+ */
+menu_reloader* menu_reloader::m_instance = nullptr;
+
+
+/** ===============================================================================================
+ *  MEMBER FUNCTIONS DEFINITIONS
+ */
+
+menu_reloader::menu_reloader() : m_watcher{SETTLE_DELAY}
+{
+}
+
+[[nodiscard]] menu_reloader* menu_reloader::get()
+{
+    if (m_instance == nullptr)
+    {
+        m_instance = new menu_reloader;
+    }
+    return m_instance;
+}
+
+
+void menu_reloader::watch(std::string_view             filename,
+                          menu_top_entry*              menu,
+                          std::span<menu_entry* const> entries,
+                          package_list*                packages,
+                          entry_factory                make)
+{
+    auto file      = std::make_unique<watched_file>();
+    file->filename = filename;
+    file->menu     = menu;
+    file->packages = packages;
+    file->make     = std::move(make);
+    file->entries.assign(entries.begin(), entries.end());
+    file->hashes.reserve(entries.size());
+    for (const menu_entry* entry : entries)
+    {
+        file->hashes.push_back(line_hash(entry->get_name()));
+    }
+    m_files.push_back(std::move(file));
+
+    // The action is started with the first file, as most trees do not read any.
+    if (m_watcher.add(filename) && !m_watching)
+    {
+        m_watching = true;
+        event_loop::get()->spawn_service(watch_files());
+    }
+}
+
+
+reload_summary menu_reloader::apply()
+{
+    reload_summary summary{};
+    if (!m_hasPending.load(std::memory_order_acquire))
+    {
+        return summary;
+    }
+
+    std::map<std::string, file_text> pending{};
+    {
+        std::lock_guard lock{m_mutex};
+        pending.swap(m_pending);
+        m_hasPending.store(false, std::memory_order_relaxed);
+    }
+
+    for (const auto& [filename, text] : pending)
+    {
+        // The same file may have been added to several menus.
+        for (const std::unique_ptr<watched_file>& file : m_files)
+        {
+            if (file->filename == filename && reload(*file, text, summary))
+            {
+                summary.files++;
+            }
+        }
+    }
+    return summary;
+}
+
+
+action menu_reloader::watch_files()
+{
+    while (true)
+    {
+        std::set<std::string> changed{};
+        co_await m_watcher.changes(changed);
+
+        for (const std::string& filename : changed)
+        {
+            // A file that is gone, perhaps only for the moment, leaves its menu as it is.
+            std::optional<file_text> text = co_await offload{
+              [&filename]() -> std::optional<file_text>
+              {
+                  if (::access(filename.c_str(), R_OK) != 0)
+                  {
+                      return std::nullopt;
+                  }
+
+                  file_text read{submenu_manager::read_menu_lines(filename)};
+                  read.hashes.reserve(read.lines.size());
+                  for (const std::string& line : read.lines)
+                  {
+                      read.hashes.push_back(line_hash(line));
+                  }
+                  return read;
+              }};
+
+            if (text.has_value())
+            {
+                std::lock_guard lock{m_mutex};
+                m_pending.insert_or_assign(filename, std::move(*text));
+                m_hasPending.store(true, std::memory_order_release);
+            }
+        }
+    }
+}
+
+bool menu_reloader::reload(watched_file& file, const file_text& text, reload_summary& summary)
+{
+    std::vector<line_hunk> hunks = diff_lines(file.hashes, text.hashes);
+    if (hunks.empty())
+    {
+        return false;
+    }
+
+    std::vector<menu_entry*> removed{};
+    std::vector<menu_entry*> inserted{};
+
+    // From the last hunk back, so that the line numbers of the earlier ones still hold.
+    for (auto hunk = hunks.rbegin(); hunk != hunks.rend(); ++hunk)
+    {
+        std::vector<menu_entry*> entries{};
+        entries.reserve(hunk->newCount);
+        for (std::size_t i = hunk->newBegin; i < hunk->newBegin + hunk->newCount; i++)
+        {
+            entries.push_back(file.make(text.lines[i]));
+        }
+
+        auto first = file.entries.begin() + static_cast<std::ptrdiff_t>(hunk->oldBegin);
+        auto last  = first + static_cast<std::ptrdiff_t>(hunk->oldCount);
+        removed.insert(removed.end(), first, last);
+        inserted.insert(inserted.end(), entries.begin(), entries.end());
+
+        place(file, *hunk, entries);
+        first = file.entries.erase(first, last);
+        file.entries.insert(first, entries.begin(), entries.end());
+
+        auto hashes    = file.hashes.begin() + static_cast<std::ptrdiff_t>(hunk->oldBegin);
+        auto newHashes = text.hashes.begin() + static_cast<std::ptrdiff_t>(hunk->newBegin);
+        hashes = file.hashes.erase(hashes, hashes + static_cast<std::ptrdiff_t>(hunk->oldCount));
+        file.hashes.insert(hashes, newHashes,
+                           newHashes + static_cast<std::ptrdiff_t>(hunk->newCount));
+    }
+
+    // An entry both removed and inserted only moved, and keeps its selection and its package.
+    std::unordered_set<const menu_entry*> moved(inserted.begin(), inserted.end());
+    std::vector<menu_entry*>              gone{};
+    for (menu_entry* entry : removed)
+    {
+        if (moved.contains(entry))
+        {
+            continue;
+        }
+        gone.push_back(entry);
+        if (entry->can_select() && entry->is_selected())
+        {
+            entry->deselect();
+        }
+    }
+    if (file.packages != nullptr && !gone.empty())
+    {
+        // Packages are compared as they are stored: converting each one to a menu_entry would read
+        // every entry, since the base is virtual.
+        std::vector<const menu_option_entry*> goneOptions{};
+        for (const menu_entry* entry : gone)
+        {
+            if (auto* option = dynamic_cast<const menu_option_entry*>(entry); option != nullptr)
+            {
+                goneOptions.push_back(option);
+            }
+        }
+        std::sort(goneOptions.begin(), goneOptions.end());
+
+        install_planner::get()->remove_packages(file.packages, goneOptions);
+    }
+
+    std::unordered_set<const menu_entry*> known(removed.begin(), removed.end());
+    std::erase_if(inserted,
+                  [&](const menu_entry* entry)
+                  {
+                      return known.contains(entry);
+                  });
+    submenu_manager::describe(file.packages, inserted);
+
+    summary.inserted += inserted.size();
+    summary.removed += gone.size();
+
+    // Sort orders cached for the menu no longer hold its entries.
+    entry_metadata::get()->forget(file.menu);
+    m_generation++;
+    return true;
+}
+
+void menu_reloader::place(watched_file&                file,
+                          const line_hunk&             hunk,
+                          std::span<menu_entry* const> inserted)
+{
+    menu_top_entry* menu     = file.menu;
+    auto            position = [menu](const menu_entry* entry)
+    {
+        auto it = std::find(menu->begin(), menu->end(), entry);
+        return static_cast<std::size_t>(it - menu->begin());
+    };
+
+    std::span<menu_entry* const> removed{file.entries.data() + hunk.oldBegin, hunk.oldCount};
+    if (!removed.empty())
+    {
+        // In file order, the menu holds the removed lines as one block, replaced in one splice.
+        std::size_t index = position(removed.front());
+        auto        block = menu->begin() + static_cast<std::ptrdiff_t>(index);
+        if (index + removed.size() <= menu->size() &&
+            std::equal(removed.begin(), removed.end(), block))
+        {
+            menu->splice(index, removed.size(), inserted);
+            return;
+        }
+
+        // A sorted menu has them scattered.
+        for (const menu_entry* entry : removed)
+        {
+            if (std::size_t at = position(entry); at < menu->size())
+            {
+                menu->splice(at, 1, {});
+            }
+        }
+    }
+
+    // New lines go after the line before them, or else before the line after them.
+    std::size_t index = menu->size();
+    if (hunk.oldBegin > 0)
+    {
+        index = std::min(position(file.entries[hunk.oldBegin - 1]) + 1, menu->size());
+    }
+    else if (hunk.oldCount < file.entries.size())
+    {
+        index = position(file.entries[hunk.oldCount]);
+    }
+    menu->splice(index, 0, inserted);
+}
+
+
+/** ===============================================================================================
+ *  FUNCTION DEFINITIONS
+ */
+
+[[nodiscard]] std::uint64_t line_hash(std::string_view line)
+{
+    return std::hash<std::string_view>{}(line);
+}
+
+[[nodiscard]] std::vector<line_hunk> diff_lines(std::span<const std::uint64_t> before,
+                                                std::span<const std::uint64_t> after,
+                                                std::size_t                    maxEdits)
+{
+    std::size_t prefix = 0;
+    while (prefix < before.size() && prefix < after.size() && before[prefix] == after[prefix])
+    {
+        prefix++;
+    }
+    std::size_t suffix = 0;
+    while (suffix < before.size() - prefix && suffix < after.size() - prefix &&
+           before[before.size() - 1 - suffix] == after[after.size() - 1 - suffix])
+    {
+        suffix++;
+    }
+
+    std::span<const std::uint64_t> a = before.subspan(prefix, before.size() - prefix - suffix);
+    std::span<const std::uint64_t> b = after.subspan(prefix, after.size() - prefix - suffix);
+
+    std::vector<line_hunk> hunks{};
+    if (a.empty() && b.empty())
+    {
+        return hunks;
+    }
+
+    std::vector<common_run> runs{};
+    if (a.empty() || b.empty() || !shortest_edit(a, b, maxEdits, runs))
+    {
+        runs.clear();
+    }
+
+    // Hunks are the gaps between the common runs; a last empty run closes the final one.
+    runs.push_back(common_run{static_cast<std::ptrdiff_t>(a.size()),
+                              static_cast<std::ptrdiff_t>(b.size()), 0});
+    std::size_t x = 0;
+    std::size_t y = 0;
+    for (const common_run& run : runs)
+    {
+        auto runX = static_cast<std::size_t>(run.x);
+        auto runY = static_cast<std::size_t>(run.y);
+        if (runX > x || runY > y)
+        {
+            hunks.push_back(line_hunk{prefix + x, runX - x, prefix + y, runY - y});
+        }
+        x = runX + static_cast<std::size_t>(run.length);
+        y = runY + static_cast<std::size_t>(run.length);
+    }
+    return hunks;
+}
+
+
+/**
+ * ------------------------------------------------------------------------------------------------
+ */
@@ -0,0 +1,197 @@
+/**
+ * ===============================================================================================
+ * @file    menu-reload.h
+ * @author  Pascal-Emmanuel Lachance
+ * @p       <a href="https://www.github.com/Raesangur">Raesangur</a>
+ * @p       <a href="https://www.raesangur.com/">https://www.raesangur.com/</a>
+ *
+ * @brief   Keeps menus built from list files in step with the files.
+ *
+ * ------------------------------------------------------------------------------------------------
+ * @copyright Copyright (c) 2023 Pascal-Emmanuel Lachance | Raesangur
+ *
+ * @par License: <a href="https://opensource.org/license/mit/"> MIT </a>
+ *               This project is released under the MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ * BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NON INFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ * ------------------------------------------------------------------------------------------------
+ * @details
+ * Every file given to submenu_manager::add_file, lazy ones included once they are read, is watched
+ * with a file_watcher from an action on the event loop. When one changes, it is read again on the
+ * thread pool, and the interface thread compares the new lines with the entries the file produced
+ * last time. Only the lines that differ are applied to the menu: a removed line takes its entry out
+ * of the menu, an added one inserts an entry where the line now is. Entries that stay keep their
+ * place in the menu_manager index, their selection and their highlight, and the menu stack is left
+ * alone, so the menu being browsed simply gains or loses rows.
+ *
+ * Lines are compared by a 64-bit hash, kept for the loaded lines and computed on the thread pool
+ * for the new ones, so that the comparison never visits the entries themselves; two different lines
+ * with the same hash would be taken as equal, a risk small enough to ignore. The common prefix and
+ * suffix are trimmed first, so a single edit anywhere costs one pass over two arrays of integers.
+ * What remains is compared with Myers' algorithm, in time proportional to the lines times the
+ * number of edits. Past MAX_DIFF_EDITS edits, such as when a list is sorted anew, the remaining
+ * range is replaced as a whole, which still keeps the selection of the entries it shares with the
+ * new lines since entries are found again by name.
+ *
+ * A removed entry stays in the index, unlinked, so that a line coming back finds it again; it is
+ * deselected unless it only moved. A file that disappears is ignored until it comes back.
+ * ===============================================================================================
+ */
+#ifndef MENU_RELOAD_H
+#define MENU_RELOAD_H
+
+
+/** ===============================================================================================
+ *  INCLUDES
+ */
+#include "action.h"
+#include "file-watcher.h"
+#include "install-plan.h"
+#include "memory-accounting.h"
+#include "menu.h"
+
+#include "string-vector/stringvec.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+
+/** ===============================================================================================
+ *  CONSTANTS
+ */
+
+constexpr std::size_t MAX_DIFF_EDITS = 256;
+
+
+/** ===============================================================================================
+ *  CLASS DEFINITION
+ */
+
+// Lines [oldBegin, oldBegin + oldCount) of the old text become [newBegin, newBegin + newCount).
+struct line_hunk
+{
+    std::size_t oldBegin = 0;
+    std::size_t oldCount = 0;
+    std::size_t newBegin = 0;
+    std::size_t newCount = 0;
+};
+
+struct reload_summary
+{
+    std::size_t files    = 0;
+    std::size_t inserted = 0;
+    std::size_t removed  = 0;
+};
+
+
+class menu_reloader
+{
+protected:
+    menu_reloader();
+
+public:
+    // Finds or creates the entry for a new line, of the type the file was added with.
+    using entry_factory = std::function<menu_entry*(std::string_view)>;
+
+    menu_reloader(const menu_reloader&)  = delete;
+    menu_reloader(const menu_reloader&&) = delete;
+    void operator=(const menu_reloader&) = delete;
+
+    [[nodiscard]] static menu_reloader* get();
+
+    // Starts following `filename`, whose lines were just added to `menu` as `entries`.
+    void watch(std::string_view filename, menu_top_entry* menu,
+               std::span<menu_entry* const> entries, package_list* packages, entry_factory make);
+
+    // Applies the files read again since the last call; interface thread only.
+    reload_summary apply();
+
+    // Bumped each time a menu was changed by apply().
+    [[nodiscard]] std::uint64_t generation() const
+    {
+        return m_generation;
+    }
+
+protected:
+    template<typename T>
+    using tracked_vector = std::vector<T, tracking_allocator<T, memory_category::watched_files>>;
+
+    struct watched_file
+    {
+        std::string                   filename{};
+        menu_top_entry*               menu     = nullptr;
+        package_list*                 packages = nullptr;
+        entry_factory                 make{};
+        tracked_vector<menu_entry*>   entries{};    //!< One per line, in file order.
+        tracked_vector<std::uint64_t> hashes{};     //!< line_hash() of each entry's name.
+    };
+
+    // A file as read again on the thread pool.
+    struct file_text
+    {
+        stringvec                  lines{};
+        std::vector<std::uint64_t> hashes{};
+    };
+
+    action watch_files();
+
+    bool reload(watched_file& file, const file_text& text, reload_summary& summary);
+    void place(watched_file& file, const line_hunk& hunk, std::span<menu_entry* const> inserted);
+
+protected:
+    static menu_reloader* m_instance;
+
+    // Interface thread only.
+    std::vector<std::unique_ptr<watched_file>> m_files{};
+    std::uint64_t                              m_generation = 0;
+    bool                                       m_watching   = false;
+
+    file_watcher m_watcher;
+
+    // Shared with the event loop thread.
+    std::mutex                       m_mutex{};
+    std::map<std::string, file_text> m_pending{};
+    std::atomic<bool>                m_hasPending{false};
+};
+
+
+/** ===============================================================================================
+ *  FUNCTION DECLARATIONS
+ */
+
+[[nodiscard]] std::uint64_t line_hash(std::string_view line);
+
+// The hunks turning the lines hashed as `before` into those hashed as `after`, in order; hunks are
+// separated by at least one equal line.
+[[nodiscard]] std::vector<line_hunk> diff_lines(std::span<const std::uint64_t> before,
+                                                std::span<const std::uint64_t> after,
+                                                std::size_t maxEdits = MAX_DIFF_EDITS);
+
+
+#endif  // MENU_RELOAD_H
+/**
+ * ------------------------------------------------------------------------------------------------
+ */
@@ -0,0 +1,477 @@
+/**
+ * ===============================================================================================
+ * @file    menu-tree.cpp
+ * @author  Pascal-Emmanuel Lachance
+ * @p       <a href="https://www.github.com/Raesangur">Raesangur</a>
+ * @p       <a href="https://www.raesangur.com/">https://www.raesangur.com/</a>
+ *
+ * @brief   Rows of a menu tree whose submenus expand and collapse in place.
+ *
+ * ------------------------------------------------------------------------------------------------
+ * @copyright Copyright (c) 2023 Pascal-Emmanuel Lachance | Raesangur
+ *
+ * @par License: <a href="https://opensource.org/license/mit/"> MIT </a>
+ *               This project is released under the MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ * BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NON INFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ * ===============================================================================================
+ */
+/** ===============================================================================================
+ *  INCLUDES
+ */
+#include "menu-tree.h"
+
+#include <algorithm>
+
+
+/** ===============================================================================================
+ *  MEMBER FUNCTIONS DEFINITIONS
+ */
+
+menu_tree::menu_tree(menu_top_entry* root) : m_root{root}
+{
+    rebuild();
+}
+
+
+[[nodiscard]] std::size_t menu_tree::size() const
+{
+    return total(m_top);
+}
+
+[[nodiscard]] tree_row menu_tree::row(std::size_t index) const
+{
+    tree_row found{};
+    auto     visit = [&](const segment& rows, std::size_t offset)
+    {
+        found = tree_row{rows.menu->m_submenus[rows.begin + offset], rows.depth};
+        return false;
+    };
+    walk(m_top, index, visit);
+    return found;
+}
+
+void menu_tree::rows(std::size_t first, std::size_t count, std::vector<tree_row>& rows) const
+{
+    auto visit = [&](const segment& run, std::size_t offset)
+    {
+        for (std::size_t i = offset; i < run.count && count > 0; i++, count--)
+        {
+            rows.push_back(tree_row{run.menu->m_submenus[run.begin + i], run.depth});
+        }
+        return count > 0;
+    };
+    if (count > 0)
+    {
+        walk(m_top, first, visit);
+    }
+}
+
+
+[[nodiscard]] bool menu_tree::is_expanded(std::size_t index) const
+{
+    std::vector<tree_row> pair{};
+    rows(index, 2, pair);
+    return pair.size() == 2 && pair[1].depth > pair[0].depth;
+}
+
+bool menu_tree::expand(std::size_t index)
+{
+    if (index >= size() || is_expanded(index))
+    {
+        return false;
+    }
+
+    tree_row current = row(index);
+    auto*    menu    = dynamic_cast<menu_top_entry*>(current.entry);
+    if (menu == nullptr)
+    {
+        return false;
+    }
+    menu->materialize();
+    if (menu->size() == 0)
+    {
+        return false;
+    }
+
+    // One segment for every child, so expanding costs the same for 10 children or 100000.
+    std::int32_t before = NONE;
+    std::int32_t after  = NONE;
+    split(m_top, index + 1, before, after);
+    std::int32_t children =
+        make(segment{menu, 0, static_cast<std::uint32_t>(menu->size()), current.depth + 1});
+    m_top = merge(merge(before, children), after);
+
+    m_expanded.insert(menu);
+    if (m_cursor > index)
+    {
+        m_cursor += menu->size();
+    }
+    return true;
+}
+
+bool menu_tree::collapse(std::size_t index)
+{
+    if (!is_expanded(index))
+    {
+        return false;
+    }
+
+    tree_row       current  = row(index);
+    std::size_t    count    = 0;
+    const segment* previous = nullptr;
+    auto           visit    = [&](const segment& rows, std::size_t offset)
+    {
+        // A segment deeper than the one before it follows a row that was expanded too.
+        if (previous != nullptr && rows.depth > previous->depth)
+        {
+            m_expanded.erase(previous->menu->m_submenus[previous->begin + previous->count - 1]);
+        }
+        if (rows.depth <= current.depth)
+        {
+            return false;
+        }
+        count += rows.count - offset;
+        previous = &rows;
+        return true;
+    };
+    walk(m_top, index + 1, visit);
+    m_expanded.erase(current.entry);
+
+    std::int32_t before = NONE;
+    std::int32_t rest   = NONE;
+    std::int32_t hidden = NONE;
+    std::int32_t after  = NONE;
+    split(m_top, index + 1, before, rest);
+    split(rest, count, hidden, after);
+    release(hidden);
+    m_top = merge(before, after);
+    join_at(index + 1);
+
+    if (m_cursor > index + count)
+    {
+        m_cursor -= count;
+    }
+    else if (m_cursor > index)
+    {
+        m_cursor = index;
+    }
+    return true;
+}
+
+[[nodiscard]] std::size_t menu_tree::parent(std::size_t index) const
+{
+    if (index == 0 || index >= size())
+    {
+        return index;
+    }
+
+    int         depth = row(index).depth;
+    std::size_t found = index;
+    std::size_t last  = index - 1;    //!< Row of the offset given to visit.
+    auto        visit = [&](const segment& rows, std::size_t offset)
+    {
+        if (rows.depth < depth)
+        {
+            found = last;
+            return false;
+        }
+        last -= offset + 1;
+        return true;
+    };
+    walk_back(m_top, index - 1, visit);
+    return found;
+}
+
+
+void menu_tree::rebuild()
+{
+    m_nodes.clear();
+    m_free.clear();
+    m_top = NONE;
+
+    std::vector<segment> segments{};
+    flatten(m_root, 0, segments);
+    for (const segment& rows : segments)
+    {
+        m_top = merge(m_top, make(rows));
+    }
+    move_to(m_cursor);
+}
+
+
+[[nodiscard]] menu_entry* menu_tree::cursor_entry() const
+{
+    return size() == 0 ? nullptr : row(m_cursor).entry;
+}
+
+void menu_tree::move_to(std::size_t index)
+{
+    m_cursor = size() == 0 ? 0 : std::min(index, size() - 1);
+}
+
+void menu_tree::move_by(std::ptrdiff_t delta)
+{
+    if (delta < 0 && static_cast<std::size_t>(-delta) > m_cursor)
+    {
+        return move_to(0);
+    }
+    move_to(m_cursor + static_cast<std::size_t>(delta));
+}
+
+
+void menu_tree::update(std::int32_t t)
+{
+    node& n = m_nodes[t];
+    n.total = total(n.left) + n.rows.count + total(n.right);
+}
+
+[[nodiscard]] std::int32_t menu_tree::make(const segment& rows)
+{
+    // xorshift32: the priorities only need to look random to keep the tree balanced.
+    m_seed ^= m_seed << 13;
+    m_seed ^= m_seed >> 17;
+    m_seed ^= m_seed << 5;
+
+    std::int32_t t = NONE;
+    if (m_free.empty())
+    {
+        t = static_cast<std::int32_t>(m_nodes.size());
+        m_nodes.emplace_back();
+    }
+    else
+    {
+        t = m_free.back();
+        m_free.pop_back();
+    }
+    m_nodes[t] = node{rows, m_seed, NONE, NONE, rows.count};
+    return t;
+}
+
+void menu_tree::release(std::int32_t t)
+{
+    if (t == NONE)
+    {
+        return;
+    }
+    release(m_nodes[t].left);
+    release(m_nodes[t].right);
+    m_free.push_back(t);
+}
+
+
+void menu_tree::split(std::int32_t t, std::size_t count, std::int32_t& left, std::int32_t& right)
+{
+    if (t == NONE)
+    {
+        left  = NONE;
+        right = NONE;
+        return;
+    }
+
+    std::size_t before = total(m_nodes[t].left);
+    std::size_t rows   = m_nodes[t].rows.count;
+    if (count <= before)
+    {
+        std::int32_t rest = NONE;
+        split(m_nodes[t].left, count, left, rest);
+        m_nodes[t].left = rest;
+        update(t);
+        right = t;
+    }
+    else if (count >= before + rows)
+    {
+        std::int32_t rest = NONE;
+        split(m_nodes[t].right, count - before - rows, rest, right);
+        m_nodes[t].right = rest;
+        update(t);
+        left = t;
+    }
+    else
+    {
+        // The cut falls inside this segment: its tail becomes a segment of its own.
+        auto    offset = static_cast<std::uint32_t>(count - before);
+        segment tail   = m_nodes[t].rows;
+        tail.begin += offset;
+        tail.count -= offset;
+
+        std::int32_t after    = m_nodes[t].right;
+        m_nodes[t].rows.count = offset;
+        m_nodes[t].right      = NONE;
+        update(t);
+
+        left  = t;
+        right = merge(make(tail), after);
+    }
+}
+
+[[nodiscard]] std::int32_t menu_tree::merge(std::int32_t left, std::int32_t right)
+{
+    if (left == NONE)
+    {
+        return right;
+    }
+    if (right == NONE)
+    {
+        return left;
+    }
+
+    if (m_nodes[left].priority > m_nodes[right].priority)
+    {
+        std::int32_t merged = merge(m_nodes[left].right, right);
+        m_nodes[left].right = merged;
+        update(left);
+        return left;
+    }
+    std::int32_t merged = merge(left, m_nodes[right].left);
+    m_nodes[right].left = merged;
+    update(right);
+    return right;
+}
+
+
+template<typename F>
+bool menu_tree::walk(std::int32_t t, std::size_t first, F& visit) const
+{
+    if (t == NONE)
+    {
+        return true;
+    }
+
+    const node& n      = m_nodes[t];
+    std::size_t before = total(n.left);
+    if (first < before)
+    {
+        if (!walk(n.left, first, visit))
+        {
+            return false;
+        }
+        first = before;
+    }
+    if (first < before + n.rows.count)
+    {
+        return visit(n.rows, first - before) && walk(n.right, 0, visit);
+    }
+    return walk(n.right, first - before - n.rows.count, visit);
+}
+
+template<typename F>
+bool menu_tree::walk_back(std::int32_t t, std::size_t last, F& visit) const
+{
+    if (t == NONE)
+    {
+        return true;
+    }
+
+    const node& n      = m_nodes[t];
+    std::size_t before = total(n.left);
+    std::size_t end    = before + n.rows.count;
+    if (last >= end)
+    {
+        if (!walk_back(n.right, last - end, visit))
+        {
+            return false;
+        }
+        last = end - 1;
+    }
+    if (last >= before)
+    {
+        return visit(n.rows, last - before) &&
+               (before == 0 || walk_back(n.left, before - 1, visit));
+    }
+    return walk_back(n.left, last, visit);
+}
+
+
+void menu_tree::join_at(std::size_t index)
+{
+    if (index == 0 || index >= size())
+    {
+        return;
+    }
+
+    segment     first{};
+    segment     second{};
+    std::size_t firstOffset  = 0;
+    std::size_t secondOffset = 0;
+    auto        takeFirst    = [&](const segment& rows, std::size_t offset)
+    {
+        first       = rows;
+        firstOffset = offset;
+        return false;
+    };
+    auto takeSecond = [&](const segment& rows, std::size_t offset)
+    {
+        second       = rows;
+        secondOffset = offset;
+        return false;
+    };
+    walk_back(m_top, index - 1, takeFirst);
+    walk(m_top, index, takeSecond);
+
+    if (secondOffset != 0 || firstOffset + 1 != first.count || first.menu != second.menu ||
+        first.depth != second.depth || first.begin + first.count != second.begin)
+    {
+        return;
+    }
+
+    // Both segments end up alone in their own subtree, since the cuts fall on their boundaries.
+    std::int32_t before = NONE;
+    std::int32_t rest   = NONE;
+    std::int32_t joined = NONE;
+    std::int32_t tail   = NONE;
+    std::int32_t gone   = NONE;
+    std::int32_t after  = NONE;
+    split(m_top, index - first.count, before, rest);
+    split(rest, first.count, joined, tail);
+    split(tail, second.count, gone, after);
+
+    m_nodes[joined].rows.count += second.count;
+    update(joined);
+    release(gone);
+    m_top = merge(before, merge(joined, after));
+}
+
+void menu_tree::flatten(menu_top_entry* menu, int depth, std::vector<segment>& segments) const
+{
+    auto          size  = static_cast<std::uint32_t>(menu->size());
+    std::uint32_t begin = 0;
+    for (std::uint32_t i = 0; i < size; i++)
+    {
+        if (!m_expanded.contains(menu->m_submenus[i]))
+        {
+            continue;
+        }
+        auto* child = dynamic_cast<menu_top_entry*>(menu->m_submenus[i]);
+        if (child == nullptr || !child->is_materialized() || child->size() == 0)
+        {
+            continue;
+        }
+
+        segments.push_back(segment{menu, begin, i + 1 - begin, depth});
+        flatten(child, depth + 1, segments);
+        begin = i + 1;
+    }
+    if (begin < size)
+    {
+        segments.push_back(segment{menu, begin, size - begin, depth});
+    }
+}
+
+
+/**
+ * ------------------------------------------------------------------------------------------------
+ */
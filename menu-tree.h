@@ -0,0 +1,173 @@
+/**
+ * ===============================================================================================
+ * @file    menu-tree.h
+ * @author  Pascal-Emmanuel Lachance
+ * @p       <a href="https://www.github.com/Raesangur">Raesangur</a>
+ * @p       <a href="https://www.raesangur.com/">https://www.raesangur.com/</a>
+ *
+ * @brief   Rows of a menu tree whose submenus expand and collapse in place.
+ *
+ * ------------------------------------------------------------------------------------------------
+ * @copyright Copyright (c) 2023 Pascal-Emmanuel Lachance | Raesangur
+ *
+ * @par License: <a href="https://opensource.org/license/mit/"> MIT </a>
+ *               This project is released under the MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ * BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NON INFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ * ------------------------------------------------------------------------------------------------
+ * @details
+ * The tree view shows a menu with its submenus opened inline rather than entered. What it draws is
+ * the flattened list of visible rows, which would cost a pass over every row to recompute after
+ * each expansion, and a submenu can hold a hundred thousand entries.
+ *
+ * The rows are therefore kept as segments: a run of consecutive children of one menu, all at the
+ * same depth. Expanding a row splits the segment holding it right after the row and inserts a
+ * single segment covering all of the submenu's children, however many there are; collapsing removes
+ * the segments below the row and joins the two halves back together. The segments are the nodes of
+ * an implicit treap (a randomized balanced tree ordered by position, where each node knows how many
+ * rows its subtree holds), so finding the row at an index, splitting and joining all take O(log n)
+ * in the number of segments. Drawing and moving the cursor only visit the rows on screen.
+ *
+ * Menus whose children change under the tree, when a list file is reloaded or a menu is sorted, are
+ * flattened again with rebuild(), which keeps what was expanded.
+ * ===============================================================================================
+ */
+#ifndef MENU_TREE_H
+#define MENU_TREE_H
+
+
+/** ===============================================================================================
+ *  INCLUDES
+ */
+#include "memory-accounting.h"
+#include "menu.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_set>
+#include <vector>
+
+
+/** ===============================================================================================
+ *  CLASS DEFINITION
+ */
+
+struct tree_row
+{
+    menu_entry* entry = nullptr;
+    int         depth = 0;
+};
+
+
+class menu_tree
+{
+public:
+    explicit menu_tree(menu_top_entry* root);
+
+    [[nodiscard]] menu_top_entry* root() const
+    {
+        return m_root;
+    }
+
+    [[nodiscard]] std::size_t size() const;
+    [[nodiscard]] tree_row    row(std::size_t index) const;
+    // Appends up to `count` rows, starting at `first`, to `rows`.
+    void rows(std::size_t first, std::size_t count, std::vector<tree_row>& rows) const;
+
+    [[nodiscard]] bool is_expanded(std::size_t index) const;
+    // Both return false when there was nothing to do.
+    bool expand(std::size_t index);
+    bool collapse(std::size_t index);
+    // Index of the row's parent; a top-level row is its own parent.
+    [[nodiscard]] std::size_t parent(std::size_t index) const;
+
+    // Flattens the menus anew, keeping what was expanded, after their children changed.
+    void rebuild();
+
+    [[nodiscard]] std::size_t cursor() const
+    {
+        return m_cursor;
+    }
+    [[nodiscard]] menu_entry* cursor_entry() const;
+    void                      move_to(std::size_t index);
+    void                      move_by(std::ptrdiff_t delta);
+
+protected:
+    struct segment
+    {
+        menu_top_entry* menu  = nullptr;
+        std::uint32_t   begin = 0;    //!< Index of the first row in menu's children.
+        std::uint32_t   count = 0;
+        int             depth = 0;
+    };
+
+    struct node
+    {
+        segment       rows{};
+        std::uint32_t priority = 0;
+        std::int32_t  left     = NONE;
+        std::int32_t  right    = NONE;
+        std::size_t   total    = 0;    //!< Rows in the subtree.
+    };
+
+    static constexpr std::int32_t NONE = -1;
+
+    [[nodiscard]] std::size_t total(std::int32_t t) const
+    {
+        return t == NONE ? 0 : m_nodes[t].total;
+    }
+    void update(std::int32_t t);
+
+    [[nodiscard]] std::int32_t make(const segment& rows);
+    void                       release(std::int32_t t);
+
+    // Splits `t` into its first `count` rows and the others, cutting a segment when needed.
+    void                       split(std::int32_t t, std::size_t count, std::int32_t& left,
+                                     std::int32_t& right);
+    [[nodiscard]] std::int32_t merge(std::int32_t left, std::int32_t right);
+
+    // Calls `visit(segment, offset)` on the segments from the one holding row `first` onwards,
+    // with the offset of `first` in it and 0 for the others, until it returns false.
+    template<typename F>
+    bool walk(std::int32_t t, std::size_t first, F& visit) const;
+    // Same, backwards from the segment holding row `last`, with the offset of `last` in it and of
+    // their last row for the others.
+    template<typename F>
+    bool walk_back(std::int32_t t, std::size_t last, F& visit) const;
+
+    // Joins the segments on either side of row `index` when they are one run of children.
+    void join_at(std::size_t index);
+    void flatten(menu_top_entry* menu, int depth, std::vector<segment>& segments) const;
+
+protected:
+    template<typename T>
+    using tree_vector = std::vector<T, tracking_allocator<T, memory_category::tree_rows>>;
+
+    menu_top_entry*                       m_root = nullptr;
+    tree_vector<node>                     m_nodes{};
+    tree_vector<std::int32_t>             m_free{};
+    std::int32_t                          m_top  = NONE;
+    std::uint32_t                         m_seed = 0x9E3779B9u;
+    std::unordered_set<const menu_entry*> m_expanded{};
+
+    std::size_t m_cursor = 0;
+};
+
+
+#endif  // MENU_TREE_H
+/**
+ * ------------------------------------------------------------------------------------------------
+ */
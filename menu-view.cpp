@@ -0,0 +1,328 @@
+/**
+ * ===============================================================================================
+ * @file    menu-view.cpp
+ * @author  Pascal-Emmanuel Lachance
+ * @p       <a href="https://www.github.com/Raesangur">Raesangur</a>
+ * @p       <a href="https://www.raesangur.com/">https://www.raesangur.com/</a>
+ *
+ * @brief   Renders a menu_top_entry's entries into a window.
+ *
+ * ------------------------------------------------------------------------------------------------
+ * @copyright Copyright (c) 2023 Pascal-Emmanuel Lachance | Raesangur
+ *
+ * @par License: <a href="https://opensource.org/license/mit/"> MIT </a>
+ *               This project is released under the MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ * BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NON INFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ * ===============================================================================================
+ */
+
+/** ===============================================================================================
+ *  INCLUDES
+ */
+#include "menu-view.h"
+
+#include "display-width.h"
+#include "entry-metadata.h"
+#include "entry-probes.h"
+#include "theme.h"
+#include "trace.h"
+
+#include <algorithm>
+#include <cstdlib>
+
+
+/** ===============================================================================================
+ *  MEMBER FUNCTIONS DEFINITIONS
+ */
+
+menu_view::menu_view(window& win) : m_win{win}
+{
+    m_win.scrollok();
+}
+
+
+void menu_view::render(const menu_top_entry* menu)
+{
+    trace_span span{"menu_view::render"};
+
+    int         rows        = visible_rows();
+    std::size_t highlighted = menu->current_index();
+    m_installed             = package_status::get()->installed();
+
+    int start = std::max(0, static_cast<int>(highlighted) - rows + MARGIN_ROWS);
+    int delta = start - m_start;
+
+    // Probes only ever run for the rows about to be shown.
+    int end = std::min(static_cast<int>(menu->size()), start + rows);
+    entry_probes::get()->request(std::span<const menu_entry* const>{
+        menu->m_submenus.data() + start, static_cast<std::size_t>(std::max(0, end - start))});
+
+    bool widthsChanged = false;
+    if (m_table)
+    {
+        std::vector<int> widths = column_widths(menu, start);
+        widthsChanged           = widths != m_widths;
+        m_widths                = std::move(widths);
+    }
+
+    if (!m_valid || menu != m_menu || menu->size() != m_size || std::abs(delta) >= rows ||
+        widthsChanged)
+    {
+        redraw(menu, start);
+    }
+    else
+    {
+        if (delta != 0)
+        {
+            // The marker sits on the last list row; lift it so that it does not scroll with it.
+            draw_scroll_marker(menu, false);
+            m_win.scroll_lines(FIRST_ROW, FIRST_ROW + rows - 1, delta);
+
+            int exposedBegin = delta > 0 ? start + rows - delta : start;
+            int exposedEnd   = delta > 0 ? start + rows : start - delta;
+            for (int i = exposedBegin; i < exposedEnd; i++)
+            {
+                draw_row(menu, i, start);
+            }
+            draw_scroll_marker(menu, true);
+        }
+
+        if (m_highlighted != highlighted)
+        {
+            draw_row(menu, static_cast<int>(m_highlighted), start);
+        }
+        draw_row(menu, static_cast<int>(highlighted), start);
+    }
+    m_win.set_style(theme::get()->get(style_id::menu));
+
+    m_menu        = menu;
+    m_size        = menu->size();
+    m_start       = start;
+    m_highlighted = highlighted;
+    m_valid       = true;
+}
+
+void menu_view::invalidate()
+{
+    m_valid = false;
+}
+
+void menu_view::set_table(bool table)
+{
+    if (table != m_table)
+    {
+        m_table = table;
+        m_widths.clear();
+        m_valid = false;
+    }
+}
+
+
+[[nodiscard]] int menu_view::visible_rows() const
+{
+    auto [y, _] = m_win.get_max_yx();
+    return std::max(0, y - MARGIN_ROWS);
+}
+
+
+void menu_view::redraw(const menu_top_entry* menu, int start)
+{
+    m_win.set_style(theme::get()->get(style_id::menu));
+
+    m_win.erase();
+    m_win.box();
+
+    m_win.print(0, clip_to_width(menu->get_name(), m_win.width() - 2));
+    if (m_table)
+    {
+        draw_header(menu);
+    }
+
+    int end = std::min(static_cast<int>(menu->size()), start + visible_rows());
+    for (int i = start; i < end; i++)
+    {
+        draw_row(menu, i, start);
+    }
+    m_win.set_style(theme::get()->get(style_id::menu));
+
+    draw_scroll_marker(menu, true);
+}
+
+void menu_view::draw_row(const menu_top_entry* menu, int index, int start)
+{
+    int end = std::min(static_cast<int>(menu->size()), start + visible_rows());
+    if (index < start || index >= end)
+    {
+        return;
+    }
+
+    const menu_entry* displayedMenu = menu->get(static_cast<std::size_t>(index));
+
+    // The window only forwards actual changes: one switch into the highlight and one back.
+    m_win.set_style(theme::get()->get(displayedMenu->is_highlighted() ? style_id::highlight
+                                                                      : style_id::menu));
+
+    // Entries must stay clear of the right border.
+    int maxWidth = m_win.width() - FIRST_COL - 1;
+    int y        = index - start + FIRST_ROW;
+    if (m_table)
+    {
+        m_win.print(y, FIRST_COL, clip_to_width(table_row(displayedMenu), maxWidth));
+        return;
+    }
+
+    if (displayedMenu->display_width() > maxWidth)
+    {
+        m_win.print(y, FIRST_COL, clip_to_width(displayedMenu->display(), maxWidth));
+    }
+    else
+    {
+        m_win.print(y, FIRST_COL, displayedMenu->display());
+    }
+
+    // Tags follow the entry, as long as they fit whole.
+    int   x      = FIRST_COL + displayedMenu->display_width();
+    auto* option = dynamic_cast<const menu_option_entry*>(displayedMenu);
+    if (option != nullptr && option->is_package() && m_installed->contains(option->get_name()) &&
+        x + static_cast<int>(INSTALLED_TAG.size()) <= FIRST_COL + maxWidth)
+    {
+        m_win.set_style(theme::get()->get(style_id::menu));
+        m_win.print(y, x, std::string{INSTALLED_TAG});
+        x += static_cast<int>(INSTALLED_TAG.size()) + 1;
+    }
+
+    std::string status = entry_probes::get()->status(displayedMenu);
+    if (!status.empty())
+    {
+        status = "(" + status + ")";
+        if (x + display_width(status) <= FIRST_COL + maxWidth)
+        {
+            m_win.set_style(theme::get()->get(style_id::menu));
+            m_win.print(y, x, status);
+        }
+    }
+}
+
+void menu_view::draw_scroll_marker(const menu_top_entry* menu, bool visible)
+{
+    if (static_cast<int>(menu->size()) < visible_rows())
+    {
+        return;
+    }
+
+    m_win.set_style(theme::get()->get(style_id::menu));
+    if (visible)
+    {
+        m_win.print(m_win.height() - 3, MARKER_COL, "|");
+        m_win.print(m_win.height() - 2, MARKER_COL, "v");
+    }
+    else
+    {
+        m_win.print(m_win.height() - 3, MARKER_COL, " ");
+    }
+}
+
+void menu_view::draw_header(const menu_top_entry* menu)
+{
+    const entry_metadata*      metadata = entry_metadata::get();
+    std::optional<std::size_t> sorted   = metadata->sorted_column(menu);
+
+    std::string header(static_cast<std::size_t>(m_widths.empty() ? 0 : m_widths[0]), ' ');
+    for (std::size_t i = 1; i < m_widths.size(); i++)
+    {
+        if (m_widths[i] == 0)
+        {
+            continue;
+        }
+
+        std::string label = metadata->column(i - 1).name();
+        if (sorted == i - 1)
+        {
+            label += SORTED_MARK;
+        }
+        header.append(COLUMN_GAP, ' ');
+        header += label;
+        header.append(static_cast<std::size_t>(std::max(0, m_widths[i] - display_width(label))),
+                      ' ');
+    }
+
+    m_win.print(HEADER_ROW, FIRST_COL, clip_to_width(header, m_win.width() - FIRST_COL - 1));
+}
+
+
+[[nodiscard]] std::vector<int> menu_view::column_widths(const menu_top_entry* menu,
+                                                        int                   start) const
+{
+    const entry_metadata* metadata = entry_metadata::get();
+    std::vector<int>      widths(1 + metadata->column_count(), 0);
+
+    int end = std::min(static_cast<int>(menu->size()), start + visible_rows());
+    for (int i = start; i < end; i++)
+    {
+        const menu_entry* entry = menu->get(static_cast<std::size_t>(i));
+        widths[0]               = std::max(widths[0], entry->display_width());
+
+        for (std::size_t column = 0; column < metadata->column_count(); column++)
+        {
+            const metadata_column& values = metadata->column(column);
+            if (values.has(entry->id()))
+            {
+                widths[column + 1] =
+                    std::max(widths[column + 1], display_width(values.format(entry->id())));
+            }
+        }
+    }
+
+    // Only the columns with a value on screen are shown; those also fit their header.
+    std::optional<std::size_t> sorted = metadata->sorted_column(menu);
+    for (std::size_t column = 0; column < metadata->column_count(); column++)
+    {
+        if (widths[column + 1] > 0)
+        {
+            int header = display_width(metadata->column(column).name()) +
+                         (sorted == column ? static_cast<int>(SORTED_MARK.size()) : 0);
+            widths[column + 1] = std::max(widths[column + 1], header);
+        }
+    }
+    return widths;
+}
+
+[[nodiscard]] std::string menu_view::table_row(const menu_entry* entry) const
+{
+    const entry_metadata* metadata = entry_metadata::get();
+
+    std::string row = entry->display();
+    row.append(static_cast<std::size_t>(std::max(0, m_widths[0] - entry->display_width())), ' ');
+    for (std::size_t i = 1; i < m_widths.size(); i++)
+    {
+        if (m_widths[i] == 0)
+        {
+            continue;
+        }
+
+        std::string cell = metadata->column(i - 1).format(entry->id());
+        row.append(COLUMN_GAP, ' ');
+        row += cell;
+        row.append(static_cast<std::size_t>(std::max(0, m_widths[i] - display_width(cell))), ' ');
+    }
+    return row;
+}
+
+
+/**
+ * ------------------------------------------------------------------------------------------------
+ */
@@ -0,0 +1,122 @@
+/**
+ * ===============================================================================================
+ * @file    menu-view.h
+ * @author  Pascal-Emmanuel Lachance
+ * @p       <a href="https://www.github.com/Raesangur">Raesangur</a>
+ * @p       <a href="https://www.raesangur.com/">https://www.raesangur.com/</a>
+ *
+ * @brief   Renders a menu_top_entry's entries into a window.
+ *
+ * ------------------------------------------------------------------------------------------------
+ * @copyright Copyright (c) 2023 Pascal-Emmanuel Lachance | Raesangur
+ *
+ * @par License: <a href="https://opensource.org/license/mit/"> MIT </a>
+ *               This project is released under the MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ * BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NON INFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ * ------------------------------------------------------------------------------------------------
+ * @details
+ * The view remembers what it drew last. When the same menu is shown again and only the highlight
+ * moved, the rows already on screen are kept: if the viewport shifted, the list area is scrolled
+ * with the terminal's scroll region and only the newly exposed rows are painted, along with the
+ * rows whose highlight changed. Anything else (another menu, a resize, a jump of a whole page or
+ * more) redraws the window from scratch.
+ *
+ * In table mode, each row also shows the entry's metadata columns (see entry-metadata.h), under a
+ * header row. Column widths are measured over the visible rows only, so that the cost of a frame
+ * does not grow with the menu; when scrolling changes them, the window is redrawn instead of
+ * scrolled.
+ * ===============================================================================================
+ */
+#ifndef MENU_VIEW_H
+#define MENU_VIEW_H
+
+
+/** ===============================================================================================
+ *  INCLUDES
+ */
+#include "menu.h"
+#include "package-status.h"
+#include "window.h"
+
+#include <cstddef>
+#include <memory>
+#include <span>
+#include <string>
+#include <vector>
+
+
+/** ===============================================================================================
+ *  CLASS DEFINITION
+ */
+
+class menu_view
+{
+public:
+    menu_view(window& win);
+
+    void render(const menu_top_entry* menu);
+    void invalidate();
+
+    void set_table(bool table);
+    [[nodiscard]] bool is_table() const
+    {
+        return m_table;
+    }
+
+    [[nodiscard]] int visible_rows() const;
+
+protected:
+    void redraw(const menu_top_entry* menu, int start);
+    void draw_row(const menu_top_entry* menu, int index, int start);
+    void draw_scroll_marker(const menu_top_entry* menu, bool visible);
+    void draw_header(const menu_top_entry* menu);
+
+    // The entry column first, then one width per metadata column; 0 hides a column.
+    [[nodiscard]] std::vector<int> column_widths(const menu_top_entry* menu, int start) const;
+    [[nodiscard]] std::string      table_row(const menu_entry* entry) const;
+
+protected:
+    static constexpr int FIRST_ROW   = 2;
+    static constexpr int HEADER_ROW  = 1;
+    static constexpr int FIRST_COL   = 5;
+    static constexpr int MARKER_COL  = 2;
+    static constexpr int MARGIN_ROWS = 4;
+    static constexpr int COLUMN_GAP  = 2;
+
+    static constexpr std::string_view INSTALLED_TAG = "(installed)";
+    static constexpr std::string_view SORTED_MARK   = "*";
+
+    window& m_win;
+
+    // Taken once per render, so that every row is checked against the same set.
+    std::shared_ptr<const package_status::name_set> m_installed{};
+
+    const menu_top_entry* m_menu        = nullptr;
+    std::size_t           m_size        = 0;
+    int                   m_start       = 0;
+    std::size_t           m_highlighted = 0;
+    bool                  m_valid       = false;
+
+    bool             m_table = false;
+    std::vector<int> m_widths{};
+};
+
+
+#endif  // MENU_VIEW_H
+/**
+ * ------------------------------------------------------------------------------------------------
+ */
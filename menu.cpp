@@ -35,11 +35,68 @@
  */
 #include "menu.h"
 
+#include "display-width.h"
+
+#include <ncurses.h>
+
+#include <cstdint>
+
+
+/** ===============================================================================================
+ *  LOCAL FUNCTIONS
+ */
+
+// Length of the UTF-8 sequence started by a lead byte, 0 for bytes that cannot start one.
+static std::size_t utf8_sequence_length(unsigned char lead)
+{
+    if (lead < 0x80)
+    {
+        return 1;
+    }
+    if ((lead & 0xE0) == 0xC0)
+    {
+        return 2;
+    }
+    if ((lead & 0xF0) == 0xE0)
+    {
+        return 3;
+    }
+    if ((lead & 0xF8) == 0xF0)
+    {
+        return 4;
+    }
+    return 0;
+}
+
 
 /** ===============================================================================================
  *  MENU_ENTRY MEMBER FUNCTION DEFINITIONS
  */
 
+menu_entry::menu_entry(const std::string_view name) : m_id{s_nextId++}, m_name{name}
+{
+    memory_accounting::allocate(memory_category::entry_names, heap_bytes(m_name));
+}
+
+menu_entry::~menu_entry()
+{
+    memory_accounting::release(memory_category::entry_names, heap_bytes(m_name));
+}
+
+void* menu_entry::operator new(std::size_t size)
+{
+    void* p = ::operator new(size);
+    memory_accounting::allocate(memory_category::menu_entries, size);
+    return p;
+}
+
+void menu_entry::operator delete(void* p, std::size_t size)
+{
+    memory_accounting::release(memory_category::menu_entries, size);
+    ::operator delete(p, size);
+}
+
+
 [[nodiscard]] menu_entry* menu_entry::highlighted_entry() const
 {
     return nullptr;
@@ -64,6 +121,36 @@
 
 void menu_entry::move_up() {}
 void menu_entry::move_down() {}
+void menu_entry::move_to(std::size_t index)
+{
+    (void)index;
+}
+void menu_entry::move_by(std::ptrdiff_t delta)
+{
+    (void)delta;
+}
+
+[[nodiscard]] std::size_t menu_entry::current_index() const
+{
+    return 0;
+}
+
+void menu_entry::move_home()
+{
+    move_to(0);
+}
+void menu_entry::move_end()
+{
+    move_to(SIZE_MAX);
+}
+void menu_entry::page_up(std::size_t rows)
+{
+    move_by(-static_cast<std::ptrdiff_t>(rows));
+}
+void menu_entry::page_down(std::size_t rows)
+{
+    move_by(static_cast<std::ptrdiff_t>(rows));
+}
 
 void menu_entry::select() {}
 void menu_entry::deselect() {}
@@ -119,12 +206,199 @@ void menu_entry::dehighlight()
     return preamble + " " + m_name + " " + postamble;
 }
 
-[[nodiscard]] std::string menu_entry::get_name() const
+[[nodiscard]] int menu_entry::display_width() const
+{
+    if (m_nameWidth < 0)
+    {
+        m_nameWidth = ::display_width(m_name);
+    }
+
+    // Matches display(): a 3-column preamble, a space on each side of the name and the "--->".
+    return m_nameWidth + 5 + (can_enter() ? 4 : 0);
+}
+
+[[nodiscard]] const std::string& menu_entry::get_name() const
 {
     return m_name;
 }
 
 
+/** ===============================================================================================
+ *  MENU_INPUT_ENTRY MEMBER FUNCTION DEFINITIONS
+ */
+
+void menu_input_entry::input_character(int ch)
+{
+    bool changed = true;
+    switch (ch)
+    {
+        case KEY_LEFT:
+            changed = m_buffer.move_left();
+            break;
+        case KEY_RIGHT:
+            changed = m_buffer.move_right();
+            break;
+        case KEY_HOME:
+            m_buffer.move_home();
+            break;
+        case KEY_END:
+            m_buffer.move_end();
+            break;
+        case KEY_BACKSPACE:
+        case 0x7F:
+        case '\b':
+            changed = m_buffer.erase_before();
+            break;
+        case KEY_DC:
+            changed = m_buffer.erase_after();
+            break;
+
+        default:
+            if (ch < 0x20 || ch > 0xFF || ch == 0x7F)
+            {
+                return;
+            }
+
+            // getch() hands multi-byte characters over one byte at a time. A byte that is not a
+            // continuation drops the unfinished sequence and may start the next one itself.
+            if (!m_pending.empty() && (ch & 0xC0) != 0x80)
+            {
+                m_pending.clear();
+            }
+            m_pending += static_cast<char>(ch);
+            std::size_t length = utf8_sequence_length(static_cast<unsigned char>(m_pending[0]));
+            if (length == 0)
+            {
+                m_pending.clear();
+                return;
+            }
+            if (m_pending.size() < length)
+            {
+                return;
+            }
+            // Overlong encodings, surrogates and code points past U+10FFFF are dropped.
+            if (char32_t codepoint = 0; decode_utf8(m_pending, codepoint) != length)
+            {
+                m_pending.clear();
+                return;
+            }
+            m_buffer.insert(m_pending);
+            m_pending.clear();
+            break;
+    }
+
+    m_generation += changed ? 1 : 0;
+}
+
+void menu_input_entry::input_text(std::string_view text)
+{
+    // Held to the same rules as typed text: control bytes and malformed UTF-8 are dropped.
+    std::string clean{};
+    clean.reserve(text.size());
+    while (!text.empty())
+    {
+        const auto  lead      = static_cast<unsigned char>(text[0]);
+        char32_t    codepoint = 0;
+        std::size_t length    = decode_utf8(text, codepoint);
+        if (length > 1 || (lead >= 0x20 && lead < 0x7F))
+        {
+            clean.append(text.substr(0, length));
+        }
+        text.remove_prefix(length);
+    }
+
+    m_pending.clear();
+    m_buffer.insert(clean);
+    m_generation++;
+}
+
+void menu_input_entry::set_value(std::string_view value)
+{
+    m_pending.clear();
+    m_buffer.clear();
+    m_buffer.insert(value);
+    m_generation++;
+}
+
+
+/** ===============================================================================================
+ *  MENU_TOP_ENTRY MEMBER FUNCTION DEFINITIONS
+ */
+
+void menu_top_entry::materialize()
+{
+    if (m_source == nullptr)
+    {
+        return;
+    }
+
+    // Released before building, so that a source re-entering the tree sees this entry as built.
+    std::unique_ptr<menu_entry_source> source = std::move(m_source);
+    source->build(*this);
+}
+
+void menu_top_entry::prefetch()
+{
+    if (m_source != nullptr)
+    {
+        m_source->prefetch();
+    }
+}
+
+void menu_top_entry::set_order(std::span<menu_entry* const>   entries,
+                               std::span<const std::uint32_t> order)
+{
+    menu_entry* highlighted = m_submenus.empty() ? nullptr : m_submenus[m_currentMenu];
+    for (std::size_t i = 0; i < order.size(); i++)
+    {
+        m_submenus[i] = entries[order[i]];
+        if (m_submenus[i] == highlighted)
+        {
+            m_currentMenu = i;
+        }
+    }
+}
+
+void menu_top_entry::splice(std::size_t index, std::size_t count,
+                            std::span<menu_entry* const> entries)
+{
+    bool hadEntries = !m_submenus.empty();
+    bool removed    = hadEntries && m_currentMenu >= index && m_currentMenu < index + count;
+    if (removed)
+    {
+        m_submenus[m_currentMenu]->dehighlight();
+    }
+
+    auto        first  = m_submenus.begin() + static_cast<std::ptrdiff_t>(index);
+    std::size_t common = std::min(count, entries.size());
+    std::copy_n(entries.begin(), common, first);
+    if (entries.size() > count)
+    {
+        m_submenus.insert(first + static_cast<std::ptrdiff_t>(common), entries.begin() + common,
+                          entries.end());
+    }
+    else
+    {
+        m_submenus.erase(first + static_cast<std::ptrdiff_t>(common),
+                         first + static_cast<std::ptrdiff_t>(count));
+    }
+
+    if (m_submenus.empty())
+    {
+        m_currentMenu = 0;
+    }
+    else if (!hadEntries || removed)
+    {
+        m_currentMenu = std::min(hadEntries ? index : 0, m_submenus.size() - 1);
+        m_submenus[m_currentMenu]->highlight();
+    }
+    else if (m_currentMenu >= index + count)
+    {
+        m_currentMenu = m_currentMenu + entries.size() - count;
+    }
+}
+
+
 /** ===============================================================================================
  *  MENU_TOP_OPTION_ENTRY MEMBER FUNCTION DEFINITIONS
  */
@@ -142,6 +416,19 @@ void menu_top_option_entry::move_down()
 {
     return menu_top_entry::move_down();
 }
+void menu_top_option_entry::move_to(std::size_t index)
+{
+    return menu_top_entry::move_to(index);
+}
+void menu_top_option_entry::move_by(std::ptrdiff_t delta)
+{
+    return menu_top_entry::move_by(delta);
+}
+
+[[nodiscard]] std::size_t menu_top_option_entry::current_index() const
+{
+    return menu_top_entry::current_index();
+}
 
 
 [[nodiscard]] bool menu_top_option_entry::can_enter() const
@@ -35,7 +35,15 @@
 /** ===============================================================================================
  *  INCLUDES
  */
+#include "gap-buffer.h"
+#include "memory-accounting.h"
+#include "selection-set.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
 #include <memory>
+#include <span>
 #include <string>
 #include <vector>
 
@@ -44,16 +52,60 @@
  *  CLASS DEFINITION
  */
 
+class action;
+class menu_entry;
+class menu_option_entry;
+
+// Builds the action run for an option; called on the input thread, the action then runs on the
+// event loop.
+using action_factory = action (*)(const menu_option_entry& option);
+
+class selection_observer
+{
+public:
+    virtual ~selection_observer() = default;
+
+    virtual void selection_changed(const menu_entry& entry, bool selected) = 0;
+};
+
+
+class menu_top_entry;
+// Produces the children of a lazy menu_top_entry the first time they are needed.
+class menu_entry_source
+{
+public:
+    virtual ~menu_entry_source() = default;
+
+    // Starts loading in the background and returns immediately; must not touch the menu tree.
+    virtual void prefetch() {}
+    virtual void build(menu_top_entry& parent) = 0;
+};
+
+
 class menu_entry
 {
 protected:
-    menu_entry(const std::string_view name) : m_name{name} {}
+    menu_entry(const std::string_view name);
 
 public:
+    virtual ~menu_entry();
+
+    // Entries are charged to memory_category::menu_entries with their full dynamic size.
+    static void* operator new(std::size_t size);
+    static void  operator delete(void* p, std::size_t size);
+
     [[nodiscard]] virtual menu_entry* highlighted_entry() const;
 
     virtual void move_up();
     virtual void move_down();
+    virtual void move_to(std::size_t index);
+    virtual void move_by(std::ptrdiff_t delta);
+    [[nodiscard]] virtual std::size_t current_index() const;
+
+    void move_home();
+    void move_end();
+    void page_up(std::size_t rows);
+    void page_down(std::size_t rows);
 
     [[nodiscard]] virtual bool can_enter() const;
     [[nodiscard]] virtual bool can_select() const;
@@ -69,13 +121,29 @@ public:
     void dehighlight();
 
     [[nodiscard]] std::string display() const;
-    [[nodiscard]] std::string get_name() const;
+    [[nodiscard]] int display_width() const;
+    [[nodiscard]] const std::string& get_name() const;
+
+    // Dense and never reused, so that per-entry data can live in arrays indexed by it.
+    [[nodiscard]] std::uint32_t id() const
+    {
+        return m_id;
+    }
+    // One past the largest id given so far.
+    [[nodiscard]] static std::uint32_t id_count()
+    {
+        return s_nextId;
+    }
 
 
 protected:
-    bool m_highlighted = false;
+    bool          m_highlighted = false;
+    std::uint32_t m_id;    //!< Fits in the padding after m_highlighted.
 
     std::string m_name;
+    mutable int m_nameWidth = -1;
+
+    static inline std::uint32_t s_nextId = 0;
 };
 
 
@@ -86,10 +154,57 @@ public:
 };
 
 
+// Free-text field, edited once entered; keys reach it through input_character().
+class menu_input_entry : public menu_entry
+{
+public:
+    menu_input_entry(const std::string_view name) : menu_entry{name} {}
+
+    [[nodiscard]] bool can_enter() const override
+    {
+        return true;
+    }
+    [[nodiscard]] bool has_input_field() const override
+    {
+        return true;
+    }
+
+    // Takes one getch() result: an editing key, or one byte of a UTF-8 sequence.
+    void input_character(int ch) override;
+    // Inserts a whole block at the cursor, such as a paste; control characters are dropped.
+    void input_text(std::string_view text);
+
+    void set_value(std::string_view value);
+    [[nodiscard]] std::string value() const
+    {
+        return m_buffer.text();
+    }
+
+    [[nodiscard]] const gap_buffer& buffer() const
+    {
+        return m_buffer;
+    }
+    // Bumped by every change to the text or the cursor, so that views can skip unchanged frames.
+    [[nodiscard]] std::uint64_t generation() const
+    {
+        return m_generation;
+    }
+
+protected:
+    gap_buffer    m_buffer{};
+    std::string   m_pending{};    //!< Leading bytes of a UTF-8 sequence still being typed.
+    std::uint64_t m_generation = 0;
+};
+
+
 class menu_option_entry : public virtual menu_entry
 {
 public:
     menu_option_entry(const std::string_view name) : menu_entry{name} {}
+    ~menu_option_entry() override
+    {
+        s_selection.set(m_id, false);
+    }
 
     [[nodiscard]] virtual bool can_select() const
     {
@@ -98,21 +213,94 @@ public:
 
     [[nodiscard]] virtual bool is_selected() const
     {
-        return m_selected;
+        return s_selection.test(m_id);
     }
     
     void virtual select()
     {
-        m_selected = true;
+        if (s_selection.set(m_id, true))
+        {
+            notify(true);
+        }
     }
 
     void virtual deselect()
     {
-        m_selected = false;
+        if (s_selection.set(m_id, false))
+        {
+            notify(false);
+        }
+    }
+
+    // Changes the selection without notifying the observer, for restoring saved state.
+    void set_selected(bool selected)
+    {
+        s_selection.set(m_id, selected);
+    }
+
+    void set_command(std::string_view command)
+    {
+        m_command = command;
+    }
+    // Shell command run for this option; empty when it has none.
+    [[nodiscard]] const std::string& command() const
+    {
+        return m_command;
+    }
+
+    // Set on options read from a package list, whose name is then a package name.
+    void mark_package()
+    {
+        m_package = true;
+    }
+    [[nodiscard]] bool is_package() const
+    {
+        return m_package;
+    }
+
+    // An action takes precedence over the command.
+    void set_action(action_factory factory)
+    {
+        m_action = factory;
+    }
+    [[nodiscard]] action_factory get_action() const
+    {
+        return m_action;
+    }
+
+    // Number of option entries currently selected, groups included.
+    [[nodiscard]] static std::size_t selected_count()
+    {
+        return s_selection.count();
+    }
+    // Snapshot of the selection, unchanged by later edits, for a run to work from; see
+    // selection-set.h.
+    [[nodiscard]] static selection_set selection()
+    {
+        return s_selection;
+    }
+
+    static void set_observer(selection_observer* observer)
+    {
+        s_observer = observer;
     }
 
 protected:
-    bool m_selected = false;
+    void notify(bool selected) const
+    {
+        if (s_observer != nullptr)
+        {
+            s_observer->selection_changed(*this, selected);
+        }
+    }
+
+protected:
+    bool           m_package = false;
+    std::string    m_command{};
+    action_factory m_action = nullptr;
+
+    static inline selection_observer* s_observer = nullptr;
+    static inline selection_set       s_selection{};    //!< The live selection, by entry id.
 };
 
 
@@ -130,28 +318,87 @@ public:
         }
     }
 
+    // Appends `count` entries, returned by successive calls to `next`, as add() would, with a
+    // single reservation and highlight.
+    template<typename Generator>
+    void add_all(std::size_t count, Generator&& next)
+    {
+        bool wasEmpty = m_submenus.empty();
+        if (m_submenus.size() + count > m_submenus.capacity())
+        {
+            // Still grows geometrically, so that many small batches stay linear.
+            m_submenus.reserve(std::max(m_submenus.size() + count, 2 * m_submenus.capacity()));
+        }
+        for (std::size_t i = 0; i < count; i++)
+        {
+            m_submenus.push_back(next());
+        }
+
+        if (wasEmpty && !m_submenus.empty())
+        {
+            m_submenus[0]->highlight();
+        }
+    }
+
     [[nodiscard]] virtual menu_entry* highlighted_entry() const
     {
-        return m_submenus[m_currentMenu];
+        return m_submenus.empty() ? nullptr : m_submenus[m_currentMenu];
     }
 
+    void set_source(std::unique_ptr<menu_entry_source> source)
+    {
+        m_source = std::move(source);
+    }
+    [[nodiscard]] bool is_materialized() const
+    {
+        return m_source == nullptr;
+    }
+    void materialize();
+    void prefetch();
+
+    // Puts `entries[order[i]]` at position i. `order` must be a permutation of every position; the
+    // highlight stays on the entry it was on.
+    void set_order(std::span<menu_entry* const> entries, std::span<const std::uint32_t> order);
+    // Replaces the `count` entries from `index` by `entries`. The highlight stays on its entry, or
+    // moves to the one taking its place when it is removed.
+    void splice(std::size_t index, std::size_t count, std::span<menu_entry* const> entries);
+
     virtual void move_up()
     {
-        if (m_currentMenu > 0)
+        move_by(-1);
+    }
+    virtual void move_down()
+    {
+        move_by(1);
+    }
+
+    // Only the old and new entries are touched, so a jump costs the same as a single step.
+    virtual void move_to(std::size_t index)
+    {
+        if (m_submenus.empty())
+        {
+            return;
+        }
+
+        index = std::min(index, m_submenus.size() - 1);
+        if (index != m_currentMenu)
         {
             m_submenus[m_currentMenu]->dehighlight();
-            m_currentMenu--;
+            m_currentMenu = index;
             m_submenus[m_currentMenu]->highlight();
         }
     }
-    virtual void move_down()
+    virtual void move_by(std::ptrdiff_t delta)
     {
-        if (m_currentMenu < m_submenus.size() - 1)
+        if (delta < 0 && static_cast<std::size_t>(-delta) > m_currentMenu)
         {
-            m_submenus[m_currentMenu]->dehighlight();
-            m_currentMenu++;
-            m_submenus[m_currentMenu]->highlight();
+            return move_to(0);
         }
+        move_to(m_currentMenu + static_cast<std::size_t>(delta));
+    }
+    [[nodiscard]] virtual std::size_t current_index() const
+    {
+        return m_currentMenu;
     }
 
     [[nodiscard]] virtual bool can_enter() const
@@ -177,9 +424,13 @@ public:
         return m_submenus[index];
     }
 
+protected:
+    std::unique_ptr<menu_entry_source> m_source{};
+
 public:
     std::size_t m_currentMenu = 0;
-    std::vector<menu_entry*> m_submenus{};
+    std::vector<menu_entry*, tracking_allocator<menu_entry*, memory_category::submenu_lists>>
+        m_submenus{};
 };
 
 class menu_top_option_entry: public menu_top_entry, public menu_option_entry
@@ -191,6 +442,9 @@ public:
 
     void move_up() final;
     void move_down() final;
+    void move_to(std::size_t index) final;
+    void move_by(std::ptrdiff_t delta) final;
+    [[nodiscard]] std::size_t current_index() const final;
 
     [[nodiscard]] bool can_enter() const final;
     [[nodiscard]] bool can_select() const final;
@@ -200,6 +454,7 @@ public:
 
     void virtual select()
     {
+        materialize();
         menu_option_entry::select();
         for(menu_entry* menu : m_submenus)
         {
@@ -212,6 +467,7 @@ public:
 
     void virtual deselect()
     {
+        materialize();
         menu_option_entry::deselect();
         for(menu_entry* menu : m_submenus)
         {
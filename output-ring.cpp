@@ -0,0 +1,156 @@
+/**
+ * ===============================================================================================
+ * @file    output-ring.cpp
+ * @author  Pascal-Emmanuel Lachance
+ * @p       <a href="https://www.github.com/Raesangur">Raesangur</a>
+ * @p       <a href="https://www.raesangur.com/">https://www.raesangur.com/</a>
+ *
+ * @brief   Fixed-size scrollback buffer with a line index.
+ *
+ * ------------------------------------------------------------------------------------------------
+ * @copyright Copyright (c) 2023 Pascal-Emmanuel Lachance | Raesangur
+ *
+ * @par License: <a href="https://opensource.org/license/mit/"> MIT </a>
+ *               This project is released under the MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ * BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NON INFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ * ===============================================================================================
+ */
+/** ===============================================================================================
+ *  INCLUDES
+ */
+#include "output-ring.h"
+
+#include <algorithm>
+#include <cstring>
+
+
+/** ===============================================================================================
+ *  MEMBER FUNCTIONS DEFINITIONS
+ */
+
+output_ring::output_ring(std::size_t capacity, std::size_t maxLines, std::size_t maxReserve) :
+    m_capacity{std::max<std::size_t>(capacity, 1)},
+    m_data(m_capacity + std::max<std::size_t>(maxReserve, 1)),
+    m_lineStarts(std::max<std::size_t>(maxLines, 2))
+{
+    m_lineStarts[0] = 0;
+}
+
+
+[[nodiscard]] std::span<char> output_ring::reserve(std::size_t maxBytes)
+{
+    // The buffer's bytes past the capacity are never retained, so a reservation within them never
+    // overwrites what a reader may still reach.
+    std::size_t offset = static_cast<std::size_t>(m_head % m_data.size());
+    std::size_t length = std::min({maxBytes, m_data.size() - m_capacity, m_data.size() - offset});
+
+    m_reserved = length;
+    return std::span<char>{m_data.data() + offset, length};
+}
+
+void output_ring::commit(std::size_t count)
+{
+    count = std::min<std::size_t>(count, m_reserved);
+
+    const char* begin = m_data.data() + m_head % m_data.size();
+    const char* end   = begin + count;
+    for (const char* p = begin; p < end; p++)
+    {
+        p = static_cast<const char*>(std::memchr(p, '\n', static_cast<std::size_t>(end - p)));
+        if (p == nullptr)
+        {
+            break;
+        }
+        // The slot is taken from the oldest line, which evict() could no longer look at.
+        if (m_nextLine - m_firstLine == m_lineStarts.size())
+        {
+            m_firstLine++;
+        }
+
+        std::uint64_t start = m_head + static_cast<std::uint64_t>(p - begin) + 1;
+        m_lineStarts[m_nextLine % m_lineStarts.size()] = start;
+        m_nextLine++;
+    }
+
+    m_head += count;
+    m_reserved = 0;
+    evict();
+}
+
+void output_ring::append(std::string_view text)
+{
+    while (!text.empty())
+    {
+        std::span<char> area  = reserve(text.size());
+        std::size_t     count = std::min(area.size(), text.size());
+        std::memcpy(area.data(), text.data(), count);
+        commit(count);
+        text.remove_prefix(count);
+    }
+}
+
+
+[[nodiscard]] std::uint64_t output_ring::line_end() const
+{
+    // A newline opens the next line, which only counts once it has some text.
+    return line_start(m_nextLine - 1) == m_head ? m_nextLine - 1 : m_nextLine;
+}
+
+[[nodiscard]] std::string output_ring::line(std::uint64_t index, std::size_t maxBytes) const
+{
+    if (index < m_firstLine || index >= line_end())
+    {
+        return {};
+    }
+
+    std::uint64_t begin = std::max(line_start(index), tail());
+    std::uint64_t end   = index + 1 < m_nextLine ? line_start(index + 1) - 1 : m_head;
+    end                 = std::min(end, begin + maxBytes);
+
+    std::string text{};
+    text.reserve(static_cast<std::size_t>(end - begin));
+    while (begin < end)
+    {
+        std::size_t offset = static_cast<std::size_t>(begin % m_data.size());
+        std::size_t left   = static_cast<std::size_t>(end - begin);
+        std::size_t count  = std::min(left, m_data.size() - offset);
+        text.append(m_data.data() + offset, count);
+        begin += count;
+    }
+    return text;
+}
+
+
+[[nodiscard]] std::uint64_t output_ring::tail() const
+{
+    return m_head > m_capacity ? m_head - m_capacity : 0;
+}
+
+void output_ring::evict()
+{
+    // A line survives while any of its text does; commit() also drops it for its index slot.
+    std::uint64_t oldest = tail();
+    while (m_firstLine + 1 < m_nextLine && line_start(m_firstLine + 1) <= oldest)
+    {
+        m_firstLine++;
+    }
+}
+
+
+/**
+ * ------------------------------------------------------------------------------------------------
+ */
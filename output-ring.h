@@ -0,0 +1,125 @@
+/**
+ * ===============================================================================================
+ * @file    output-ring.h
+ * @author  Pascal-Emmanuel Lachance
+ * @p       <a href="https://www.github.com/Raesangur">Raesangur</a>
+ * @p       <a href="https://www.raesangur.com/">https://www.raesangur.com/</a>
+ *
+ * @brief   Fixed-size scrollback buffer with a line index.
+ *
+ * ------------------------------------------------------------------------------------------------
+ * @copyright Copyright (c) 2023 Pascal-Emmanuel Lachance | Raesangur
+ *
+ * @par License: <a href="https://opensource.org/license/mit/"> MIT </a>
+ *               This project is released under the MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ * BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NON INFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ * ------------------------------------------------------------------------------------------------
+ * @details
+ * An output_ring keeps the most recent `capacity` bytes written to it and the start offset of the
+ * most recent `maxLines` lines. Offsets are absolute (bytes written since creation), so a line
+ * stays addressable by number until either its text or its index slot is overwritten; memory use
+ * never depends on how much output went through.
+ *
+ * Writers fill the buffer in place: reserve() hands out contiguous space after the write position,
+ * taken from `maxReserve` bytes the buffer has past its capacity so that no retained output is in
+ * it, and commit() publishes what was actually written, evicting only as much old output. The ring
+ * itself is not synchronized; a caller sharing it between threads must hold a lock around every
+ * call, but not while filling a reserved area, since readers cannot reach it.
+ * ===============================================================================================
+ */
+#ifndef OUTPUT_RING_H
+#define OUTPUT_RING_H
+
+
+/** ===============================================================================================
+ *  INCLUDES
+ */
+#include "memory-accounting.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+
+/** ===============================================================================================
+ *  CLASS DEFINITION
+ */
+
+class output_ring
+{
+public:
+    output_ring(std::size_t capacity, std::size_t maxLines, std::size_t maxReserve = 4096);
+
+    output_ring(const output_ring&)    = delete;
+    void operator=(const output_ring&) = delete;
+
+    // Contiguous space of at most `maxBytes`, and of the ring's `maxReserve`, after the write
+    // position; nothing is evicted before commit().
+    [[nodiscard]] std::span<char> reserve(std::size_t maxBytes);
+    void                          commit(std::size_t count);
+    void                          append(std::string_view text);
+
+    // Retained lines are numbered [line_begin(), line_end()); the last one may be incomplete.
+    [[nodiscard]] std::uint64_t line_begin() const
+    {
+        return m_firstLine;
+    }
+    [[nodiscard]] std::uint64_t line_end() const;
+
+    // Copies a line without its newline, cut to `maxBytes`; its evicted beginning is skipped.
+    [[nodiscard]] std::string line(std::uint64_t index, std::size_t maxBytes) const;
+
+    [[nodiscard]] std::uint64_t total_bytes() const
+    {
+        return m_head;
+    }
+    [[nodiscard]] std::size_t capacity() const
+    {
+        return m_capacity;
+    }
+
+protected:
+    [[nodiscard]] std::uint64_t tail() const;
+    [[nodiscard]] std::uint64_t line_start(std::uint64_t index) const
+    {
+        return m_lineStarts[index % m_lineStarts.size()];
+    }
+    void evict();
+
+protected:
+    using buffer_t = std::vector<char, tracking_allocator<char, memory_category::task_output>>;
+    using index_t  =
+        std::vector<std::uint64_t, tracking_allocator<std::uint64_t, memory_category::task_output>>;
+
+    std::size_t m_capacity;    //!< Bytes retained; the buffer holds the reservation on top.
+    buffer_t    m_data;
+    index_t     m_lineStarts;
+
+    std::uint64_t m_head      = 0;    //!< Absolute offset of the next byte to write.
+    std::uint64_t m_reserved  = 0;    //!< Bytes handed out by reserve() and not committed yet.
+    std::uint64_t m_firstLine = 0;
+    std::uint64_t m_nextLine  = 1;    //!< Line 0 starts at offset 0.
+};
+
+
+#endif  // OUTPUT_RING_H
+/**
+ * ------------------------------------------------------------------------------------------------
+ */
@@ -0,0 +1,138 @@
+/**
+ * ===============================================================================================
+ * @file    output-view.cpp
+ * @author  Pascal-Emmanuel Lachance
+ * @p       <a href="https://www.github.com/Raesangur">Raesangur</a>
+ * @p       <a href="https://www.raesangur.com/">https://www.raesangur.com/</a>
+ *
+ * @brief   Shows the tail of a task's captured output in a window.
+ *
+ * ------------------------------------------------------------------------------------------------
+ * @copyright Copyright (c) 2023 Pascal-Emmanuel Lachance | Raesangur
+ *
+ * @par License: <a href="https://opensource.org/license/mit/"> MIT </a>
+ *               This project is released under the MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ * BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NON INFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ * ===============================================================================================
+ */
+/** ===============================================================================================
+ *  INCLUDES
+ */
+#include "output-view.h"
+
+#include "display-width.h"
+#include "theme.h"
+
+#include <algorithm>
+
+
+/** ===============================================================================================
+ *  MEMBER FUNCTIONS DEFINITIONS
+ */
+
+void output_view::render(const task* t)
+{
+    if (m_valid && t == m_task && (t == nullptr || t->generation() == m_generation))
+    {
+        return;
+    }
+
+    m_task       = t;
+    m_generation = t == nullptr ? 0 : t->generation();
+    m_valid      = true;
+
+    m_win.set_style(theme::get()->get(style_id::menu));
+    m_win.erase();
+    m_win.box();
+
+    int columns = m_win.width() - 2 * FIRST_COL;
+    if (t == nullptr)
+    {
+        m_win.print(0, clip_to_width("No task has run yet", m_win.width() - 2));
+        return;
+    }
+
+    std::string title = t->name();
+    switch (t->state())
+    {
+        case task_state::running:
+            title += " - running";
+            break;
+        case task_state::exited:
+            title += " - exit " + std::to_string(t->exit_code());
+            break;
+        case task_state::failed:
+            title += " - failed";
+            break;
+    }
+    m_win.print(0, clip_to_width(title, m_win.width() - 2));
+
+    // Rows below the title, clear of the bottom border.
+    int rows = std::max(0, m_win.height() - FIRST_ROW - 1);
+    t->with_output(
+        [&](const output_ring& output)
+        {
+            std::uint64_t end   = output.line_end();
+            std::uint64_t first = std::max(output.line_begin(),
+                                           end > static_cast<std::uint64_t>(rows) ? end - rows : 0);
+
+            int y = FIRST_ROW;
+            for (std::uint64_t i = first; i < end; i++, y++)
+            {
+                std::string text = sanitize(output.line(i, MAX_LINE_BYTES));
+                m_win.print(y, FIRST_COL, clip_to_width(text, columns));
+            }
+        });
+}
+
+void output_view::invalidate()
+{
+    m_valid = false;
+}
+
+
+[[nodiscard]] std::string output_view::sanitize(std::string_view text)
+{
+    std::string clean{};
+    clean.reserve(text.size());
+
+    for (std::size_t i = 0; i < text.size(); i++)
+    {
+        unsigned char ch = static_cast<unsigned char>(text[i]);
+        if (ch == 0x1B && i + 1 < text.size() && text[i + 1] == '[')
+        {
+            // CSI sequence: parameters and intermediates up to a final byte in 0x40-0x7E.
+            for (i += 2; i < text.size() && (text[i] < 0x40 || text[i] > 0x7E); i++)
+            {
+            }
+        }
+        else if (ch == '\t')
+        {
+            clean.append(4 - clean.size() % 4, ' ');
+        }
+        else if (ch >= 0x20 && ch != 0x7F)
+        {
+            clean += static_cast<char>(ch);
+        }
+    }
+    return clean;
+}
+
+
+/**
+ * ------------------------------------------------------------------------------------------------
+ */
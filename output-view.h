@@ -0,0 +1,79 @@
+/**
+ * ===============================================================================================
+ * @file    output-view.h
+ * @author  Pascal-Emmanuel Lachance
+ * @p       <a href="https://www.github.com/Raesangur">Raesangur</a>
+ * @p       <a href="https://www.raesangur.com/">https://www.raesangur.com/</a>
+ *
+ * @brief   Shows the tail of a task's captured output in a window.
+ *
+ * ------------------------------------------------------------------------------------------------
+ * @copyright Copyright (c) 2023 Pascal-Emmanuel Lachance | Raesangur
+ *
+ * @par License: <a href="https://opensource.org/license/mit/"> MIT </a>
+ *               This project is released under the MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ * BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NON INFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ * ===============================================================================================
+ */
+#ifndef OUTPUT_VIEW_H
+#define OUTPUT_VIEW_H
+
+
+/** ===============================================================================================
+ *  INCLUDES
+ */
+#include "task-runner.h"
+#include "window.h"
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+
+/** ===============================================================================================
+ *  CLASS DEFINITION
+ */
+
+class output_view
+{
+public:
+    output_view(window& win) : m_win{win} {}
+
+    // Redraws only if the task captured output or changed state since the previous frame.
+    void render(const task* t);
+    void invalidate();
+
+    // Removes terminal control sequences and characters that would corrupt the window.
+    [[nodiscard]] static std::string sanitize(std::string_view text);
+
+protected:
+    static constexpr int         FIRST_ROW      = 2;
+    static constexpr int         FIRST_COL      = 2;
+    static constexpr std::size_t MAX_LINE_BYTES = 1024;
+
+    window& m_win;
+
+    const task*   m_task       = nullptr;
+    std::uint64_t m_generation = 0;
+    bool          m_valid      = false;
+};
+
+
+#endif  // OUTPUT_VIEW_H
+/**
+ * ------------------------------------------------------------------------------------------------
+ */
@@ -0,0 +1,185 @@
+/**
+ * ===============================================================================================
+ * @file    package-status.cpp
+ * @author  Pascal-Emmanuel Lachance
+ * @p       <a href="https://www.github.com/Raesangur">Raesangur</a>
+ * @p       <a href="https://www.raesangur.com/">https://www.raesangur.com/</a>
+ *
+ * @brief   Cache of the packages installed on the system.
+ *
+ * ------------------------------------------------------------------------------------------------
+ * @copyright Copyright (c) 2023 Pascal-Emmanuel Lachance | Raesangur
+ *
+ * @par License: <a href="https://opensource.org/license/mit/"> MIT </a>
+ *               This project is released under the MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ * BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NON INFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ * ===============================================================================================
+ */
+/** ===============================================================================================
+ *  INCLUDES
+ */
+#include "package-status.h"
+
+#include "file-text.h"
+
+#include <chrono>
+#include <set>
+
+
+/** ===============================================================================================
+ *  CONSTANTS
+ */
+
+// dpkg writes its database several times while it runs; parse once it has been quiet for this long.
+constexpr auto SETTLE_DELAY = std::chrono::milliseconds{250};
+
+constexpr std::string_view PACKAGE_FIELD = "Package:";
+constexpr std::string_view STATUS_FIELD  = "Status:";
+
+
+/** ===============================================================================================
+ *  LOCAL FUNCTIONS
+ */
+
+static std::string_view field_value(std::string_view line, std::string_view field)
+{
+    line.remove_prefix(field.size());
+    line.remove_prefix(std::min(line.find_first_not_of(" \t"), line.size()));
+    while (!line.empty() && (line.back() == ' ' || line.back() == '\r'))
+    {
+        line.remove_suffix(1);
+    }
+    return line;
+}
+
+
+/** ===============================================================================================
+ *  SINGLETON INSTANCE
+ */
+package_status* package_status::m_instance = nullptr;
+
+
+/** ===============================================================================================
+ *  MEMBER FUNCTIONS DEFINITIONS
+ */
+
+package_status::package_status() : m_watcher{SETTLE_DELAY}
+{
+}
+
+[[nodiscard]] package_status* package_status::get()
+{
+    if (m_instance == nullptr)
+    {
+        m_instance = new package_status;
+    }
+    return m_instance;
+}
+
+
+void package_status::start(std::string_view path)
+{
+    if (!m_path.empty())
+    {
+        return;
+    }
+
+    m_path = path;
+    event_loop::get()->spawn_service(watch());
+}
+
+[[nodiscard]] std::shared_ptr<const package_status::name_set> package_status::installed() const
+{
+    std::lock_guard lock{m_mutex};
+    return m_installed;
+}
+
+
+[[nodiscard]] std::shared_ptr<const package_status::name_set> package_status::parse(
+  const std::string& path)
+{
+    auto installed = std::make_shared<name_set>();
+
+    std::string text{};
+    read_whole_file(path, text);
+    std::string_view rest{text};
+
+    std::string_view package{};
+    bool             isInstalled = false;
+    while (!rest.empty() || !package.empty())
+    {
+        std::size_t      newline = rest.find('\n');
+        std::string_view line    = rest.substr(0, newline);
+        rest.remove_prefix(newline == std::string_view::npos ? rest.size() : newline + 1);
+
+        // A blank line, or the end of the file, closes the stanza.
+        if (line.empty() || line == "\r")
+        {
+            if (isInstalled && !package.empty())
+            {
+                installed->emplace(package);
+            }
+            package     = {};
+            isInstalled = false;
+        }
+        else if (line.starts_with(PACKAGE_FIELD))
+        {
+            package = field_value(line, PACKAGE_FIELD);
+        }
+        else if (line.starts_with(STATUS_FIELD))
+        {
+            std::string_view status = field_value(line, STATUS_FIELD);
+            isInstalled             = status == "installed" || status.ends_with(" installed");
+        }
+    }
+
+    return installed;
+}
+
+
+action package_status::watch()
+{
+    publish(co_await offload{[this] { return parse(m_path); }});
+
+    // The package manager replaces the file rather than writing it in place.
+    if (!m_watcher.add(m_path))
+    {
+        co_return;
+    }
+
+    while (true)
+    {
+        std::set<std::string> changed{};
+        co_await m_watcher.changes(changed);
+
+        publish(co_await offload{[this] { return parse(m_path); }});
+    }
+}
+
+void package_status::publish(std::shared_ptr<const name_set> installed)
+{
+    {
+        std::lock_guard lock{m_mutex};
+        m_installed = std::move(installed);
+    }
+    m_generation.fetch_add(1, std::memory_order_acq_rel);
+}
+
+
+/**
+ * ------------------------------------------------------------------------------------------------
+ */
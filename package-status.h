@@ -0,0 +1,136 @@
+/**
+ * ===============================================================================================
+ * @file    package-status.h
+ * @author  Pascal-Emmanuel Lachance
+ * @p       <a href="https://www.github.com/Raesangur">Raesangur</a>
+ * @p       <a href="https://www.raesangur.com/">https://www.raesangur.com/</a>
+ *
+ * @brief   Cache of the packages installed on the system.
+ *
+ * ------------------------------------------------------------------------------------------------
+ * @copyright Copyright (c) 2023 Pascal-Emmanuel Lachance | Raesangur
+ *
+ * @par License: <a href="https://opensource.org/license/mit/"> MIT </a>
+ *               This project is released under the MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ * BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NON INFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ * ------------------------------------------------------------------------------------------------
+ * @details
+ * The package database is parsed once, on the thread pool, into a hash set of the names of the
+ * installed packages. An action then watches the database's directory with inotify and parses it
+ * again when the package manager replaces or rewrites it, once a burst of writes has settled. Each
+ * parse produces a new set, swapped in whole, so lookups never wait on a parse: the interface takes
+ * the current set once per frame and every row is then a single hash lookup.
+ *
+ * The database is dpkg's status file unless another is given, such as a fixture written by hand:
+ * stanzas separated by blank lines, where a package is installed when its `Status:` field ends with
+ * "installed". A missing or unreadable file reads as no package installed.
+ * ===============================================================================================
+ */
+#ifndef PACKAGE_STATUS_H
+#define PACKAGE_STATUS_H
+
+
+/** ===============================================================================================
+ *  INCLUDES
+ */
+#include "action.h"
+#include "file-watcher.h"
+#include "memory-accounting.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_set>
+
+
+/** ===============================================================================================
+ *  CONSTANTS
+ */
+
+constexpr std::string_view DPKG_STATUS_PATH = "/var/lib/dpkg/status";
+
+
+/** ===============================================================================================
+ *  CLASS DEFINITION
+ */
+
+// Lets a set of strings be searched with a string_view without building a string.
+struct string_hash
+{
+    using is_transparent = void;
+
+    [[nodiscard]] std::size_t operator()(std::string_view str) const noexcept
+    {
+        return std::hash<std::string_view>{}(str);
+    }
+};
+
+
+class package_status
+{
+protected:
+    package_status();
+
+public:
+    using name_set =
+        std::unordered_set<std::string, string_hash, std::equal_to<>,
+                           tracking_allocator<std::string, memory_category::installed_packages>>;
+
+    package_status(const package_status&)  = delete;
+    package_status(const package_status&&) = delete;
+    void operator=(const package_status&)  = delete;
+
+    [[nodiscard]] static package_status* get();
+
+    // Loads `path` and keeps watching it, from the event loop. Only the first call does anything.
+    void start(std::string_view path = DPKG_STATUS_PATH);
+
+    // The current set; never null, and empty until the first parse is done.
+    [[nodiscard]] std::shared_ptr<const name_set> installed() const;
+    // Bumped each time a new set is swapped in.
+    [[nodiscard]] std::uint64_t generation() const
+    {
+        return m_generation.load(std::memory_order_acquire);
+    }
+
+    [[nodiscard]] static std::shared_ptr<const name_set> parse(const std::string& path);
+
+protected:
+    action watch();
+    void   publish(std::shared_ptr<const name_set> installed);
+
+protected:
+    static package_status* m_instance;
+
+    std::string  m_path{};
+    file_watcher m_watcher;
+
+    mutable std::mutex              m_mutex{};
+    std::shared_ptr<const name_set> m_installed = std::make_shared<const name_set>();
+    std::atomic<std::uint64_t>      m_generation{0};
+};
+
+
+#endif  // PACKAGE_STATUS_H
+/**
+ * ------------------------------------------------------------------------------------------------
+ */
@@ -0,0 +1,304 @@
+/**
+ * ===============================================================================================
+ * @file    render-bench.cpp
+ * @author  Pascal-Emmanuel Lachance
+ * @p       <a href="https://www.github.com/Raesangur">Raesangur</a>
+ * @p       <a href="https://www.raesangur.com/">https://www.raesangur.com/</a>
+ *
+ * @brief   Compares the terminal output of the ncurses and native renderers.
+ *
+ * ------------------------------------------------------------------------------------------------
+ * @copyright Copyright (c) 2023 Pascal-Emmanuel Lachance | Raesangur
+ *
+ * @par License: <a href="https://opensource.org/license/mit/"> MIT </a>
+ *               This project is released under the MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ * BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NON INFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ * ------------------------------------------------------------------------------------------------
+ * @details
+ * Usage: render_bench [ncurses_test]
+ *
+ * Runs ncurses_test (by default, the one next to render_bench) on a pseudo-terminal twice, once
+ * drawing through ncurses and once with --native, and types the same fixed script of navigation
+ * keys into both. Each key is given time for its frame to be drawn before the next one is sent.
+ *
+ * For every key, prints the bytes the terminal received and the write system calls the program
+ * made, as counted by /proc/<pid>/io, so that both renderers are measured the same way. The first
+ * frame, which paints the whole screen, is reported apart.
+ * ===============================================================================================
+ */
+/** ===============================================================================================
+ *  INCLUDES
+ */
+#include <array>
+#include <cerrno>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <string_view>
+
+#include <poll.h>
+#include <pty.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+
+/** ===============================================================================================
+ *  CONSTANTS
+ */
+
+constexpr unsigned short SCREEN_ROWS = 40;
+constexpr unsigned short SCREEN_COLS = 120;
+
+// A frame is considered drawn once the terminal received nothing for this long.
+constexpr int SETTLE_MS  = 150;
+constexpr int STARTUP_MS = 1000;
+constexpr int EXIT_MS    = 2000;
+
+// Keys are sent in keypad application mode, as ncurses asks the terminal to.
+constexpr std::string_view KEY_UP    = "\x1bOA";
+constexpr std::string_view KEY_DOWN  = "\x1bOB";
+constexpr std::string_view KEY_PGUP  = "\x1b[5~";
+constexpr std::string_view KEY_PGDN  = "\x1b[6~";
+constexpr std::string_view KEY_HOME  = "\x1bOH";
+constexpr std::string_view KEY_END   = "\x1bOF";
+constexpr std::string_view KEY_ENTER = "\n";
+constexpr std::string_view KEY_ESC   = "\x1b";
+
+// Moves through the default menu, into a submenu and back, and through the table and tree views.
+constexpr std::array<std::string_view, 24> KEY_SCRIPT = {
+  // The top menu.
+  KEY_DOWN,
+  KEY_DOWN,
+  KEY_DOWN,
+  KEY_UP,
+  KEY_PGDN,
+  KEY_PGUP,
+  KEY_END,
+  KEY_HOME,
+  // Its first submenu.
+  KEY_ENTER,
+  KEY_DOWN,
+  KEY_DOWN,
+  KEY_UP,
+  KEY_ESC,
+  // The table view.
+  "t",
+  KEY_DOWN,
+  KEY_DOWN,
+  "t",
+  // The tree view.
+  "v",
+  KEY_DOWN,
+  KEY_DOWN,
+  KEY_DOWN,
+  KEY_UP,
+  KEY_END,
+  "v",
+};
+
+/** ===============================================================================================
+ *  TYPES
+ */
+
+struct run_result
+{
+    bool        ok            = false;
+    std::size_t firstBytes    = 0;
+    std::size_t firstSyscalls = 0;
+    std::size_t bytes         = 0;
+    std::size_t syscalls      = 0;
+};
+
+
+/** ===============================================================================================
+ *  LOCAL FUNCTIONS
+ */
+
+// Reads everything the program writes until it stays quiet for `quietMs`, or exits.
+static std::size_t drain(int master, int quietMs)
+{
+    std::size_t             total = 0;
+    std::array<char, 65536> buffer{};
+    while (true)
+    {
+        pollfd fd{master, POLLIN, 0};
+        int    ready = ::poll(&fd, 1, quietMs);
+        if (ready < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (ready <= 0)
+        {
+            return total;
+        }
+
+        ssize_t got = ::read(master, buffer.data(), buffer.size());
+        if (got <= 0)
+        {
+            // The slave side is gone: the program exited.
+            return total;
+        }
+        total += static_cast<std::size_t>(got);
+    }
+}
+
+// Write system calls made so far by every thread of `pid`.
+static std::size_t write_syscalls(pid_t pid)
+{
+    std::ifstream io{"/proc/" + std::to_string(pid) + "/io"};
+    std::string   field{};
+    std::size_t   value = 0;
+    while (io >> field >> value)
+    {
+        if (field == "syscw:")
+        {
+            return value;
+        }
+    }
+    return 0;
+}
+
+static void send(int master, std::string_view key)
+{
+    while (!key.empty())
+    {
+        ssize_t written = ::write(master, key.data(), key.size());
+        if (written < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            return;
+        }
+        key.remove_prefix(static_cast<std::size_t>(written));
+    }
+}
+
+static run_result run(const std::filesystem::path& program, bool native)
+{
+    // The program keeps its selection journal in its working directory.
+    std::string directory = (std::filesystem::temp_directory_path() / "render-bench.XXXXXX");
+    if (::mkdtemp(directory.data()) == nullptr)
+    {
+        std::perror("mkdtemp");
+        return {};
+    }
+
+    winsize size{SCREEN_ROWS, SCREEN_COLS, 0, 0};
+    int     master = -1;
+    pid_t   pid    = ::forkpty(&master, nullptr, nullptr, &size);
+    if (pid < 0)
+    {
+        std::perror("forkpty");
+        std::filesystem::remove_all(directory);
+        return {};
+    }
+    if (pid == 0)
+    {
+        ::setenv("TERM", "xterm-256color", 1);
+        ::setenv("ESCDELAY", "25", 1);
+        if (::chdir(directory.c_str()) == 0)
+        {
+            if (native)
+            {
+                ::execl(program.c_str(), program.c_str(), "--native", nullptr);
+            }
+            else
+            {
+                ::execl(program.c_str(), program.c_str(), nullptr);
+            }
+        }
+        std::perror(program.c_str());
+        ::_exit(127);
+    }
+
+    run_result result{};
+    result.firstBytes    = drain(master, STARTUP_MS);
+    result.firstSyscalls = write_syscalls(pid);
+    for (std::string_view key : KEY_SCRIPT)
+    {
+        send(master, key);
+        result.bytes += drain(master, SETTLE_MS);
+    }
+    result.syscalls = write_syscalls(pid) - result.firstSyscalls;
+
+    send(master, "q");
+    drain(master, EXIT_MS);
+
+    int status = 0;
+    if (::waitpid(pid, &status, WNOHANG) == 0)
+    {
+        ::kill(pid, SIGKILL);
+        ::waitpid(pid, &status, 0);
+    }
+    ::close(master);
+    std::filesystem::remove_all(directory);
+
+    result.ok = WIFEXITED(status) && WEXITSTATUS(status) == 0 && result.firstBytes > 0;
+    return result;
+}
+
+static bool report(const char* name, const run_result& result)
+{
+    if (!result.ok)
+    {
+        std::fprintf(stderr, "%s: the program did not run to completion\n", name);
+        return false;
+    }
+
+    double frames = static_cast<double>(KEY_SCRIPT.size());
+    std::printf("%-8s %8.1f bytes/frame %6.2f syscalls/frame, first frame %zu bytes in %zu\n",
+                name,
+                static_cast<double>(result.bytes) / frames,
+                static_cast<double>(result.syscalls) / frames,
+                result.firstBytes,
+                result.firstSyscalls);
+    return true;
+}
+
+
+/** ===============================================================================================
+ *  FUNCTION DEFINITIONS
+ */
+
+int main(int argc, char* argv[])
+{
+    std::filesystem::path program = argc > 1 ? std::filesystem::path{argv[1]}
+                                             : std::filesystem::path{argv[0]}.parent_path() /
+                                                 "ncurses_test";
+    if (argc > 2 || ::access(program.c_str(), X_OK) != 0)
+    {
+        std::fprintf(stderr, "usage: %s [ncurses_test]\n", argv[0]);
+        return 1;
+    }
+    program = std::filesystem::absolute(program);
+
+    std::printf("%zu keys on a %dx%d terminal\n", KEY_SCRIPT.size(), SCREEN_COLS, SCREEN_ROWS);
+    bool ok = report("ncurses", run(program, false));
+    ok      = report("native", run(program, true)) && ok;
+    return ok ? 0 : 1;
+}
+
+
+/**
+ * ------------------------------------------------------------------------------------------------
+ */
@@ -0,0 +1,302 @@
+/**
+ * ===============================================================================================
+ * @file    selection-journal.cpp
+ * @author  Pascal-Emmanuel Lachance
+ * @p       <a href="https://www.github.com/Raesangur">Raesangur</a>
+ * @p       <a href="https://www.raesangur.com/">https://www.raesangur.com/</a>
+ *
+ * @brief   Journaled persistence of the selected menu entries.
+ *
+ * ------------------------------------------------------------------------------------------------
+ * @copyright Copyright (c) 2023 Pascal-Emmanuel Lachance | Raesangur
+ *
+ * @par License: <a href="https://opensource.org/license/mit/"> MIT </a>
+ *               This project is released under the MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ * BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NON INFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ * ===============================================================================================
+ */
+
+/** ===============================================================================================
+ *  INCLUDES
+ */
+#include "selection-journal.h"
+
+#include "file-text.h"
+
+#include <cerrno>
+#include <cstdio>
+#include <fcntl.h>
+#include <string_view>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <unordered_set>
+
+
+/** ===============================================================================================
+ *  CONSTANTS
+ */
+
+constexpr std::size_t COMPACTION_THRESHOLD = 1024 * 1024;
+
+
+/** ===============================================================================================
+ *  LOCAL FUNCTIONS
+ */
+
+static bool write_all(int fd, std::string_view data)
+{
+    while (!data.empty())
+    {
+        ssize_t count = ::write(fd, data.data(), data.size());
+        if (count < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            return false;
+        }
+        data.remove_prefix(static_cast<std::size_t>(count));
+    }
+    return true;
+}
+
+template<typename F>
+static void for_each_line(std::string_view text, F&& callback)
+{
+    while (!text.empty())
+    {
+        std::size_t end = text.find('\n');
+        callback(text.substr(0, end));
+        text.remove_prefix(end == std::string_view::npos ? text.size() : end + 1);
+    }
+}
+
+
+/** ===============================================================================================
+ *  MEMBER FUNCTIONS DEFINITIONS
+ */
+
+selection_journal::selection_journal(const std::string& basename) :
+    m_snapshotPath{basename + ".snapshot"}, m_journalPath{basename + ".journal"}
+{
+}
+
+selection_journal::~selection_journal()
+{
+    stop();
+}
+
+
+std::size_t selection_journal::restore(menu_manager* mm)
+{
+    std::size_t applied = 0;
+
+    auto apply = [&](std::string_view name, bool selected)
+    {
+        menu_entry* entry = mm->find(name);
+        if (entry == nullptr)
+        {
+            // Lazy submenus have not built their children yet; they pick the state up when added.
+            if (mm->defer_selection(name, selected))
+            {
+                applied++;
+            }
+        }
+        else if (auto* option = dynamic_cast<menu_option_entry*>(entry); option != nullptr)
+        {
+            option->set_selected(selected);
+            applied++;
+        }
+    };
+
+    std::string text{};
+    read_whole_file(m_snapshotPath, text);
+    for_each_line(text,
+                  [&](std::string_view line)
+                  {
+                      apply(line, true);
+                  });
+    read_whole_file(m_journalPath, text);
+    for_each_line(text,
+                  [&](std::string_view line)
+                  {
+                      if (line.size() > 1)
+                      {
+                          apply(line.substr(1), line.front() == '+');
+                      }
+                  });
+
+    return applied;
+}
+
+void selection_journal::start()
+{
+    m_journalFd = ::open(m_journalPath.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+    if (m_journalFd < 0)
+    {
+        return;
+    }
+
+    struct stat info{};
+    if (::fstat(m_journalFd, &info) == 0)
+    {
+        m_journalBytes = static_cast<std::size_t>(info.st_size);
+    }
+
+    m_stopping = false;
+    m_writer   = std::thread{&selection_journal::write_loop, this};
+    menu_option_entry::set_observer(this);
+}
+
+void selection_journal::stop()
+{
+    if (!m_writer.joinable())
+    {
+        return;
+    }
+
+    menu_option_entry::set_observer(nullptr);
+    {
+        std::lock_guard lock{m_mutex};
+        m_stopping = true;
+    }
+    m_wakeup.notify_one();
+    m_writer.join();
+
+    compact();
+    ::close(m_journalFd);
+    m_journalFd = -1;
+}
+
+
+void selection_journal::selection_changed(const menu_entry& entry, bool selected)
+{
+    bool wasEmpty = false;
+    {
+        std::lock_guard lock{m_mutex};
+        wasEmpty = m_pending.empty();
+
+        m_pending += selected ? '+' : '-';
+        m_pending += entry.get_name();
+        m_pending += '\n';
+    }
+
+    if (wasEmpty)
+    {
+        m_wakeup.notify_one();
+    }
+}
+
+
+void selection_journal::write_loop()
+{
+    while (true)
+    {
+        {
+            std::unique_lock lock{m_mutex};
+            m_wakeup.wait(lock,
+                          [this]
+                          {
+                              return m_stopping || !m_pending.empty();
+                          });
+            if (m_pending.empty())
+            {
+                return;
+            }
+
+            // Swapping keeps both buffers' capacity, so steady-state appends do not allocate.
+            m_pending.swap(m_writing);
+        }
+
+        if (write_all(m_journalFd, m_writing))
+        {
+            m_journalBytes += m_writing.size();
+        }
+        m_writing.clear();
+
+        if (m_journalBytes >= COMPACTION_THRESHOLD)
+        {
+            compact();
+        }
+    }
+}
+
+void selection_journal::compact()
+{
+    std::string snapshot{};
+    std::string journal{};
+    read_whole_file(m_snapshotPath, snapshot);
+    read_whole_file(m_journalPath, journal);
+    if (journal.empty())
+    {
+        return;
+    }
+
+    std::unordered_set<std::string_view> selected{};
+    for_each_line(snapshot,
+                  [&](std::string_view line)
+                  {
+                      selected.insert(line);
+                  });
+    for_each_line(journal,
+                  [&](std::string_view line)
+                  {
+                      if (line.size() <= 1)
+                      {
+                          return;
+                      }
+                      if (line.front() == '+')
+                      {
+                          selected.insert(line.substr(1));
+                      }
+                      else
+                      {
+                          selected.erase(line.substr(1));
+                      }
+                  });
+
+    std::string content{};
+    for (std::string_view name : selected)
+    {
+        content += name;
+        content += '\n';
+    }
+
+    std::string temporary = m_snapshotPath + ".tmp";
+    int         fd        = ::open(temporary.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0)
+    {
+        return;
+    }
+
+    bool written = write_all(fd, content) && ::fsync(fd) == 0;
+    ::close(fd);
+
+    if (written && std::rename(temporary.c_str(), m_snapshotPath.c_str()) == 0)
+    {
+        if (::ftruncate(m_journalFd, 0) == 0)
+        {
+            m_journalBytes = 0;
+        }
+    }
+}
+
+
+/**
+ * ------------------------------------------------------------------------------------------------
+ */
@@ -0,0 +1,99 @@
+/**
+ * ===============================================================================================
+ * @file    selection-journal.h
+ * @author  Pascal-Emmanuel Lachance
+ * @p       <a href="https://www.github.com/Raesangur">Raesangur</a>
+ * @p       <a href="https://www.raesangur.com/">https://www.raesangur.com/</a>
+ *
+ * @brief   Journaled persistence of the selected menu entries.
+ *
+ * ------------------------------------------------------------------------------------------------
+ * @copyright Copyright (c) 2023 Pascal-Emmanuel Lachance | Raesangur
+ *
+ * @par License: <a href="https://opensource.org/license/mit/"> MIT </a>
+ *               This project is released under the MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ * BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NON INFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ * ------------------------------------------------------------------------------------------------
+ * @details
+ * Selection changes are recorded per entry, as `+name` or `-name` lines, into `<base>.journal`.
+ * The input loop only appends to an in-memory buffer; a writer thread owns the files, appends the
+ * buffer to the journal and, once the journal grows past a threshold, folds it into
+ * `<base>.snapshot`, which lists the selected entries one per line.
+ * Journal records are idempotent, so replaying a journal over a snapshot that already contains it
+ * is harmless: a crash between writing the new snapshot and truncating the journal loses nothing.
+ * ===============================================================================================
+ */
+#ifndef SELECTION_JOURNAL_H
+#define SELECTION_JOURNAL_H
+
+
+/** ===============================================================================================
+ *  INCLUDES
+ */
+#include "menu-manager.h"
+#include "menu.h"
+
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <string>
+#include <thread>
+
+
+/** ===============================================================================================
+ *  CLASS DEFINITION
+ */
+
+class selection_journal : public selection_observer
+{
+public:
+    selection_journal(const std::string& basename);
+    ~selection_journal() override;
+
+    selection_journal(const selection_journal&) = delete;
+    void operator=(const selection_journal&)    = delete;
+
+    std::size_t restore(menu_manager* mm);
+    void        start();
+    void        stop();
+
+    void selection_changed(const menu_entry& entry, bool selected) override;
+
+protected:
+    void write_loop();
+    void compact();
+
+protected:
+    std::string m_snapshotPath;
+    std::string m_journalPath;
+    int         m_journalFd    = -1;
+    std::size_t m_journalBytes = 0;
+
+    std::mutex              m_mutex{};
+    std::condition_variable m_wakeup{};
+    std::string             m_pending{};
+    std::string             m_writing{};
+    bool                    m_stopping = false;
+
+    std::thread m_writer{};
+};
+
+
+#endif  // SELECTION_JOURNAL_H
+/**
+ * ------------------------------------------------------------------------------------------------
+ */
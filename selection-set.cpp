@@ -0,0 +1,127 @@
+/**
+ * ===============================================================================================
+ * @file    selection-set.cpp
+ * @author  Pascal-Emmanuel Lachance
+ * @p       <a href="https://www.github.com/Raesangur">Raesangur</a>
+ * @p       <a href="https://www.raesangur.com/">https://www.raesangur.com/</a>
+ *
+ * @brief   Set of selected entries, with copy-on-write snapshots.
+ *
+ * ------------------------------------------------------------------------------------------------
+ * @copyright Copyright (c) 2023 Pascal-Emmanuel Lachance | Raesangur
+ *
+ * @par License: <a href="https://opensource.org/license/mit/"> MIT </a>
+ *               This project is released under the MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ * BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NON INFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ * ===============================================================================================
+ */
+/** ===============================================================================================
+ *  INCLUDES
+ */
+#include "selection-set.h"
+
+#include <atomic>
+
+
+/** ===============================================================================================
+ *  TYPES
+ */
+
+template<typename T>
+using selection_allocator = tracking_allocator<T, memory_category::selection_chunks>;
+
+
+/** ===============================================================================================
+ *  MEMBER FUNCTIONS DEFINITIONS
+ */
+
+template<typename T>
+T& selection_set::own(std::shared_ptr<const node>& slot)
+{
+    if (slot == nullptr)
+    {
+        slot = std::allocate_shared<T>(selection_allocator<T>{});
+    }
+    else if (slot.use_count() > 1)
+    {
+        slot = std::allocate_shared<T>(selection_allocator<T>{}, static_cast<const T&>(*slot));
+    }
+    else
+    {
+        // The last snapshot sharing the node may just have been dropped by another thread; its
+        // reads must be over before the node is written to.
+        std::atomic_thread_fence(std::memory_order_acquire);
+    }
+
+    // Only nodes held by this set alone are written to, and they were not created const.
+    return const_cast<T&>(static_cast<const T&>(*slot));
+}
+
+
+[[nodiscard]] bool selection_set::test(std::uint32_t id) const
+{
+    if (m_root == nullptr || id >= capacity())
+    {
+        return false;
+    }
+
+    const node* current = m_root.get();
+    for (int level = m_height; level > 0 && current != nullptr; level--)
+    {
+        current = static_cast<const branch*>(current)->children[child_index(id, level)].get();
+    }
+    if (current == nullptr)
+    {
+        return false;
+    }
+
+    std::uint64_t word = static_cast<const chunk*>(current)->words[(id % CHUNK_BITS) / 64];
+    return ((word >> (id % 64)) & 1) != 0;
+}
+
+bool selection_set::set(std::uint32_t id, bool selected)
+{
+    if (test(id) == selected)
+    {
+        return false;
+    }
+
+    // The old tree becomes the first child of a taller one, so that the ids it holds keep their
+    // place.
+    while (id >= capacity())
+    {
+        auto taller         = std::allocate_shared<branch>(selection_allocator<branch>{});
+        taller->children[0] = std::move(m_root);
+        m_root              = std::move(taller);
+        m_height++;
+    }
+
+    std::shared_ptr<const node>* slot = &m_root;
+    for (int level = m_height; level > 0; level--)
+    {
+        slot = &own<branch>(*slot).children[child_index(id, level)];
+    }
+    own<chunk>(*slot).words[(id % CHUNK_BITS) / 64] ^= std::uint64_t{1} << (id % 64);
+
+    m_count = selected ? m_count + 1 : m_count - 1;
+    return true;
+}
+
+
+/**
+ * ------------------------------------------------------------------------------------------------
+ */
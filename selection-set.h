@@ -0,0 +1,126 @@
+/**
+ * ===============================================================================================
+ * @file    selection-set.h
+ * @author  Pascal-Emmanuel Lachance
+ * @p       <a href="https://www.github.com/Raesangur">Raesangur</a>
+ * @p       <a href="https://www.raesangur.com/">https://www.raesangur.com/</a>
+ *
+ * @brief   Set of selected entries, with copy-on-write snapshots.
+ *
+ * ------------------------------------------------------------------------------------------------
+ * @copyright Copyright (c) 2023 Pascal-Emmanuel Lachance | Raesangur
+ *
+ * @par License: <a href="https://opensource.org/license/mit/"> MIT </a>
+ *               This project is released under the MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ * BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NON INFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ * ------------------------------------------------------------------------------------------------
+ * @details
+ * Selections are bits indexed by menu_entry::id(), kept in chunks of CHUNK_BITS bits under a tree
+ * of branches of FANOUT children each, as deep as the largest id requires. Copying a selection_set
+ * is its snapshot: it only copies the root pointer, so it takes the same time for a million
+ * selected entries as for none, and the copy shares every chunk with the original. Changing either
+ * one then copies the chunk holding the bit and the branches above it, when they are shared, and
+ * nothing else; the rest stays shared until it is changed in turn.
+ *
+ * A run can so take a snapshot of the selection when it starts and work from it while the user
+ * keeps editing the live one. A set is changed by one thread at a time, while its snapshots can be
+ * read, and dropped, from any thread: shared nodes are never written to.
+ * ===============================================================================================
+ */
+#ifndef SELECTION_SET_H
+#define SELECTION_SET_H
+
+
+/** ===============================================================================================
+ *  INCLUDES
+ */
+#include "memory-accounting.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+
+/** ===============================================================================================
+ *  CLASS DEFINITION
+ */
+
+class selection_set
+{
+public:
+    [[nodiscard]] bool test(std::uint32_t id) const;
+    // Returns false when the entry already was in that state.
+    bool set(std::uint32_t id, bool selected);
+
+    [[nodiscard]] std::size_t count() const
+    {
+        return m_count;
+    }
+
+protected:
+    static constexpr int         CHUNK_SHIFT  = 12;
+    static constexpr std::size_t CHUNK_BITS   = std::size_t{1} << CHUNK_SHIFT;
+    static constexpr std::size_t CHUNK_WORDS  = CHUNK_BITS / 64;
+    static constexpr int         FANOUT_SHIFT = 6;
+    static constexpr std::size_t FANOUT       = std::size_t{1} << FANOUT_SHIFT;
+
+    struct node
+    {
+    };
+
+    struct chunk : node
+    {
+        std::array<std::uint64_t, CHUNK_WORDS> words{};
+    };
+
+    struct branch : node
+    {
+        std::array<std::shared_ptr<const node>, FANOUT> children{};
+    };
+
+    // One past the largest id the tree can hold at its current height.
+    [[nodiscard]] std::uint64_t capacity() const
+    {
+        return std::uint64_t{CHUNK_BITS} << (FANOUT_SHIFT * m_height);
+    }
+    // Index, in a branch `level` levels above the chunks, of the child on the way to `id`.
+    [[nodiscard]] static std::size_t child_index(std::uint32_t id, int level)
+    {
+        return (id >> (CHUNK_SHIFT + FANOUT_SHIFT * (level - 1))) & (FANOUT - 1);
+    }
+
+    // The node in `slot`, made its own first: created when missing, copied when shared.
+    template<typename T>
+    static T& own(std::shared_ptr<const node>& slot);
+
+protected:
+    std::shared_ptr<const node> m_root{};
+    int                         m_height = 0;    //!< Levels of branches above the chunks.
+    std::size_t                 m_count  = 0;
+};
+
+
+#endif  // SELECTION_SET_H
+/**
+ * ------------------------------------------------------------------------------------------------
+ */
+
+
+/**
+ * ------------------------------------------------------------------------------------------------
+ */
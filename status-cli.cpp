@@ -0,0 +1,158 @@
+/**
+ * ===============================================================================================
+ * @file    status-cli.cpp
+ * @author  Pascal-Emmanuel Lachance
+ * @p       <a href="https://www.github.com/Raesangur">Raesangur</a>
+ * @p       <a href="https://www.raesangur.com/">https://www.raesangur.com/</a>
+ *
+ * @brief   Command line reader for the shared-memory status segments.
+ *
+ * ------------------------------------------------------------------------------------------------
+ * @copyright Copyright (c) 2023 Pascal-Emmanuel Lachance | Raesangur
+ *
+ * @par License: <a href="https://opensource.org/license/mit/"> MIT </a>
+ *               This project is released under the MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ * BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NON INFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ * ------------------------------------------------------------------------------------------------
+ * @details
+ * Usage: ncurses_status [--watch <milliseconds>] [pid...]
+ *
+ * Prints the status published by every running ncurses_test, or by the given processes only. With
+ * --watch, the segments are mapped once and polled at the given interval until interrupted.
+ * ===============================================================================================
+ */
+/** ===============================================================================================
+ *  INCLUDES
+ */
+#include "status-segment.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <thread>
+#include <vector>
+
+
+/** ===============================================================================================
+ *  LOCAL FUNCTIONS
+ */
+
+static std::uint64_t now_ns()
+{
+    timespec ts{};
+    ::clock_gettime(CLOCK_REALTIME, &ts);
+    return static_cast<std::uint64_t>(ts.tv_sec) * 1'000'000'000u +
+           static_cast<std::uint64_t>(ts.tv_nsec);
+}
+
+static void print_status(const status_reader& reader)
+{
+    status_snapshot snapshot{};
+    if (!reader.read(snapshot))
+    {
+        std::printf("%d: busy\n", reader.pid());
+        return;
+    }
+
+    std::uint64_t now   = now_ns();
+    std::uint64_t ageMs = now > snapshot.timestampNs ? (now - snapshot.timestampNs) / 1'000'000 : 0;
+
+    std::printf("%d: %s menu '%s' depth %u, entry %u/%u, %u selected, "
+                "tasks %u/%u (%u running), on '%s', update %llu, %llu ms ago\n",
+                reader.pid(),
+                reader.is_alive() ? "running" : "stale",
+                snapshot.currentMenu,
+                snapshot.menuDepth,
+                snapshot.highlighted + (snapshot.menuSize > 0 ? 1 : 0),
+                snapshot.menuSize,
+                snapshot.selectionCount,
+                snapshot.tasksDone,
+                snapshot.tasksTotal,
+                snapshot.tasksRunning,
+                snapshot.highlightedName,
+                static_cast<unsigned long long>(snapshot.updates),
+                static_cast<unsigned long long>(ageMs));
+}
+
+
+/** ===============================================================================================
+ *  FUNCTION DEFINITIONS
+ */
+
+int main(int argc, char* argv[])
+{
+    int                watchMs = 0;
+    std::vector<pid_t> pids{};
+    for (int i = 1; i < argc; i++)
+    {
+        if (std::strcmp(argv[i], "--watch") == 0 && i + 1 < argc)
+        {
+            watchMs = std::atoi(argv[++i]);
+        }
+        else
+        {
+            pids.push_back(static_cast<pid_t>(std::atoi(argv[i])));
+        }
+    }
+
+    if (pids.empty())
+    {
+        pids = status_reader::list();
+    }
+
+    std::vector<std::unique_ptr<status_reader>> readers{};
+    for (pid_t pid : pids)
+    {
+        auto reader = std::make_unique<status_reader>();
+        if (reader->open(pid))
+        {
+            readers.push_back(std::move(reader));
+        }
+        else
+        {
+            std::fprintf(stderr, "%d: no status segment\n", pid);
+        }
+    }
+
+    if (readers.empty())
+    {
+        return 1;
+    }
+
+    do
+    {
+        for (const auto& reader : readers)
+        {
+            print_status(*reader);
+        }
+        std::fflush(stdout);
+
+        if (watchMs > 0)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds{watchMs});
+        }
+    } while (watchMs > 0);
+
+    return 0;
+}
+
+
+/**
+ * ------------------------------------------------------------------------------------------------
+ */
@@ -0,0 +1,275 @@
+/**
+ * ===============================================================================================
+ * @file    status-segment.cpp
+ * @author  Pascal-Emmanuel Lachance
+ * @p       <a href="https://www.github.com/Raesangur">Raesangur</a>
+ * @p       <a href="https://www.raesangur.com/">https://www.raesangur.com/</a>
+ *
+ * @brief   Shared-memory status segment for external monitors.
+ *
+ * ------------------------------------------------------------------------------------------------
+ * @copyright Copyright (c) 2023 Pascal-Emmanuel Lachance | Raesangur
+ *
+ * @par License: <a href="https://opensource.org/license/mit/"> MIT </a>
+ *               This project is released under the MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ * BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NON INFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ * ===============================================================================================
+ */
+/** ===============================================================================================
+ *  INCLUDES
+ */
+#include "status-segment.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <csignal>
+#include <cstring>
+#include <ctime>
+#include <dirent.h>
+#include <fcntl.h>
+#include <new>
+#include <sys/mman.h>
+#include <unistd.h>
+
+
+/** ===============================================================================================
+ *  CONSTANTS
+ */
+
+constexpr int READ_ATTEMPTS = 1000;
+
+
+/** ===============================================================================================
+ *  LOCAL FUNCTIONS
+ */
+
+static std::string segment_name(pid_t pid)
+{
+    std::string name = "/";
+    name.append(STATUS_PREFIX).append(std::to_string(pid));
+    return name;
+}
+
+static std::uint64_t now_ns()
+{
+    timespec ts{};
+    ::clock_gettime(CLOCK_REALTIME, &ts);
+    return static_cast<std::uint64_t>(ts.tv_sec) * 1'000'000'000u +
+           static_cast<std::uint64_t>(ts.tv_nsec);
+}
+
+
+/** ===============================================================================================
+ *  STATUS_PUBLISHER MEMBER FUNCTIONS DEFINITIONS
+ */
+
+status_publisher::~status_publisher()
+{
+    close();
+}
+
+bool status_publisher::open()
+{
+    m_name = segment_name(::getpid());
+
+    int fd = ::shm_open(m_name.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0)
+    {
+        return false;
+    }
+    if (::ftruncate(fd, sizeof(status_segment)) != 0)
+    {
+        ::close(fd);
+        ::shm_unlink(m_name.c_str());
+        return false;
+    }
+
+    void* memory =
+        ::mmap(nullptr, sizeof(status_segment), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (memory == MAP_FAILED)
+    {
+        ::shm_unlink(m_name.c_str());
+        return false;
+    }
+
+    m_segment      = new (memory) status_segment{};
+    m_segment->pid = static_cast<std::int32_t>(::getpid());
+    return true;
+}
+
+void status_publisher::close()
+{
+    if (m_segment == nullptr)
+    {
+        return;
+    }
+
+    ::munmap(m_segment, sizeof(status_segment));
+    ::shm_unlink(m_name.c_str());
+    m_segment = nullptr;
+}
+
+
+void status_publisher::publish(const status_snapshot& snapshot)
+{
+    if (m_segment == nullptr)
+    {
+        return;
+    }
+
+    // There is a single writer, so the sequence can be bumped with plain stores.
+    std::uint64_t sequence = m_segment->sequence.load(std::memory_order_relaxed);
+    m_segment->sequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    m_segment->payload             = snapshot;
+    m_segment->payload.updates     = ++m_updates;
+    m_segment->payload.timestampNs = now_ns();
+
+    m_segment->sequence.store(sequence + 2, std::memory_order_release);
+}
+
+void status_publisher::set_text(char (&field)[STATUS_TEXT], std::string_view text)
+{
+    std::size_t length = std::min(text.size(), STATUS_TEXT - 1);
+    std::memcpy(field, text.data(), length);
+    std::memset(field + length, 0, STATUS_TEXT - length);
+}
+
+
+/** ===============================================================================================
+ *  STATUS_READER MEMBER FUNCTIONS DEFINITIONS
+ */
+
+status_reader::~status_reader()
+{
+    close();
+}
+
+bool status_reader::open(pid_t pid)
+{
+    close();
+
+    int fd = ::shm_open(segment_name(pid).c_str(), O_RDONLY | O_CLOEXEC, 0);
+    if (fd < 0)
+    {
+        return false;
+    }
+
+    void* memory = ::mmap(nullptr, sizeof(status_segment), PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (memory == MAP_FAILED)
+    {
+        return false;
+    }
+
+    m_segment = static_cast<const status_segment*>(memory);
+    if (m_segment->magic != STATUS_MAGIC || m_segment->version != STATUS_VERSION ||
+        m_segment->size != sizeof(status_segment))
+    {
+        close();
+        return false;
+    }
+    return true;
+}
+
+void status_reader::close()
+{
+    if (m_segment != nullptr)
+    {
+        ::munmap(const_cast<status_segment*>(m_segment), sizeof(status_segment));
+        m_segment = nullptr;
+    }
+}
+
+
+bool status_reader::read(status_snapshot& snapshot) const
+{
+    if (m_segment == nullptr)
+    {
+        return false;
+    }
+
+    for (int attempt = 0; attempt < READ_ATTEMPTS; attempt++)
+    {
+        std::uint64_t before = m_segment->sequence.load(std::memory_order_acquire);
+        if ((before & 1) != 0)
+        {
+            continue;
+        }
+
+        std::memcpy(&snapshot, &m_segment->payload, sizeof(status_snapshot));
+        std::atomic_thread_fence(std::memory_order_acquire);
+
+        if (m_segment->sequence.load(std::memory_order_relaxed) == before)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+
+[[nodiscard]] pid_t status_reader::pid() const
+{
+    return m_segment == nullptr ? 0 : static_cast<pid_t>(m_segment->pid);
+}
+
+[[nodiscard]] bool status_reader::is_alive() const
+{
+    return m_segment != nullptr && (::kill(pid(), 0) == 0 || errno == EPERM);
+}
+
+
+[[nodiscard]] std::vector<pid_t> status_reader::list()
+{
+    std::vector<pid_t> pids{};
+
+    DIR* dir = ::opendir("/dev/shm");
+    if (dir == nullptr)
+    {
+        return pids;
+    }
+
+    while (dirent* entry = ::readdir(dir))
+    {
+        std::string_view name = entry->d_name;
+        if (!name.starts_with(STATUS_PREFIX))
+        {
+            continue;
+        }
+        name.remove_prefix(STATUS_PREFIX.size());
+
+        pid_t pid         = 0;
+        auto [end, error] = std::from_chars(name.data(), name.data() + name.size(), pid);
+        if (error == std::errc{} && end == name.data() + name.size())
+        {
+            pids.push_back(pid);
+        }
+    }
+    ::closedir(dir);
+
+    std::sort(pids.begin(), pids.end());
+    return pids;
+}
+
+
+/**
+ * ------------------------------------------------------------------------------------------------
+ */
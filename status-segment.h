@@ -0,0 +1,179 @@
+/**
+ * ===============================================================================================
+ * @file    status-segment.h
+ * @author  Pascal-Emmanuel Lachance
+ * @p       <a href="https://www.github.com/Raesangur">Raesangur</a>
+ * @p       <a href="https://www.raesangur.com/">https://www.raesangur.com/</a>
+ *
+ * @brief   Shared-memory status segment for external monitors.
+ *
+ * ------------------------------------------------------------------------------------------------
+ * @copyright Copyright (c) 2023 Pascal-Emmanuel Lachance | Raesangur
+ *
+ * @par License: <a href="https://opensource.org/license/mit/"> MIT </a>
+ *               This project is released under the MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ * BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NON INFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ * ------------------------------------------------------------------------------------------------
+ * @details
+ * The application publishes a small fixed-layout record describing what it is doing into a POSIX
+ * shared-memory segment, /dev/shm/ncurses_test.<pid>. Monitoring agents map it read-only and poll
+ * it without any system call once mapped, and without ever blocking the writer.
+ *
+ * The record is protected by a sequence lock: the writer makes the sequence odd, updates the
+ * payload and makes it even again; a reader copies the payload and retries if the sequence was odd
+ * or changed during the copy. Publishing is a handful of plain stores, cheap enough to do on every
+ * frame.
+ *
+ * The layout is shared with other processes, so it only contains fixed-size types and is versioned;
+ * bump STATUS_VERSION whenever it changes.
+ * ===============================================================================================
+ */
+#ifndef STATUS_SEGMENT_H
+#define STATUS_SEGMENT_H
+
+
+/** ===============================================================================================
+ *  INCLUDES
+ */
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <sys/types.h>
+#include <vector>
+
+
+/** ===============================================================================================
+ *  CONSTANTS
+ */
+
+constexpr std::uint32_t    STATUS_MAGIC   = 0x4E435354;    // "NCST"
+constexpr std::uint32_t    STATUS_VERSION = 1;
+constexpr std::string_view STATUS_PREFIX  = "ncurses_test.";
+constexpr std::size_t      STATUS_TEXT    = 128;
+
+
+/** ===============================================================================================
+ *  TYPES
+ */
+
+struct status_snapshot
+{
+    std::uint64_t updates     = 0;     //!< Number of publications so far.
+    std::uint64_t timestampNs = 0;     //!< CLOCK_REALTIME of the last publication.
+
+    std::uint32_t menuDepth      = 0;
+    std::uint32_t highlighted    = 0;
+    std::uint32_t menuSize       = 0;
+    std::uint32_t selectionCount = 0;
+
+    std::uint32_t tasksRunning = 0;
+    std::uint32_t tasksDone    = 0;
+    std::uint32_t tasksTotal   = 0;
+    std::uint32_t reserved     = 0;
+
+    char currentMenu[STATUS_TEXT]{};
+    char highlightedName[STATUS_TEXT]{};
+};
+
+struct status_segment
+{
+    std::uint32_t magic   = STATUS_MAGIC;
+    std::uint32_t version = STATUS_VERSION;
+    std::int32_t  pid     = 0;
+    std::uint32_t size    = sizeof(status_segment);
+
+    // Alone on its cache line, so that polling readers do not contend with unrelated fields.
+    alignas(64) std::atomic<std::uint64_t> sequence{0};
+    alignas(64) status_snapshot payload{};
+};
+
+static_assert(std::atomic<std::uint64_t>::is_always_lock_free,
+              "the sequence is shared between processes and must not rely on a lock");
+
+
+/** ===============================================================================================
+ *  CLASS DEFINITION
+ */
+
+class status_publisher
+{
+public:
+    status_publisher() = default;
+    ~status_publisher();
+
+    status_publisher(const status_publisher&) = delete;
+    void operator=(const status_publisher&)   = delete;
+
+    // Creates /dev/shm/ncurses_test.<pid>; publishing is a no-op if this fails.
+    bool open();
+    void close();
+
+    [[nodiscard]] bool is_open() const
+    {
+        return m_segment != nullptr;
+    }
+
+    void publish(const status_snapshot& snapshot);
+
+    // Copies `text` into a fixed-size field, truncated and always null-terminated.
+    static void set_text(char (&field)[STATUS_TEXT], std::string_view text);
+
+protected:
+    status_segment* m_segment = nullptr;
+    std::string     m_name{};
+    std::uint64_t   m_updates = 0;
+};
+
+
+class status_reader
+{
+public:
+    status_reader() = default;
+    ~status_reader();
+
+    status_reader(const status_reader&)    = delete;
+    void operator=(const status_reader&) = delete;
+
+    bool open(pid_t pid);
+    void close();
+
+    [[nodiscard]] bool is_open() const
+    {
+        return m_segment != nullptr;
+    }
+
+    // Takes a consistent copy of the record; false if the writer kept it busy for too long.
+    bool read(status_snapshot& snapshot) const;
+
+    [[nodiscard]] pid_t pid() const;
+    // True while the publishing process is still running.
+    [[nodiscard]] bool is_alive() const;
+
+    // Process ids of every segment present in /dev/shm, live or stale.
+    [[nodiscard]] static std::vector<pid_t> list();
+
+protected:
+    const status_segment* m_segment = nullptr;
+};
+
+
+#endif  // STATUS_SEGMENT_H
+/**
+ * ------------------------------------------------------------------------------------------------
+ */
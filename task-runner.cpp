@@ -0,0 +1,442 @@
+/**
+ * ===============================================================================================
+ * @file    task-runner.cpp
+ * @author  Pascal-Emmanuel Lachance
+ * @p       <a href="https://www.github.com/Raesangur">Raesangur</a>
+ * @p       <a href="https://www.raesangur.com/">https://www.raesangur.com/</a>
+ *
+ * @brief   Runs shell commands and captures their output into bounded buffers.
+ *
+ * ------------------------------------------------------------------------------------------------
+ * @copyright Copyright (c) 2023 Pascal-Emmanuel Lachance | Raesangur
+ *
+ * @par License: <a href="https://opensource.org/license/mit/"> MIT </a>
+ *               This project is released under the MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ * BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NON INFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ * ===============================================================================================
+ */
+/** ===============================================================================================
+ *  INCLUDES
+ */
+#include "task-runner.h"
+
+#include "trace.h"
+
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+#include <fcntl.h>
+#include <spawn.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/syscall.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+extern char** environ;
+
+
+/** ===============================================================================================
+ *  CONSTANTS
+ */
+
+constexpr std::uint64_t WAKE_EVENT     = UINT64_MAX;
+constexpr std::uint64_t PIDFD_FLAG     = 1;
+constexpr int           PIPE_SIZE      = 1024 * 1024;
+constexpr int           READS_PER_WAKE = 16;    //!< Bounds how long one task can hold the thread.
+
+
+/** ===============================================================================================
+ *  FUNCTION DEFINITIONS
+ */
+
+[[nodiscard]] int open_pidfd(pid_t pid)
+{
+#ifdef SYS_pidfd_open
+    return static_cast<int>(::syscall(SYS_pidfd_open, pid, 0));
+#else
+    (void)pid;
+    return -1;
+#endif
+}
+
+[[nodiscard]] int exit_code_of(int status)
+{
+    if (WIFEXITED(status))
+    {
+        return WEXITSTATUS(status);
+    }
+    if (WIFSIGNALED(status))
+    {
+        return 128 + WTERMSIG(status);
+    }
+    return -1;
+}
+
+[[nodiscard]] std::string shell_quote(std::string_view text)
+{
+    std::string quoted = "'";
+    for (char ch : text)
+    {
+        if (ch == '\'')
+        {
+            quoted += "'\\''";
+        }
+        else
+        {
+            quoted += ch;
+        }
+    }
+    return quoted + "'";
+}
+
+
+/** ===============================================================================================
+ *  SINGLETON INSTANCE
+ */
+task_runner* task_runner::m_instance = nullptr;
+
+
+/** ===============================================================================================
+ *  TASK MEMBER FUNCTIONS DEFINITIONS
+ */
+
+task::task(std::size_t id, std::string_view name, std::string_view command) :
+    m_id{id}, m_name{name}, m_command{command}
+{
+}
+
+void task::on_finish(std::function<void()> callback)
+{
+    {
+        // finish() publishes the state before taking the lock, so a callback is never missed.
+        std::lock_guard lock{m_finishMutex};
+        if (state() == task_state::running)
+        {
+            m_onFinish.push_back(std::move(callback));
+            return;
+        }
+    }
+    callback();
+}
+
+
+/** ===============================================================================================
+ *  TASK_RUNNER MEMBER FUNCTIONS DEFINITIONS
+ */
+
+task_runner::task_runner()
+{
+    m_epollFd = ::epoll_create1(EPOLL_CLOEXEC);
+    m_wakeFd  = ::eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+
+    epoll_event event{};
+    event.events   = EPOLLIN;
+    event.data.u64 = WAKE_EVENT;
+    ::epoll_ctl(m_epollFd, EPOLL_CTL_ADD, m_wakeFd, &event);
+}
+
+task_runner::~task_runner()
+{
+    stop();
+    ::close(m_wakeFd);
+    ::close(m_epollFd);
+}
+
+[[nodiscard]] task_runner* task_runner::get()
+{
+    if (m_instance == nullptr)
+    {
+        m_instance = new task_runner;
+    }
+    return m_instance;
+}
+
+
+task* task_runner::start(std::string_view name, std::string_view command)
+{
+    task* t = nullptr;
+    {
+        std::lock_guard lock{m_tasksMutex};
+        m_tasks.push_back(std::make_unique<task>(m_tasks.size(), name, command));
+        t = m_tasks.back().get();
+    }
+    trace::begin_async("task", t->id(), name);
+
+    int fds[2] = {-1, -1};
+    if (::pipe2(fds, O_CLOEXEC) != 0)
+    {
+        std::lock_guard lock{t->m_mutex};
+        t->m_output.append(std::string{"cannot create pipe: "} + std::strerror(errno) + "\n");
+        finish(*t, task_state::failed, -1);
+        return t;
+    }
+    // A larger pipe means fewer, larger reads from chatty commands.
+    ::fcntl(fds[0], F_SETPIPE_SZ, PIPE_SIZE);
+
+    posix_spawn_file_actions_t actions{};
+    posix_spawn_file_actions_init(&actions);
+    posix_spawn_file_actions_addopen(&actions, STDIN_FILENO, "/dev/null", O_RDONLY, 0);
+    posix_spawn_file_actions_adddup2(&actions, fds[1], STDOUT_FILENO);
+    posix_spawn_file_actions_adddup2(&actions, fds[1], STDERR_FILENO);
+
+    // Its own process group, so that everything the command starts can be terminated with it.
+    posix_spawnattr_t attributes{};
+    posix_spawnattr_init(&attributes);
+    posix_spawnattr_setflags(&attributes, POSIX_SPAWN_SETPGROUP);
+    posix_spawnattr_setpgroup(&attributes, 0);
+
+    std::string shell       = "sh";
+    std::string option      = "-c";
+    std::string commandLine = std::string{command};
+    char*       argv[]      = {shell.data(), option.data(), commandLine.data(), nullptr};
+
+    pid_t pid   = -1;
+    int   error = ::posix_spawn(&pid, "/bin/sh", &actions, &attributes, argv, environ);
+    posix_spawn_file_actions_destroy(&actions);
+    posix_spawnattr_destroy(&attributes);
+    ::close(fds[1]);
+
+    if (error != 0)
+    {
+        ::close(fds[0]);
+        std::lock_guard lock{t->m_mutex};
+        t->m_output.append(std::string{"cannot start /bin/sh: "} + std::strerror(error) + "\n");
+        finish(*t, task_state::failed, -1);
+        return t;
+    }
+
+    ::fcntl(fds[0], F_SETFL, ::fcntl(fds[0], F_GETFL) | O_NONBLOCK);
+    t->m_pid    = pid;
+    t->m_pipeFd = fds[0];
+    t->m_pidFd  = open_pidfd(pid);
+
+    epoll_event event{};
+    event.events   = EPOLLIN;
+    event.data.u64 = static_cast<std::uint64_t>(t->m_id) << 1;
+    ::epoll_ctl(m_epollFd, EPOLL_CTL_ADD, t->m_pipeFd, &event);
+    if (t->m_pidFd >= 0)
+    {
+        event.data.u64 |= PIDFD_FLAG;
+        ::epoll_ctl(m_epollFd, EPOLL_CTL_ADD, t->m_pidFd, &event);
+    }
+
+    {
+        // Actions start tasks from the event loop thread as well as the input thread.
+        std::lock_guard lock{m_tasksMutex};
+        if (!m_thread.joinable())
+        {
+            m_thread = std::thread{&task_runner::capture_loop, this};
+        }
+    }
+    m_generation.fetch_add(1, std::memory_order_release);
+    return t;
+}
+
+
+[[nodiscard]] std::size_t task_runner::size() const
+{
+    std::lock_guard lock{m_tasksMutex};
+    return m_tasks.size();
+}
+
+[[nodiscard]] task* task_runner::get(std::size_t id) const
+{
+    std::lock_guard lock{m_tasksMutex};
+    return id < m_tasks.size() ? m_tasks[id].get() : nullptr;
+}
+
+[[nodiscard]] task* task_runner::last() const
+{
+    std::lock_guard lock{m_tasksMutex};
+    return m_tasks.empty() ? nullptr : m_tasks.back().get();
+}
+
+[[nodiscard]] task_progress task_runner::progress() const
+{
+    std::lock_guard lock{m_tasksMutex};
+
+    task_progress progress{};
+    progress.total = static_cast<std::uint32_t>(m_tasks.size());
+    for (const auto& t : m_tasks)
+    {
+        if (t->state() == task_state::running)
+        {
+            progress.running++;
+        }
+        else
+        {
+            progress.done++;
+        }
+    }
+    return progress;
+}
+
+
+void task_runner::stop()
+{
+    if (!m_thread.joinable())
+    {
+        return;
+    }
+
+    std::uint64_t one = 1;
+    [[maybe_unused]] ssize_t written = ::write(m_wakeFd, &one, sizeof(one));
+    m_thread.join();
+
+    // Nothing would be left to show their output.
+    std::lock_guard lock{m_tasksMutex};
+    for (const auto& t : m_tasks)
+    {
+        if (t->state() == task_state::running)
+        {
+            ::kill(-t->m_pid, SIGTERM);
+        }
+    }
+}
+
+
+void task_runner::capture_loop()
+{
+    trace::set_thread_name("task capture");
+    epoll_event events[16];
+    while (true)
+    {
+        int count = ::epoll_wait(m_epollFd, events, 16, -1);
+        if (count < 0 && errno != EINTR)
+        {
+            return;
+        }
+
+        for (int i = 0; i < count; i++)
+        {
+            std::uint64_t data = events[i].data.u64;
+            if (data == WAKE_EVENT)
+            {
+                return;
+            }
+
+            task* t = get(static_cast<std::size_t>(data >> 1));
+            if (t == nullptr)
+            {
+                continue;
+            }
+            if ((data & PIDFD_FLAG) != 0)
+            {
+                reap(*t);
+            }
+            else
+            {
+                drain(*t);
+            }
+        }
+    }
+}
+
+void task_runner::drain(task& t)
+{
+    for (int reads = 0; reads < READS_PER_WAKE && t.m_pipeFd >= 0; reads++)
+    {
+        std::span<char> area{};
+        {
+            std::lock_guard lock{t.m_mutex};
+            area = t.m_output.reserve(PIPE_READ_SIZE);
+        }
+
+        // Outside the lock: the reserved area is out of every reader's reach.
+        ssize_t count = ::read(t.m_pipeFd, area.data(), area.size());
+        {
+            std::lock_guard lock{t.m_mutex};
+            t.m_output.commit(count > 0 ? static_cast<std::size_t>(count) : 0);
+        }
+
+        if (count > 0)
+        {
+            t.m_generation.fetch_add(1, std::memory_order_release);
+            m_generation.fetch_add(1, std::memory_order_release);
+
+            m_capturedBytes += static_cast<std::uint64_t>(count);
+            trace::counter("task output bytes", m_capturedBytes);
+            continue;
+        }
+        if (count < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (count < 0 && errno == EAGAIN)
+        {
+            return;
+        }
+
+        // End of output: every writer, including anything the command left behind, is gone.
+        ::epoll_ctl(m_epollFd, EPOLL_CTL_DEL, t.m_pipeFd, nullptr);
+        ::close(t.m_pipeFd);
+        t.m_pipeFd = -1;
+
+        if (t.m_pidFd < 0)
+        {
+            // Without a pidfd the process is reaped here, once it has closed its output.
+            int status = 0;
+            ::waitpid(t.m_pid, &status, 0);
+            finish(t, task_state::exited, exit_code_of(status));
+        }
+    }
+}
+
+void task_runner::reap(task& t)
+{
+    int status = 0;
+    if (::waitpid(t.m_pid, &status, WNOHANG) != t.m_pid)
+    {
+        return;
+    }
+
+    // Whatever the command wrote before exiting is still in the pipe.
+    if (t.m_pipeFd >= 0)
+    {
+        drain(t);
+    }
+
+    ::epoll_ctl(m_epollFd, EPOLL_CTL_DEL, t.m_pidFd, nullptr);
+    ::close(t.m_pidFd);
+    t.m_pidFd = -1;
+    finish(t, task_state::exited, exit_code_of(status));
+}
+
+void task_runner::finish(task& t, task_state state, int exitCode)
+{
+    trace::end_async("task", t.id(), t.name());
+    t.m_exitCode = exitCode;
+    t.m_state.store(state, std::memory_order_release);
+    t.m_generation.fetch_add(1, std::memory_order_release);
+    m_generation.fetch_add(1, std::memory_order_release);
+
+    std::vector<std::function<void()>> callbacks{};
+    {
+        std::lock_guard lock{t.m_finishMutex};
+        callbacks.swap(t.m_onFinish);
+    }
+    for (const auto& callback : callbacks)
+    {
+        callback();
+    }
+}
+
+
+/**
+ * ------------------------------------------------------------------------------------------------
+ */
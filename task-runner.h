@@ -0,0 +1,235 @@
+/**
+ * ===============================================================================================
+ * @file    task-runner.h
+ * @author  Pascal-Emmanuel Lachance
+ * @p       <a href="https://www.github.com/Raesangur">Raesangur</a>
+ * @p       <a href="https://www.raesangur.com/">https://www.raesangur.com/</a>
+ *
+ * @brief   Runs shell commands and captures their output into bounded buffers.
+ *
+ * ------------------------------------------------------------------------------------------------
+ * @copyright Copyright (c) 2023 Pascal-Emmanuel Lachance | Raesangur
+ *
+ * @par License: <a href="https://opensource.org/license/mit/"> MIT </a>
+ *               This project is released under the MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ * BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NON INFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ * ------------------------------------------------------------------------------------------------
+ * @details
+ * Each task runs `/bin/sh -c <command>` with stdin on /dev/null and stdout and stderr on one pipe.
+ * A single capture thread waits on every task's pipe and process descriptor with epoll. It reads
+ * straight into the task's output_ring, up to PIPE_READ_SIZE bytes per call, and reaps the process
+ * when it exits. The input thread never touches a pipe, so a chatty child can never delay a
+ * keystroke, and the ring bounds the memory it can use.
+ *
+ * Every capture bumps a generation counter instead of notifying the interface. The interface
+ * samples it once per frame, which limits redraws to the frame rate however fast output arrives.
+ * ===============================================================================================
+ */
+#ifndef TASK_RUNNER_H
+#define TASK_RUNNER_H
+
+
+/** ===============================================================================================
+ *  INCLUDES
+ */
+#include "output-ring.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <sys/types.h>
+#include <thread>
+#include <vector>
+
+
+/** ===============================================================================================
+ *  CONSTANTS
+ */
+
+constexpr std::size_t TASK_OUTPUT_BYTES = 1024 * 1024;
+constexpr std::size_t TASK_OUTPUT_LINES = 16 * 1024;
+constexpr std::size_t PIPE_READ_SIZE    = 64 * 1024;
+
+
+/** ===============================================================================================
+ *  TYPES
+ */
+
+enum class task_state
+{
+    running,
+    exited,
+    failed    //!< The command could not be started.
+};
+
+struct task_progress
+{
+    std::uint32_t running = 0;
+    std::uint32_t done    = 0;
+    std::uint32_t total   = 0;
+};
+
+
+/** ===============================================================================================
+ *  FUNCTION DECLARATIONS
+ */
+
+// Process descriptor for a child, or -1 when the kernel does not support them.
+[[nodiscard]] int open_pidfd(pid_t pid);
+// Exit code from a wait status, or 128 + signal number when the process was killed.
+[[nodiscard]] int exit_code_of(int status);
+// Quotes `text` as a single shell word.
+[[nodiscard]] std::string shell_quote(std::string_view text);
+
+
+/** ===============================================================================================
+ *  CLASS DEFINITION
+ */
+
+class task
+{
+public:
+    task(std::size_t id, std::string_view name, std::string_view command);
+
+    [[nodiscard]] std::size_t id() const
+    {
+        return m_id;
+    }
+    [[nodiscard]] const std::string& name() const
+    {
+        return m_name;
+    }
+    [[nodiscard]] const std::string& command() const
+    {
+        return m_command;
+    }
+
+    [[nodiscard]] task_state state() const
+    {
+        return m_state.load(std::memory_order_acquire);
+    }
+    // Exit code, or 128 + signal number when the command was killed.
+    [[nodiscard]] int exit_code() const
+    {
+        return m_exitCode;
+    }
+
+    // Changes every time output is captured or the state changes.
+    [[nodiscard]] std::uint64_t generation() const
+    {
+        return m_generation.load(std::memory_order_acquire);
+    }
+
+    // Calls `callback` once the task has finished, from the capture thread, or right away if it
+    // already has. Callbacks must not block.
+    void on_finish(std::function<void()> callback);
+
+    // Runs `callback(const output_ring&)` with the output locked against the capture thread.
+    template<typename F>
+    void with_output(F&& callback) const
+    {
+        std::lock_guard lock{m_mutex};
+        callback(m_output);
+    }
+
+protected:
+    friend class task_runner;
+
+    std::size_t m_id;
+    std::string m_name;
+    std::string m_command;
+
+    pid_t m_pid    = -1;
+    int   m_pipeFd = -1;
+    int   m_pidFd  = -1;
+
+    std::atomic<task_state>    m_state{task_state::running};
+    int                        m_exitCode = 0;
+    std::atomic<std::uint64_t> m_generation{0};
+
+    mutable std::mutex m_mutex{};
+    output_ring        m_output{TASK_OUTPUT_BYTES, TASK_OUTPUT_LINES, PIPE_READ_SIZE};
+
+    std::mutex                         m_finishMutex{};
+    std::vector<std::function<void()>> m_onFinish{};
+};
+
+
+class task_runner
+{
+protected:
+    task_runner();
+
+public:
+    task_runner(const task_runner&)    = delete;
+    void operator=(const task_runner&) = delete;
+    ~task_runner();
+
+    [[nodiscard]] static task_runner* get();
+
+    // Starts `command` and returns its task; it is kept, with its output, until exit.
+    task* start(std::string_view name, std::string_view command);
+
+    [[nodiscard]] std::size_t size() const;
+    [[nodiscard]] task*       get(std::size_t id) const;
+    [[nodiscard]] task*       last() const;
+
+    [[nodiscard]] task_progress progress() const;
+    [[nodiscard]] bool          has_running() const
+    {
+        return progress().running > 0;
+    }
+
+    // Changes whenever any task does; compare against a previous value to know what to redraw.
+    [[nodiscard]] std::uint64_t generation() const
+    {
+        return m_generation.load(std::memory_order_acquire);
+    }
+
+    void stop();
+
+protected:
+    void capture_loop();
+    void drain(task& t);
+    void reap(task& t);
+    void finish(task& t, task_state state, int exitCode);
+
+protected:
+    static task_runner* m_instance;
+
+    int m_epollFd = -1;
+    int m_wakeFd  = -1;
+
+    mutable std::mutex                 m_tasksMutex{};
+    std::vector<std::unique_ptr<task>> m_tasks{};
+
+    std::atomic<std::uint64_t> m_generation{0};
+    std::thread                m_thread{};
+
+    std::uint64_t m_capturedBytes = 0;    //!< Capture thread only, for the trace counter.
+};
+
+
+#endif  // TASK_RUNNER_H
+/**
+ * ------------------------------------------------------------------------------------------------
+ */
@@ -0,0 +1,378 @@
+/**
+ * ===============================================================================================
+ * @file    theme.cpp
+ * @author  Pascal-Emmanuel Lachance
+ * @p       <a href="https://www.github.com/Raesangur">Raesangur</a>
+ * @p       <a href="https://www.raesangur.com/">https://www.raesangur.com/</a>
+ *
+ * @brief   Named styles resolved once into ncurses attributes and color pairs.
+ *
+ * ------------------------------------------------------------------------------------------------
+ * @copyright Copyright (c) 2023 Pascal-Emmanuel Lachance | Raesangur
+ *
+ * @par License: <a href="https://opensource.org/license/mit/"> MIT </a>
+ *               This project is released under the MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ * BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NON INFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ * ===============================================================================================
+ */
+
+/** ===============================================================================================
+ *  INCLUDES
+ */
+#include "theme.h"
+
+#include "file-text.h"
+#include "memory-accounting.h"
+#include "string-vector/stringvec.h"
+
+#include <algorithm>
+#include <charconv>
+#include <unistd.h>
+
+
+/** ===============================================================================================
+ *  SINGLETON INSTANCE
+ */
+theme* theme::m_instance = nullptr;
+
+
+/** ===============================================================================================
+ *  CONSTANTS
+ */
+
+constexpr std::array<std::string_view, static_cast<std::size_t>(style_id::count)> STYLE_NAMES = {
+  "background",
+  "menu",
+  "highlight",
+  "title",
+};
+
+// RGB values of the 16 basic colors, in ncurses color number order.
+constexpr std::array<std::uint32_t, 16> BASIC_COLORS = {
+  0x000000, 0x800000, 0x008000, 0x808000, 0x000080, 0x800080, 0x008080, 0xC0C0C0,
+  0x808080, 0xFF0000, 0x00FF00, 0xFFFF00, 0x0000FF, 0xFF00FF, 0x00FFFF, 0xFFFFFF,
+};
+
+constexpr std::array<int, 6> CUBE_LEVELS = {0, 95, 135, 175, 215, 255};
+
+constexpr int DIRECT_COLORS = 0x1000000;
+
+
+/** ===============================================================================================
+ *  LOCAL FUNCTIONS
+ */
+
+static int red(std::uint32_t rgb)
+{
+    return static_cast<int>((rgb >> 16) & 0xFF);
+}
+
+static int green(std::uint32_t rgb)
+{
+    return static_cast<int>((rgb >> 8) & 0xFF);
+}
+
+static int blue(std::uint32_t rgb)
+{
+    return static_cast<int>(rgb & 0xFF);
+}
+
+static int distance(std::uint32_t a, int r, int g, int b)
+{
+    int dr = red(a) - r;
+    int dg = green(a) - g;
+    int db = blue(a) - b;
+    return dr * dr + dg * dg + db * db;
+}
+
+static int cube_level(int component)
+{
+    if (component < 48)
+    {
+        return 0;
+    }
+    if (component < 115)
+    {
+        return 1;
+    }
+    return (component - 35) / 40;
+}
+
+static int quantize_xterm256(std::uint32_t rgb)
+{
+    int r = red(rgb);
+    int g = green(rgb);
+    int b = blue(rgb);
+
+    int lr = cube_level(r);
+    int lg = cube_level(g);
+    int lb = cube_level(b);
+
+    auto cubeRgb = static_cast<std::uint32_t>((CUBE_LEVELS[lr] << 16) | (CUBE_LEVELS[lg] << 8)
+                                              | CUBE_LEVELS[lb]);
+
+    int grey      = (r + g + b) / 3;
+    int greyIndex = grey > 238 ? 23 : std::max(grey - 3, 0) / 10;
+    int greyValue = 8 + 10 * greyIndex;
+    auto greyRgb  = static_cast<std::uint32_t>((greyValue << 16) | (greyValue << 8) | greyValue);
+
+    if (distance(greyRgb, r, g, b) < distance(cubeRgb, r, g, b))
+    {
+        return 232 + greyIndex;
+    }
+    return 16 + 36 * lr + 6 * lg + lb;
+}
+
+static attr_t parse_attribute(std::string_view name)
+{
+    if (name == "bold")
+    {
+        return A_BOLD;
+    }
+    if (name == "dim")
+    {
+        return A_DIM;
+    }
+    if (name == "standout")
+    {
+        return A_STANDOUT;
+    }
+    if (name == "reverse")
+    {
+        return A_REVERSE;
+    }
+    if (name == "underline")
+    {
+        return A_UNDERLINE;
+    }
+    if (name == "blink")
+    {
+        return A_BLINK;
+    }
+    if (name == "italic")
+    {
+        return A_ITALIC;
+    }
+    return A_NORMAL;
+}
+
+static bool parse_color(std::string_view text, std::uint32_t& rgb)
+{
+    if (text.size() != 7 || text.front() != '#')
+    {
+        return false;
+    }
+
+    auto [end, error] = std::from_chars(text.data() + 1, text.data() + text.size(), rgb, 16);
+    return error == std::errc{} && end == text.data() + text.size();
+}
+
+
+/** ===============================================================================================
+ *  MEMBER FUNCTIONS DEFINITIONS
+ */
+
+theme::theme()
+{
+    define(style_id::background, {BASIC_COLORS[COLOR_WHITE], BASIC_COLORS[COLOR_BLUE], A_NORMAL});
+    define(style_id::menu, {BASIC_COLORS[COLOR_BLACK], BASIC_COLORS[COLOR_WHITE], A_NORMAL});
+    define(style_id::highlight, {BASIC_COLORS[COLOR_BLACK], BASIC_COLORS[COLOR_WHITE], A_STANDOUT});
+    define(style_id::title, {BASIC_COLORS[COLOR_WHITE], BASIC_COLORS[COLOR_BLUE], A_BOLD});
+}
+
+
+[[nodiscard]] std::optional<style_id> theme::find(std::string_view name)
+{
+    auto it = std::find(STYLE_NAMES.begin(), STYLE_NAMES.end(), name);
+    if (it == STYLE_NAMES.end())
+    {
+        return std::nullopt;
+    }
+    return static_cast<style_id>(it - STYLE_NAMES.begin());
+}
+
+void theme::define(style_id id, const style_spec& spec)
+{
+    m_specs[static_cast<std::size_t>(id)] = spec;
+}
+
+bool theme::load_file(const std::string& filename)
+{
+    // A missing file would otherwise read as an empty theme.
+    if (::access(filename.c_str(), R_OK) != 0)
+    {
+        return false;
+    }
+
+    stringvec lines{};
+    lines.read_file(filename);
+
+    lines.filter_empty();
+    scoped_allocation linesMemory{memory_category::string_vectors, heap_bytes_of_strings(lines),
+                                  lines.size()};
+
+    // Nothing is applied unless the whole file is valid.
+    std::array<style_spec, STYLE_COUNT> specs = m_specs;
+    for (const std::string_view raw : lines)
+    {
+        // Blank lines and comments may be indented.
+        std::string_view line = trim(raw);
+        if (line.empty() || line.front() == '#')
+        {
+            continue;
+        }
+
+        std::array<std::string_view, 8> tokens{};
+        std::size_t                     count = 0;
+        for (std::size_t pos = 0; pos < line.size() && count < tokens.size();)
+        {
+            std::size_t begin = line.find_first_not_of(" \t", pos);
+            if (begin == std::string_view::npos)
+            {
+                break;
+            }
+            std::size_t end = std::min(line.find_first_of(" \t", begin), line.size());
+            tokens[count++] = line.substr(begin, end - begin);
+            pos             = end;
+        }
+
+        std::optional<style_id> id = find(tokens[0]);
+        style_spec              spec{};
+        if (count < 3 || !id || !parse_color(tokens[1], spec.foreground)
+            || !parse_color(tokens[2], spec.background))
+        {
+            return false;
+        }
+
+        for (std::size_t i = 3; i < count; i++)
+        {
+            attr_t attribute = parse_attribute(tokens[i]);
+            if (attribute == A_NORMAL)
+            {
+                return false;
+            }
+            spec.attrs |= attribute;
+        }
+
+        specs[static_cast<std::size_t>(*id)] = spec;
+    }
+
+    m_specs = specs;
+    return true;
+}
+
+void theme::resolve()
+{
+    bool colors = has_colors() && COLORS > 0;
+
+    for (std::size_t i = 0; i < STYLE_COUNT; i++)
+    {
+        const style_spec& spec = m_specs[i];
+
+        short  pair  = colors ? pair_for(quantize(spec.foreground), quantize(spec.background)) : 0;
+        attr_t attrs = spec.attrs;
+        // Colors alone tell the highlighted row apart; without them, an attribute has to.
+        if (!colors && static_cast<style_id>(i) == style_id::highlight &&
+            (attrs & (A_STANDOUT | A_REVERSE)) == 0)
+        {
+            attrs |= A_STANDOUT;
+        }
+        m_styles[i] = style{attrs, pair};
+    }
+}
+
+
+[[nodiscard]] int theme::quantize(std::uint32_t rgb)
+{
+    auto cached = m_colorCache.find(rgb);
+    if (cached != m_colorCache.end())
+    {
+        return cached->second;
+    }
+
+    int color = 0;
+    if (COLORS >= DIRECT_COLORS)
+    {
+        color = static_cast<int>(rgb);
+    }
+    else
+    {
+        // The basic colors are matched exactly first, so the default theme looks the same on
+        // every terminal, whatever its palette.
+        int  basic = std::min(COLORS, static_cast<int>(BASIC_COLORS.size()));
+        auto exact = std::find(BASIC_COLORS.begin(), BASIC_COLORS.begin() + basic, rgb);
+        if (exact != BASIC_COLORS.begin() + basic)
+        {
+            color = static_cast<int>(exact - BASIC_COLORS.begin());
+        }
+        else if (COLORS >= 256)
+        {
+            color = quantize_xterm256(rgb);
+        }
+        else
+        {
+            int best = distance(BASIC_COLORS[0], red(rgb), green(rgb), blue(rgb));
+            for (int i = 1; i < basic; i++)
+            {
+                int d = distance(BASIC_COLORS[i], red(rgb), green(rgb), blue(rgb));
+                if (d < best)
+                {
+                    best  = d;
+                    color = i;
+                }
+            }
+        }
+    }
+
+    m_colorCache.emplace(rgb, color);
+    return color;
+}
+
+[[nodiscard]] short theme::pair_for(int foreground, int background)
+{
+    std::uint64_t key = (static_cast<std::uint64_t>(static_cast<std::uint32_t>(foreground)) << 32)
+                        | static_cast<std::uint32_t>(background);
+
+    auto cached = m_pairCache.find(key);
+    if (cached != m_pairCache.end())
+    {
+        return cached->second;
+    }
+
+    if (m_nextPair >= COLOR_PAIRS)
+    {
+        return 0;
+    }
+
+    short pair = m_nextPair++;
+    if (COLORS > 256)
+    {
+        init_extended_pair(pair, foreground, background);
+    }
+    else
+    {
+        init_pair(pair, static_cast<short>(foreground), static_cast<short>(background));
+    }
+
+    m_pairCache.emplace(key, pair);
+    return pair;
+}
+
+
+/**
+ * ------------------------------------------------------------------------------------------------
+ */
@@ -0,0 +1,143 @@
+/**
+ * ===============================================================================================
+ * @file    theme.h
+ * @author  Pascal-Emmanuel Lachance
+ * @p       <a href="https://www.github.com/Raesangur">Raesangur</a>
+ * @p       <a href="https://www.raesangur.com/">https://www.raesangur.com/</a>
+ *
+ * @brief   Named styles resolved once into ncurses attributes and color pairs.
+ *
+ * ------------------------------------------------------------------------------------------------
+ * @copyright Copyright (c) 2023 Pascal-Emmanuel Lachance | Raesangur
+ *
+ * @par License: <a href="https://opensource.org/license/mit/"> MIT </a>
+ *               This project is released under the MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ * BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NON INFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ * ------------------------------------------------------------------------------------------------
+ * @details
+ * Styles are described with 24-bit colors and resolved against what the terminal offers: direct
+ * colors when terminfo advertises them, the xterm 256-color cube, or the 8/16 basic colors.
+ * Quantized colors and allocated pairs are cached, so each distinct color costs one lookup and each
+ * distinct combination one init_pair, however many styles share them.
+ *
+ * A theme file holds one style per line, e.g. `highlight #000000 #ffffff standout bold`.
+ * ===============================================================================================
+ */
+#ifndef THEME_H
+#define THEME_H
+
+
+/** ===============================================================================================
+ *  INCLUDES
+ */
+#include <ncurses.h>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+
+/** ===============================================================================================
+ *  TYPES
+ */
+
+enum class style_id : std::size_t
+{
+    background,
+    menu,
+    highlight,
+    title,
+
+    count
+};
+
+struct style
+{
+    attr_t attrs = A_NORMAL;
+    short  pair  = 0;
+
+    bool operator==(const style&) const = default;
+};
+
+struct style_spec
+{
+    std::uint32_t foreground = 0xFFFFFF;
+    std::uint32_t background = 0x000000;
+    attr_t        attrs      = A_NORMAL;
+};
+
+
+/** ===============================================================================================
+ *  CLASS DEFINITION
+ */
+
+class theme
+{
+protected:
+    theme();
+
+public:
+    theme(const theme&)          = delete;
+    void operator=(const theme&) = delete;
+
+    [[nodiscard]] static theme* get()
+    {
+        if (m_instance == nullptr)
+        {
+            m_instance = new theme;
+        }
+        return m_instance;
+    }
+
+    [[nodiscard]] static std::optional<style_id> find(std::string_view name);
+
+    void define(style_id id, const style_spec& spec);
+    bool load_file(const std::string& filename);
+    void resolve();
+
+    [[nodiscard]] const style& get(style_id id) const
+    {
+        return m_styles[static_cast<std::size_t>(id)];
+    }
+
+    [[nodiscard]] int quantize(std::uint32_t rgb);
+
+protected:
+    [[nodiscard]] short pair_for(int foreground, int background);
+
+protected:
+    static theme* m_instance;
+
+    static constexpr std::size_t STYLE_COUNT = static_cast<std::size_t>(style_id::count);
+
+    std::array<style_spec, STYLE_COUNT> m_specs{};
+    std::array<style, STYLE_COUNT>      m_styles{};
+
+    std::unordered_map<std::uint32_t, int>   m_colorCache{};
+    std::unordered_map<std::uint64_t, short> m_pairCache{};
+    short                                    m_nextPair = 1;
+};
+
+
+#endif  // THEME_H
+/**
+ * ------------------------------------------------------------------------------------------------
+ */
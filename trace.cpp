@@ -0,0 +1,304 @@
+/**
+ * ===============================================================================================
+ * @file    trace.cpp
+ * @author  Pascal-Emmanuel Lachance
+ * @p       <a href="https://www.github.com/Raesangur">Raesangur</a>
+ * @p       <a href="https://www.raesangur.com/">https://www.raesangur.com/</a>
+ *
+ * @brief   Timeline of frames, loads and tasks, exported as Chrome trace-event JSON.
+ *
+ * ------------------------------------------------------------------------------------------------
+ * @copyright Copyright (c) 2023 Pascal-Emmanuel Lachance | Raesangur
+ *
+ * @par License: <a href="https://opensource.org/license/mit/"> MIT </a>
+ *               This project is released under the MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ * BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NON INFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ * ===============================================================================================
+ */
+/** ===============================================================================================
+ *  INCLUDES
+ */
+#include "trace.h"
+
+#include "json-string.h"
+#include "memory-accounting.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <memory>
+#include <mutex>
+#include <unistd.h>
+#include <vector>
+
+
+/** ===============================================================================================
+ *  STATIC MEMBERS
+ */
+
+std::atomic<bool>        trace::s_enabled{false};
+trace::clock::time_point trace::s_origin{};
+std::string              trace::s_path{};
+
+
+/** ===============================================================================================
+ *  LOCAL FUNCTIONS
+ */
+
+// One thread's events; only that thread appends, the exporter reads up to `size`.
+struct trace_buffer
+{
+    std::unique_ptr<trace_event[]> events{};
+    std::atomic<std::size_t>       size{0};
+    std::atomic<std::uint64_t>     dropped{0};
+    int                            tid = 0;
+    std::atomic<const char*>       name{nullptr};
+};
+
+// Buffers live until the process exits, so that a thread which ended still shows in the export.
+static std::mutex                                 s_buffersMutex{};
+static std::vector<std::unique_ptr<trace_buffer>> s_buffers{};
+
+static thread_local trace_buffer* t_buffer     = nullptr;
+static thread_local const char*   t_threadName = nullptr;
+
+
+static trace_buffer* thread_buffer()
+{
+    if (t_buffer == nullptr)
+    {
+        auto buffer    = std::make_unique<trace_buffer>();
+        buffer->events = std::make_unique<trace_event[]>(TRACE_EVENTS_PER_THREAD);
+        buffer->tid    = ::gettid();
+        buffer->name.store(t_threadName, std::memory_order_relaxed);
+        memory_accounting::allocate(memory_category::trace_buffers,
+                                    TRACE_EVENTS_PER_THREAD * sizeof(trace_event));
+
+        std::lock_guard lock{s_buffersMutex};
+        t_buffer = buffer.get();
+        s_buffers.push_back(std::move(buffer));
+    }
+    return t_buffer;
+}
+
+
+// Trace-event times are in microseconds.
+static void append_us(std::string& out, std::uint64_t ns)
+{
+    char text[32];
+    std::snprintf(text, sizeof(text), "%llu.%03llu",
+                  static_cast<unsigned long long>(ns / 1000),
+                  static_cast<unsigned long long>(ns % 1000));
+    out += text;
+}
+
+static void append_event(std::string& out, int pid, int tid, const trace_event& event)
+{
+    std::string_view detail{event.detail, ::strnlen(event.detail, TRACE_DETAIL_BYTES)};
+
+    out += ",\n{\"name\":";
+    // Tasks are told apart by their name on the async track.
+    append_json_string(out, (event.phase == 'b' || event.phase == 'e') && !detail.empty()
+                                ? detail
+                                : std::string_view{event.name});
+    out += ",\"ph\":\"";
+    out += event.phase;
+    out += "\",\"ts\":";
+    append_us(out, event.timestamp);
+    out += ",\"pid\":" + std::to_string(pid) + ",\"tid\":" + std::to_string(tid);
+
+    switch (event.phase)
+    {
+        case 'X':
+            out += ",\"dur\":";
+            append_us(out, event.value);
+            break;
+        case 'C':
+            out += ",\"args\":{\"value\":" + std::to_string(event.value) + "}}";
+            return;
+        case 'b':
+        case 'e':
+            out += ",\"cat\":\"task\",\"id\":" + std::to_string(event.value) + "}";
+            return;
+        default:
+            break;
+    }
+    if (!detail.empty())
+    {
+        out += ",\"args\":{\"detail\":";
+        append_json_string(out, detail);
+        out += '}';
+    }
+    out += '}';
+}
+
+
+/** ===============================================================================================
+ *  MEMBER FUNCTIONS DEFINITIONS
+ */
+
+void trace::start(const std::string& path)
+{
+    s_path   = path;
+    s_origin = clock::now();
+    s_enabled.store(true, std::memory_order_release);
+}
+
+bool trace::stop()
+{
+    if (!s_enabled.exchange(false, std::memory_order_acq_rel))
+    {
+        return true;
+    }
+
+    int fd = ::open(s_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0)
+    {
+        return false;
+    }
+
+    int         pid = ::getpid();
+    std::string out = "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n"
+                      "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":" +
+                      std::to_string(pid) + ",\"args\":{\"name\":\"ncurses_test\"}}";
+
+    std::lock_guard lock{s_buffersMutex};
+    bool            ok = true;
+    for (const std::unique_ptr<trace_buffer>& buffer : s_buffers)
+    {
+        if (const char* name = buffer->name.load(std::memory_order_relaxed); name != nullptr)
+        {
+            out += ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":" + std::to_string(pid) +
+                   ",\"tid\":" + std::to_string(buffer->tid) + ",\"args\":{\"name\":";
+            append_json_string(out, name);
+            out += "}}";
+        }
+        if (std::uint64_t dropped = buffer->dropped.load(std::memory_order_relaxed); dropped > 0)
+        {
+            trace_event event{"dropped events", 0, dropped, 'C'};
+            append_event(out, pid, buffer->tid, event);
+        }
+
+        std::size_t size = buffer->size.load(std::memory_order_acquire);
+        for (std::size_t i = 0; i < size; i++)
+        {
+            append_event(out, pid, buffer->tid, buffer->events[i]);
+
+            // Written in slices, so that a long trace does not sit in memory twice.
+            if (out.size() > 1024 * 1024)
+            {
+                ok &= ::write(fd, out.data(), out.size()) == static_cast<ssize_t>(out.size());
+                out.clear();
+            }
+        }
+    }
+    out += "\n]}\n";
+    ok &= ::write(fd, out.data(), out.size()) == static_cast<ssize_t>(out.size());
+    ::close(fd);
+    return ok;
+}
+
+
+void trace::set_thread_name(const char* name)
+{
+    t_threadName = name;
+    if (t_buffer != nullptr)
+    {
+        t_buffer->name.store(name, std::memory_order_relaxed);
+    }
+}
+
+[[nodiscard]] std::uint64_t trace::now()
+{
+    return static_cast<std::uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - s_origin).count());
+}
+
+
+void trace::complete(const char* name, std::uint64_t begin, std::string_view detail)
+{
+    record('X', name, begin, now() - begin, detail);
+}
+
+void trace::counter(const char* name, std::uint64_t value)
+{
+    if (enabled())
+    {
+        record('C', name, now(), value, {});
+    }
+}
+
+void trace::begin_async(const char* name, std::uint64_t id, std::string_view detail)
+{
+    if (enabled())
+    {
+        record('b', name, now(), id, detail);
+    }
+}
+
+void trace::end_async(const char* name, std::uint64_t id, std::string_view detail)
+{
+    if (enabled())
+    {
+        record('e', name, now(), id, detail);
+    }
+}
+
+
+void trace::record(char phase, const char* name, std::uint64_t timestamp, std::uint64_t value,
+                   std::string_view detail)
+{
+    trace_buffer* buffer = thread_buffer();
+
+    // Only this thread writes `size`, so a relaxed load of it is current.
+    std::size_t size = buffer->size.load(std::memory_order_relaxed);
+    if (size == TRACE_EVENTS_PER_THREAD)
+    {
+        buffer->dropped.store(buffer->dropped.load(std::memory_order_relaxed) + 1,
+                              std::memory_order_relaxed);
+        return;
+    }
+
+    trace_event& event = buffer->events[size];
+    event.name         = name;
+    event.timestamp    = timestamp;
+    event.value        = value;
+    event.phase        = phase;
+
+    // A cut detail ends on a character boundary, so that the export stays valid UTF-8.
+    std::size_t length = std::min(detail.size(), TRACE_DETAIL_BYTES);
+    while (length < detail.size() && length > 0 &&
+           (static_cast<unsigned char>(detail[length]) & 0xC0) == 0x80)
+    {
+        length--;
+    }
+    if (length > 0)
+    {
+        std::memcpy(event.detail, detail.data(), length);
+    }
+    if (length < TRACE_DETAIL_BYTES)
+    {
+        event.detail[length] = '\0';
+    }
+    buffer->size.store(size + 1, std::memory_order_release);
+}
+
+
+/**
+ * ------------------------------------------------------------------------------------------------
+ */
@@ -0,0 +1,157 @@
+/**
+ * ===============================================================================================
+ * @file    trace.h
+ * @author  Pascal-Emmanuel Lachance
+ * @p       <a href="https://www.github.com/Raesangur">Raesangur</a>
+ * @p       <a href="https://www.raesangur.com/">https://www.raesangur.com/</a>
+ *
+ * @brief   Timeline of frames, loads and tasks, exported as Chrome trace-event JSON.
+ *
+ * ------------------------------------------------------------------------------------------------
+ * @copyright Copyright (c) 2023 Pascal-Emmanuel Lachance | Raesangur
+ *
+ * @par License: <a href="https://opensource.org/license/mit/"> MIT </a>
+ *               This project is released under the MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ * BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NON INFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ * ------------------------------------------------------------------------------------------------
+ * @details
+ * Aggregate statistics tell how long frames take on average, not why one of them stalled or how
+ * a background load overlapped with drawing. With `--trace <file>`, trace_span scopes and counters
+ * are recorded along the way and written to `<file>` on exit, as trace-event JSON that Perfetto
+ * (ui.perfetto.dev) and chrome://tracing open as one track per thread.
+ *
+ * Each thread records into its own fixed-size buffer, allocated on its first event. Appending is
+ * a plain store followed by a release store of the size, with no lock and no atomic
+ * read-modify-write, and the exporter reads up to the published size. A full buffer drops further
+ * events and counts them rather than growing. While tracing is off, a span is a single relaxed
+ * load and a branch.
+ *
+ * Spans ('X') nest per thread. Tasks outlive the scope that starts them and end on the capture
+ * thread, so they are async events ('b'/'e') keyed by task id instead. Counters ('C') are running
+ * totals, such as the bytes written to the terminal.
+ * ===============================================================================================
+ */
+#ifndef TRACE_H
+#define TRACE_H
+
+
+/** ===============================================================================================
+ *  INCLUDES
+ */
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+
+/** ===============================================================================================
+ *  CONSTANTS
+ */
+
+constexpr std::size_t TRACE_EVENTS_PER_THREAD = 64 * 1024;
+constexpr std::size_t TRACE_DETAIL_BYTES      = 39;
+
+
+/** ===============================================================================================
+ *  CLASS DEFINITION
+ */
+
+struct trace_event
+{
+    const char*   name      = nullptr;    //!< Static string.
+    std::uint64_t timestamp = 0;          //!< Nanoseconds since trace::start().
+    std::uint64_t value     = 0;          //!< Duration of a span, total of a counter, id of a task.
+    char          phase     = 0;
+    char          detail[TRACE_DETAIL_BYTES]{};    //!< Copied argument, such as a file name.
+};
+
+
+class trace
+{
+public:
+    using clock = std::chrono::steady_clock;
+
+    trace() = delete;
+
+    // Starts recording; the timeline is written to `path` by stop().
+    static void start(const std::string& path);
+    // Writes the timeline and stops recording; returns false if the file cannot be written.
+    static bool stop();
+
+    [[nodiscard]] static bool enabled()
+    {
+        return s_enabled.load(std::memory_order_relaxed);
+    }
+
+    // Names the calling thread's track. Cheap, and safe to call whether tracing is on or not.
+    static void set_thread_name(const char* name);
+
+    [[nodiscard]] static std::uint64_t now();
+
+    static void complete(const char* name, std::uint64_t begin, std::string_view detail);
+    static void counter(const char* name, std::uint64_t value);
+    static void begin_async(const char* name, std::uint64_t id, std::string_view detail);
+    static void end_async(const char* name, std::uint64_t id, std::string_view detail);
+
+protected:
+    static void record(char phase, const char* name, std::uint64_t timestamp,
+                       std::uint64_t value, std::string_view detail);
+
+    static std::atomic<bool> s_enabled;
+    static clock::time_point s_origin;
+    static std::string       s_path;
+};
+
+
+// Records the time from its construction to its destruction as one span of the current thread.
+class trace_span
+{
+public:
+    explicit trace_span(const char* name, std::string_view detail = {}) :
+        m_name{name}, m_detail{detail}
+    {
+        if (trace::enabled())
+        {
+            m_begin = trace::now();
+        }
+    }
+    ~trace_span()
+    {
+        if (m_begin != NOT_RECORDED && trace::enabled())
+        {
+            trace::complete(m_name, m_begin, m_detail);
+        }
+    }
+
+    trace_span(const trace_span&)     = delete;
+    void operator=(const trace_span&) = delete;
+
+protected:
+    static constexpr std::uint64_t NOT_RECORDED = UINT64_MAX;
+
+    const char*      m_name;
+    std::string_view m_detail;
+    std::uint64_t    m_begin = NOT_RECORDED;
+};
+
+
+#endif  // TRACE_H
+/**
+ * ------------------------------------------------------------------------------------------------
+ */
@@ -0,0 +1,129 @@
+/**
+ * ===============================================================================================
+ * @file    tree-view.cpp
+ * @author  Pascal-Emmanuel Lachance
+ * @p       <a href="https://www.github.com/Raesangur">Raesangur</a>
+ * @p       <a href="https://www.raesangur.com/">https://www.raesangur.com/</a>
+ *
+ * @brief   Renders a menu_tree's visible rows into a window.
+ *
+ * ------------------------------------------------------------------------------------------------
+ * @copyright Copyright (c) 2023 Pascal-Emmanuel Lachance | Raesangur
+ *
+ * @par License: <a href="https://opensource.org/license/mit/"> MIT </a>
+ *               This project is released under the MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ * BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NON INFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ * ===============================================================================================
+ */
+/** ===============================================================================================
+ *  INCLUDES
+ */
+#include "tree-view.h"
+
+#include "display-width.h"
+#include "theme.h"
+#include "trace.h"
+
+#include <algorithm>
+
+
+/** ===============================================================================================
+ *  MEMBER FUNCTIONS DEFINITIONS
+ */
+
+void tree_view::render(const menu_tree& tree)
+{
+    trace_span span{"tree_view::render"};
+
+    int         rows   = visible_rows();
+    std::size_t cursor = tree.cursor();
+    std::size_t start  = cursor + MARGIN_ROWS > static_cast<std::size_t>(rows)
+                             ? cursor + MARGIN_ROWS - static_cast<std::size_t>(rows)
+                             : 0;
+
+    // One row past the screen tells whether the last one shown is expanded.
+    m_rows.clear();
+    tree.rows(start, static_cast<std::size_t>(rows) + 1, m_rows);
+
+    // Lines are padded to the full width, so that drawing one clears what it replaces.
+    int               width = std::max(0, m_win.width() - FIRST_COL - 1);
+    std::vector<line> lines(static_cast<std::size_t>(rows),
+                            line{std::string(static_cast<std::size_t>(width), ' ')});
+    for (std::size_t i = 0; i < lines.size() && i < m_rows.size(); i++)
+    {
+        auto* menu       = dynamic_cast<const menu_top_entry*>(m_rows[i].entry);
+        bool  expanded   = i + 1 < m_rows.size() && m_rows[i + 1].depth > m_rows[i].depth;
+        bool  expandable = menu != nullptr && (!menu->is_materialized() || menu->size() > 0);
+
+        std::string text = clip_to_width(format(m_rows[i], expanded, expandable), width);
+        text.append(static_cast<std::size_t>(std::max(0, width - display_width(text))), ' ');
+        lines[i] = line{std::move(text), start + i == cursor};
+    }
+
+    if (!m_valid || &tree != m_tree || lines.size() != m_lines.size())
+    {
+        m_win.set_style(theme::get()->get(style_id::menu));
+        m_win.erase();
+        m_win.box();
+        m_win.print(0, clip_to_width(tree.root()->get_name() + " (tree)", m_win.width() - 2));
+        m_lines.assign(lines.size(), line{});
+    }
+
+    for (std::size_t i = 0; i < lines.size(); i++)
+    {
+        if (lines[i] == m_lines[i])
+        {
+            continue;
+        }
+        m_win.set_style(theme::get()->get(lines[i].highlighted ? style_id::highlight
+                                                               : style_id::menu));
+        m_win.print(FIRST_ROW + static_cast<int>(i), FIRST_COL, lines[i].text);
+    }
+    m_win.set_style(theme::get()->get(style_id::menu));
+
+    m_lines = std::move(lines);
+    m_tree  = &tree;
+    m_valid = true;
+}
+
+void tree_view::invalidate()
+{
+    m_valid = false;
+}
+
+
+[[nodiscard]] int tree_view::visible_rows() const
+{
+    auto [y, _] = m_win.get_max_yx();
+    return std::max(0, y - MARGIN_ROWS);
+}
+
+
+[[nodiscard]] std::string tree_view::format(const tree_row& row,
+                                            bool            expanded,
+                                            bool            expandable) const
+{
+    std::string text(static_cast<std::size_t>(row.depth * INDENT), ' ');
+    text += expanded ? "- " : expandable ? "+ " : "  ";
+    text += row.entry->display();
+    return text;
+}
+
+
+/**
+ * ------------------------------------------------------------------------------------------------
+ */
@@ -0,0 +1,96 @@
+/**
+ * ===============================================================================================
+ * @file    tree-view.h
+ * @author  Pascal-Emmanuel Lachance
+ * @p       <a href="https://www.github.com/Raesangur">Raesangur</a>
+ * @p       <a href="https://www.raesangur.com/">https://www.raesangur.com/</a>
+ *
+ * @brief   Renders a menu_tree's visible rows into a window.
+ *
+ * ------------------------------------------------------------------------------------------------
+ * @copyright Copyright (c) 2023 Pascal-Emmanuel Lachance | Raesangur
+ *
+ * @par License: <a href="https://opensource.org/license/mit/"> MIT </a>
+ *               This project is released under the MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ * BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NON INFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ * ------------------------------------------------------------------------------------------------
+ * @details
+ * Each row is indented by its depth and marked '+' when it can be expanded and '-' when it is. Only
+ * the rows on screen are read from the tree, and only those whose text or highlight differs from
+ * the previous frame are drawn again; anything else, such as another tree or a resize, redraws the
+ * window from scratch.
+ * ===============================================================================================
+ */
+#ifndef TREE_VIEW_H
+#define TREE_VIEW_H
+
+
+/** ===============================================================================================
+ *  INCLUDES
+ */
+#include "menu-tree.h"
+#include "window.h"
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+
+/** ===============================================================================================
+ *  CLASS DEFINITION
+ */
+
+class tree_view
+{
+public:
+    tree_view(window& win) : m_win{win} {}
+
+    void render(const menu_tree& tree);
+    void invalidate();
+
+    [[nodiscard]] int visible_rows() const;
+
+protected:
+    struct line
+    {
+        std::string text{};
+        bool        highlighted = false;
+
+        bool operator==(const line&) const = default;
+    };
+
+    [[nodiscard]] std::string format(const tree_row& row, bool expanded, bool expandable) const;
+
+protected:
+    static constexpr int FIRST_ROW   = 2;
+    static constexpr int FIRST_COL   = 3;
+    static constexpr int MARGIN_ROWS = 4;
+    static constexpr int INDENT      = 2;
+
+    window& m_win;
+
+    const menu_tree*      m_tree  = nullptr;
+    bool                  m_valid = false;
+    std::vector<line>     m_lines{};    //!< As drawn, one per list row.
+    std::vector<tree_row> m_rows{};     //!< Reused between frames.
+};
+
+
+#endif  // TREE_VIEW_H
+/**
+ * ------------------------------------------------------------------------------------------------
+ */
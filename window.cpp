@@ -34,17 +34,75 @@
  */
 #include "window.h"
 
+#include "cell-renderer.h"
+#include "display-width.h"
+#include "memory-accounting.h"
+#include "trace.h"
+
 #include <algorithm>
 
 
+/** ===============================================================================================
+ *  CONSTANTS
+ */
+
+// ncurses keeps its WINDOW layout private, so a window is charged as a fixed header plus one line
+// descriptor (text pointer and three NCURSES_SIZE_T) and one cchar_t per cell.
+constexpr std::size_t WINDOW_HEADER_BYTES = 256;
+constexpr std::size_t LINE_HEADER_BYTES   = sizeof(void*) + 4 * sizeof(short);
+
+
+/** ===============================================================================================
+ *  LOCAL FUNCTIONS
+ */
+
+static std::size_t window_bytes(int h, int w)
+{
+    std::size_t rows = static_cast<std::size_t>(std::max(h, 0));
+    std::size_t cols = static_cast<std::size_t>(std::max(w, 0));
+    return WINDOW_HEADER_BYTES + rows * (LINE_HEADER_BYTES + cols * sizeof(cchar_t));
+}
+
+
 /** ===============================================================================================
  *  MEMBER FUNCTIONS DEFINITIONS
  */
 window::window(int h, int w, int y, int x):
-    h{h}, w{w}
+    h{h}, w{w}, m_y{y}, m_x{x}
 {
     win = ::newwin(h, w, y, x);
     ::refresh();
+
+    // Windows are never deleted, so the charge is only ever adjusted by reshape().
+    memory_accounting::allocate(memory_category::windows, window_bytes(h, w));
+}
+
+void window::reshape(int newH, int newW, int y, int x)
+{
+    if (newH == h && newW == w && y == m_y && x == m_x)
+    {
+        return;
+    }
+
+    memory_accounting::release(memory_category::windows, window_bytes(h, w));
+    memory_accounting::allocate(memory_category::windows, window_bytes(newH, newW));
+
+    h         = newH;
+    w         = newW;
+    m_y       = y;
+    m_x       = x;
+    m_boxed   = false;
+    m_cursorY = 0;
+    m_cursorX = 0;
+
+    // Resizing first keeps the window inside the screen at its new position, which mvwin requires.
+    // The native renderer still relies on the WINDOW for get_max_yx.
+    ::wresize(win, h, w);
+    ::mvwin(win, m_y, m_x);
+    if (!s_native)
+    {
+        ::werase(win);
+    }
 }
 
 
@@ -60,6 +118,11 @@ int window::height() const
 
 [[nodiscard]] std::tuple<int, int> window::get_yx() const
 {
+    if (s_native)
+    {
+        return std::tuple{m_cursorY, m_cursorX};
+    }
+
     int y = 0;
     int x = 0;
 
@@ -81,36 +144,126 @@ int window::height() const
 
 void window::set_color(short col_id)
 {
-    ::wbkgd(win, COLOR_PAIR(col_id));
+    set_background(style{A_NORMAL, col_id});
+}
+
+void window::set_background(const style& background)
+{
+    if (background == m_background)
+    {
+        return;
+    }
+
+    m_background = background;
+    if (s_native)
+    {
+        cell_renderer::get()->fill(m_y, m_x, h, w, background);
+        return;
+    }
+
+    ::wbkgd(win, background.attrs | static_cast<chtype>(COLOR_PAIR(background.pair)));
     refresh();
 }
 
+void window::set_style(const style& newStyle)
+{
+    if (newStyle == m_style)
+    {
+        return;
+    }
+
+    m_style = newStyle;
+    if (!s_native)
+    {
+        ::wattr_set(win, newStyle.attrs, newStyle.pair, nullptr);
+    }
+}
+
 void window::set_attribute(int attrs, bool activated)
 {
+    style newStyle = m_style;
     if (activated)
     {
-        ::wattron(win, attrs);
+        newStyle.attrs |= static_cast<attr_t>(attrs);
     }
     else
     {
-        ::wattroff(win, attrs);
+        newStyle.attrs &= ~static_cast<attr_t>(attrs);
     }
+
+    set_style(newStyle);
 }
 
 void window::scrollok(bool activated)
 {
+    if (s_native)
+    {
+        return;
+    }
+
     ::idlok(win, activated);
     ::scrollok(win, activated);
 }
 
+void window::scroll_lines(int top, int bottom, int n)
+{
+    // A boxed window keeps its border in place; only the inside of the region moves.
+    int left  = m_boxed ? 1 : 0;
+    int lines = bottom - top + 1;
+
+    if (s_native)
+    {
+        return cell_renderer::get()
+          ->scroll_area(m_y + top, m_x + left, lines, w - 2 * left, n, native_style());
+    }
+
+    ::wsetscrreg(win, top, bottom);
+    ::wscrl(win, n);
+
+    if (m_boxed)
+    {
+        int exposedBegin = n > 0 ? std::max(bottom - n + 1, top) : top;
+        int exposedEnd   = n > 0 ? bottom + 1 : std::min(top - n, bottom + 1);
+        for (int y = exposedBegin; y < exposedEnd; y++)
+        {
+            mvwaddch(win, y, 0, ACS_VLINE);
+            mvwaddch(win, y, w - 1, ACS_VLINE);
+        }
+    }
+    refresh();
+}
+
+void window::move(int y, int x)
+{
+    m_cursorY = y;
+    m_cursorX = x;
+    if (!s_native)
+    {
+        ::wmove(win, y, x);
+    }
+}
+
 void window::box()
 {
+    m_boxed = true;
+    if (s_native)
+    {
+        return cell_renderer::get()->box(m_y, m_x, h, w, native_style());
+    }
+
     ::box(win, 0, 0);
     refresh();
 }
 
 void window::line(int n)
 {
+    if (s_native)
+    {
+        n = std::min(n, w - m_cursorX);
+        return cell_renderer::get()
+          ->horizontal_line(m_y + m_cursorY, m_x + m_cursorX, n, native_style());
+    }
+
     ::whline(win, ACS_HLINE, n);
     refresh();
 }
@@ -118,28 +271,58 @@ void window::line(int n)
 
 void window::print(const std::string& message)
 {
+    if (s_native)
+    {
+        m_cursorX += native_print(m_cursorY, m_cursorX, message);
+        return;
+    }
+
     return print("%s", message.c_str());
 }
 
 void window::print(int y, int x, const std::string& message)
 {
+    if (s_native)
+    {
+        m_cursorY = y;
+        m_cursorX = x + native_print(y, x, message);
+        return;
+    }
+
     return print(y, x, "%s", message.c_str());
 }
 
 void window::print(int y, const std::string& message)
 {
-    return print(y, "%s", message.c_str());
+    // Centering goes by terminal columns, not bytes, so multi-byte text lands in the middle too.
+    int x = std::max((width() - display_width(message)) / 2, 0);
+
+    return print(y, x, message);
 }
 
 void window::erase()
 {
+    if (s_native)
+    {
+        m_cursorY = 0;
+        m_cursorX = 0;
+        return cell_renderer::get()->fill(m_y, m_x, h, w, m_background);
+    }
+
     ::werase(win);
     refresh();
 }
 
 void window::refresh()
 {
-    ::wrefresh(win);
+    trace_span span{"window::refresh"};
+
+    // Only stages the window: flush() sends every staged window in a single doupdate, and the
+    // native renderer sends whole frames from flush() instead.
+    if (!s_native)
+    {
+        ::wnoutrefresh(win);
+    }
 }
 
 
@@ -168,6 +351,54 @@ window window::create_centered(int width, int height)
 }
 
 
+void window::enable_native_renderer()
+{
+    s_native = true;
+}
+
+void window::flush()
+{
+    trace_span span{"window::flush"};
+
+    if (s_native)
+    {
+        cell_renderer::get()->flush();
+    }
+    else
+    {
+        ::doupdate();
+    }
+}
+
+void window::resize_screen(int rows, int cols)
+{
+    // ncurses clears the terminal with the next refresh of stdscr, which getch would otherwise do
+    // after the windows were drawn again.
+    ::refresh();
+    if (s_native)
+    {
+        cell_renderer::get()->resize(rows, cols);
+    }
+}
+
+
+[[nodiscard]] style window::native_style() const
+{
+    // Like wbkgd, the background supplies the colors of text drawn without a pair of its own.
+    return style{m_style.attrs | m_background.attrs,
+                 m_style.pair != 0 ? m_style.pair : m_background.pair};
+}
+
+int window::native_print(int y, int x, const std::string& message)
+{
+    if (y < 0 || y >= h)
+    {
+        return 0;
+    }
+    return cell_renderer::get()->put(m_y + y, m_x + x, message, native_style(), m_x + w);
+}
+
+
 /**
  * ------------------------------------------------------------------------------------------------
  */
@@ -35,8 +35,12 @@
 /** ===============================================================================================
  *  INCLUDES
  */
+#include "theme.h"
+
 #include <ncurses.h>
 
+#include <algorithm>
+#include <cstdio>
 #include <string>
 #include <tuple>
 
@@ -50,15 +54,22 @@ class window
 public:
     window(int h, int w, int y, int x);
 
+    // Moves and resizes the window; its content is lost and must be drawn again.
+    void reshape(int newH, int newW, int y, int x);
+
     [[nodiscard]] int width() const;
     [[nodiscard]] int height() const;
     [[nodiscard]] std::tuple<int, int> get_yx() const;
     [[nodiscard]] std::tuple<int, int> get_max_yx() const;
 
     void set_color(short col_id);
+    void set_background(const style& background);
+    void set_style(const style& newStyle);
     void set_attribute(int attrs, bool activated);
     void scrollok(bool activated = true);
+    void scroll_lines(int top, int bottom, int n);
 
+    void move(int y, int x);
     void box();
     void line(int n);
 
@@ -81,12 +92,39 @@ public:
 
     static window create_centered(int width = 0, int height = 0);
 
+    // Draws every window through cell_renderer instead of ncurses; frames are sent by flush().
+    static void enable_native_renderer();
+    // Sends everything drawn since the previous call to the terminal in one update.
+    static void flush();
+    // Follows a terminal resize; ncurses resizes stdscr on its own when it reports KEY_RESIZE.
+    static void resize_screen(int rows, int cols);
+
+    template<typename... args>
+    [[nodiscard]] static std::string format_text(const std::string& format, args... va);
+
 public:
     WINDOW* win = nullptr;
 
+protected:
+    [[nodiscard]] style native_style() const;
+    int                 native_print(int y, int x, const std::string& message);
+
 protected:
     int h;
     int w;
+    int m_y;
+    int m_x;
+
+    // Last state handed to ncurses, so that unchanged attributes are never sent again.
+    style m_style{};
+    style m_background{};
+    bool  m_boxed = false;
+
+    // The native renderer has no WINDOW to keep the cursor in.
+    int m_cursorY = 0;
+    int m_cursorX = 0;
+
+    static inline bool s_native = false;
 };
 
 
@@ -97,6 +135,11 @@ protected:
 template<typename... args>
 void window::print(const std::string& format, args... va)
 {
+    if (s_native)
+    {
+        return print(format_text(format, va...));
+    }
+
     wprintw(win, format.c_str(), va...);
     refresh();
 }
@@ -104,20 +147,32 @@ void window::print(const std::string& format, args... va)
 template<typename... args>
 void window::print(int y, int x, const std::string& format, args... va)
 {
+    if (s_native)
+    {
+        return print(y, x, format_text(format, va...));
+    }
+
     mvwprintw(win, y, x, format.c_str(), va...);
     refresh();
 }
 
 template<typename... args>
 void window::print(int y, const std::string& format, args... va)
+{
+    return print(y, format_text(format, va...));
+}
+
+template<typename... args>
+[[nodiscard]] std::string window::format_text(const std::string& format, args... va)
 {
     // snprintf to NULL with length 0 is defined behavior and returns the number of characters that
     // would have been written.
     int len = std::snprintf(nullptr, 0, format.c_str(), va...);
 
-    int x = std::max((width() - len) / 2, 0);
+    std::string text(static_cast<std::size_t>(std::max(len, 0)), '\0');
+    std::snprintf(text.data(), text.size() + 1, format.c_str(), va...);
 
-    return print(y, x, format, va...);
+    return text;
 }
 
 